@@ -1,13 +1,15 @@
 #include <iostream>
 #include <fstream>
 #include <glad/glad.h>
+#include "glstate/gl_state.h"
+#include "nullgl/null_gl.h"
 #include <GLFW/glfw3.h>
 
 using namespace std;
 
 // Update the glViewport based on the new size
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    glState.viewport(0, 0, width, height);
 }
 
 void process_input(GLFWwindow* window) {
@@ -31,12 +33,24 @@ string get_shader_source(string filename) {
     return shader_source;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // "--headless N" runs N frames against the null GL backend, then quits
+    unsigned int headlessFrames = 0;
+    if (argc > 2 && string(argv[1]) == "--headless")
+        headlessFrames = (unsigned int)atoi(argv[2]);
+    bool headless = headlessFrames > 0;
+
     // Window setup
+#ifdef GLFW_PLATFORM_NULL
+    if (headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (headless)
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
     GLFWwindow* window = glfwCreateWindow(800, 600, "OpenGL", NULL, NULL);
     if (window == NULL) {
@@ -46,10 +60,11 @@ int main() {
     }
 
     // Set the current context to the windo's
-    glfwMakeContextCurrent(window);
+    if (!headless)
+        glfwMakeContextCurrent(window);
 
     // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (headless ? !gladLoadGLNull() : !gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }   
@@ -58,7 +73,7 @@ int main() {
      The third and fourth parameter set the width and height of the rendering window in pixels,
       which we set equal to GLFW's window size. 
      */
-    glViewport(0, 0, 800, 600);
+    glState.viewport(0, 0, 800, 600);
 
     // Used when window is resized
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);  
@@ -83,10 +98,10 @@ int main() {
     unsigned int VAO;
     glGenVertexArrays(1, &VAO);  
     
-    glBindVertexArray(VAO);
+    glState.bindVertexArray(VAO);
 
     // Assign buffer tyoe to GL_ARRAY_BUFFER
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, VBO);
 
     // Copy information from vertices to the vbo
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
@@ -96,7 +111,7 @@ int main() {
     glGenBuffers(1, &EBO);
     
     // Associate ELEMENT ARRAY BUFFER TO EBO and pass in indices information
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW); 
 
     // Compile vertex shader in run time
@@ -149,9 +164,9 @@ int main() {
     glLinkProgram(shader_program);
 
     // Now we use the program (after we set all the states including the shaders)
-    glUseProgram(shader_program);
+    glState.useProgram(shader_program);
 
-    glBindVertexArray(VAO);
+    glState.bindVertexArray(VAO);
 
     // Now that everything is linked, delete the shaders
     glDeleteShader(vertex_shader);
@@ -164,12 +179,18 @@ int main() {
     // Render loop
     int color = 0;
 
+    unsigned int frames = 0;
+
     while(!glfwWindowShouldClose(window)) {
         process_input(window);
 
-        glfwSwapBuffers(window);
+        if (!headless)
+            glfwSwapBuffers(window);
         glfwPollEvents();    
 
+        if (headless && ++frames >= headlessFrames)
+            glfwSetWindowShouldClose(window, true);
+
         color += 1; 
 
         glClearColor(((color / 2) % 255)/255.0f, ((color / 3) % 255)/255.0f, ((color / 4) % 255)/255.0f, 1.0f);
@@ -179,6 +200,9 @@ int main() {
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
     }
 
+    if (headless)
+        nullGLPrintStats();
+
     glfwTerminate();
  
     return 0;
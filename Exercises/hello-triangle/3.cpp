@@ -1,13 +1,15 @@
 #include <iostream>
 #include <fstream>
 #include <glad/glad.h>
+#include "glstate/gl_state.h"
+#include "nullgl/null_gl.h"
 #include <GLFW/glfw3.h>
 
 using namespace std;
 
 // Update the glViewport based on the new size
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    glState.viewport(0, 0, width, height);
 }
 
 void process_input(GLFWwindow* window) {
@@ -31,12 +33,24 @@ string get_shader_source(string filename) {
     return shader_source;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // "--headless N" runs N frames against the null GL backend, then quits
+    unsigned int headlessFrames = 0;
+    if (argc > 2 && string(argv[1]) == "--headless")
+        headlessFrames = (unsigned int)atoi(argv[2]);
+    bool headless = headlessFrames > 0;
+
     // Window setup
+#ifdef GLFW_PLATFORM_NULL
+    if (headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (headless)
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
     GLFWwindow* window = glfwCreateWindow(800, 600, "OpenGL", NULL, NULL);
     if (window == NULL) {
@@ -46,10 +60,11 @@ int main() {
     }
 
     // Set the current context to the windo's
-    glfwMakeContextCurrent(window);
+    if (!headless)
+        glfwMakeContextCurrent(window);
 
     // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (headless ? !gladLoadGLNull() : !gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }   
@@ -58,7 +73,7 @@ int main() {
      The third and fourth parameter set the width and height of the rendering window in pixels,
       which we set equal to GLFW's window size. 
      */
-    glViewport(0, 0, 800, 600);
+    glState.viewport(0, 0, 800, 600);
 
     // Used when window is resized
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);  
@@ -127,7 +142,7 @@ int main() {
     glAttachShader(shader_program, fragment_yellow);
     // Link the final program
     glLinkProgram(shader_program);
-    glUseProgram(shader_program);
+    glState.useProgram(shader_program);
         
     float vertices1[] = {
         -1.0f, -0.5f, 0.0f,
@@ -148,14 +163,14 @@ int main() {
     unsigned int VAOs[2];
     glGenVertexArrays(2, VAOs);  
 
-    glBindVertexArray(VAOs[0]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[0]);
+    glState.bindVertexArray(VAOs[0]);
+    glState.bindBuffer(GL_ARRAY_BUFFER, VBOs[0]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices1), vertices1, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);   
 
-    glBindVertexArray(VAOs[1]);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOs[1]);
+    glState.bindVertexArray(VAOs[1]);
+    glState.bindBuffer(GL_ARRAY_BUFFER, VBOs[1]);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices2), vertices2, GL_STATIC_DRAW);
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
     glEnableVertexAttribArray(0);   
@@ -163,12 +178,18 @@ int main() {
     // Render loop
     int color = 0;
 
+    unsigned int frames = 0;
+
     while(!glfwWindowShouldClose(window)) {
         process_input(window);
 
-        glfwSwapBuffers(window);
+        if (!headless)
+            glfwSwapBuffers(window);
         glfwPollEvents();    
 
+        if (headless && ++frames >= headlessFrames)
+            glfwSetWindowShouldClose(window, true);
+
         color += 1; 
 
         glClearColor(((color / 2) % 255)/255.0f, ((color / 3) % 255)/255.0f, ((color / 4) % 255)/255.0f, 1.0f);
@@ -178,7 +199,7 @@ int main() {
         glAttachShader(shader_program, fragment_shader);
         glLinkProgram(shader_program);
         
-        glBindVertexArray(VAOs[0]);
+        glState.bindVertexArray(VAOs[0]);
         
         glDrawArrays(GL_TRIANGLES, 0, sizeof(vertices1));
 
@@ -186,7 +207,7 @@ int main() {
         glAttachShader(shader_program, fragment_yellow);
         glLinkProgram(shader_program);
         
-        glBindVertexArray(VAOs[1]);
+        glState.bindVertexArray(VAOs[1]);
         
         glDrawArrays(GL_TRIANGLES, 0, sizeof(vertices2));
     }
@@ -195,6 +216,9 @@ int main() {
     glDeleteShader(fragment_shader);
     //glDeleteShader(fragment_yellow);
 
+    if (headless)
+        nullGLPrintStats();
+
     glfwTerminate();
  
     return 0;
@@ -3,13 +3,15 @@
 #include <math.h>
 #include "shaders/shader.h"
 #include <glad/glad.h>
+#include "glstate/gl_state.h"
+#include "nullgl/null_gl.h"
 #include <GLFW/glfw3.h>
 
 using namespace std;
 
 // Update the glViewport based on the new size
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    glState.viewport(0, 0, width, height);
 }
 
 void processInput(GLFWwindow* window) {
@@ -18,12 +20,24 @@ void processInput(GLFWwindow* window) {
 }
 
 
-int main() {
+int main(int argc, char** argv) {
+    // "--headless N" runs N frames against the null GL backend, then quits
+    unsigned int headlessFrames = 0;
+    if (argc > 2 && string(argv[1]) == "--headless")
+        headlessFrames = (unsigned int)atoi(argv[2]);
+    bool headless = headlessFrames > 0;
+
     // Window setup
+#ifdef GLFW_PLATFORM_NULL
+    if (headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (headless)
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
     GLFWwindow* window = glfwCreateWindow(800, 600, "OpenGL", NULL, NULL);
     if (window == NULL) {
@@ -33,10 +47,11 @@ int main() {
     }
 
     // Set the current context to the windo's
-    glfwMakeContextCurrent(window);
+    if (!headless)
+        glfwMakeContextCurrent(window);
 
     // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (headless ? !gladLoadGLNull() : !gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }   
@@ -45,7 +60,7 @@ int main() {
      The third and fourth parameter set the width and height of the rendering window in pixels,
       which we set equal to GLFW's window size. 
      */
-    glViewport(0, 0, 800, 600);
+    glState.viewport(0, 0, 800, 600);
 
     // Used when window is resized
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);  
@@ -68,10 +83,10 @@ int main() {
     unsigned int VAO;
     glGenVertexArrays(1, &VAO);  
     
-    glBindVertexArray(VAO);
+    glState.bindVertexArray(VAO);
 
     // Assign buffer tyoe to GL_ARRAY_BUFFER
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, VBO);
 
     // Copy information from vertices to the vbo
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
@@ -81,13 +96,13 @@ int main() {
     glGenBuffers(1, &EBO);
     
     // Associate ELEMENT ARRAY BUFFER TO EBO and pass in indices information
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW); 
 
     Shader shader = Shader("shaders/offset.vs", "shaders/basicShader.fs"); 
     shader.use();
 
-    glBindVertexArray(VAO);
+    glState.bindVertexArray(VAO);
 
     // We use this to determine how the vertex information is processed. From learnopengl.com:
     // Position (location = 0)
@@ -101,12 +116,18 @@ int main() {
     // Render loop
     float color = 0;
 
+    unsigned int frames = 0;
+
     while(!glfwWindowShouldClose(window)) {
         processInput(window);
 
-        glfwSwapBuffers(window);
+        if (!headless)
+            glfwSwapBuffers(window);
         glfwPollEvents();    
 
+        if (headless && ++frames >= headlessFrames)
+            glfwSetWindowShouldClose(window, true);
+
         color += 0.01f; 
 
         glClearColor(sin(color/2) , sin(color / 3), sin(color / 4), 1.0f);
@@ -126,11 +147,15 @@ int main() {
         shader.setUniform3f("offset", sin(time), sin(time/1.4f) , sin(time*2.0f));
 
         // Will now draw information present from ELEMENT ARRAY BUFFER
+        shader.flush();
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
     }
     
     shader.cleanup();
 
+    if (headless)
+        nullGLPrintStats();
+
     glfwTerminate();
  
     return 0;
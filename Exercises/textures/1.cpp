@@ -3,6 +3,8 @@
 #include <math.h>
 #include "shaders/shader.h"
 #include <glad/glad.h>
+#include "glstate/gl_state.h"
+#include "nullgl/null_gl.h"
 #include "stb_image/stb_image.h"
 #include <GLFW/glfw3.h>
 
@@ -10,7 +12,7 @@ using namespace std;
 
 // Update the glViewport based on the new size
 void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    glState.viewport(0, 0, width, height);
 }
 
 void processInput(GLFWwindow* window) {
@@ -18,12 +20,24 @@ void processInput(GLFWwindow* window) {
         glfwSetWindowShouldClose(window, true);
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // "--headless N" runs N frames against the null GL backend, then quits
+    unsigned int headlessFrames = 0;
+    if (argc > 2 && string(argv[1]) == "--headless")
+        headlessFrames = (unsigned int)atoi(argv[2]);
+    bool headless = headlessFrames > 0;
+
     // Window setup
+#ifdef GLFW_PLATFORM_NULL
+    if (headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (headless)
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
     GLFWwindow* window = glfwCreateWindow(800, 600, "OpenGL", NULL, NULL);
     if (window == NULL) {
@@ -33,10 +47,11 @@ int main() {
     }
 
     // Set the current context to the windo's
-    glfwMakeContextCurrent(window);
+    if (!headless)
+        glfwMakeContextCurrent(window);
 
     // Initialize GLAD
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    if (headless ? !gladLoadGLNull() : !gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cout << "Failed to initialize GLAD" << std::endl;
         return -1;
     }   
@@ -45,7 +60,7 @@ int main() {
      The third and fourth parameter set the width and height of the rendering window in pixels,
       which we set equal to GLFW's window size. 
      */
-    glViewport(0, 0, 800, 600);
+    glState.viewport(0, 0, 800, 600);
 
     // Used when window is resized
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);  
@@ -70,10 +85,10 @@ int main() {
     unsigned int VAO;
     glGenVertexArrays(1, &VAO);  
     
-    glBindVertexArray(VAO);
+    glState.bindVertexArray(VAO);
 
     // Assign buffer tyoe to GL_ARRAY_BUFFER
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glState.bindBuffer(GL_ARRAY_BUFFER, VBO);
 
     // Copy information from vertices to the vbo
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
@@ -83,7 +98,7 @@ int main() {
     glGenBuffers(1, &EBO);
     
     // Associate ELEMENT ARRAY BUFFER TO EBO and pass in indices information
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW); 
 
     Shader shader = Shader("shaders/basicShader.vs", "shaders/reverseFace.fs"); 
@@ -103,17 +118,17 @@ int main() {
     int width, height, nrChannels;
     unsigned char*data = stbi_load("res/container.jpg", &width, &height, &nrChannels, 0);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, texID[0]);
+    glState.activeTexture(GL_TEXTURE0);
+    glState.bindTexture(GL_TEXTURE_2D, texID[0]);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE,data);
     glGenerateMipmap(GL_TEXTURE_2D);    
 
     stbi_image_free(data);
     data = stbi_load("res/awesomeface.png", &width, &height, &nrChannels, 0);
     
-    glActiveTexture(GL_TEXTURE1);
+    glState.activeTexture(GL_TEXTURE1);
     
-    glBindTexture(GL_TEXTURE_2D, texID[1]);
+    glState.bindTexture(GL_TEXTURE_2D, texID[1]);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,data);
     glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -122,7 +137,7 @@ int main() {
     shader.setInt("texture1", 0);
     shader.setInt("texture2", 1);
 
-    glBindVertexArray(VAO);
+    glState.bindVertexArray(VAO);
 
     // We use this to determine how the vertex information is processed. From learnopengl.com:
     // Position (location = 0)
@@ -140,12 +155,18 @@ int main() {
     // Render loop
     float color = 0;
 
+    unsigned int frames = 0;
+
     while(!glfwWindowShouldClose(window)) {
         processInput(window);
 
-        glfwSwapBuffers(window);
+        if (!headless)
+            glfwSwapBuffers(window);
         glfwPollEvents();    
 
+        if (headless && ++frames >= headlessFrames)
+            glfwSetWindowShouldClose(window, true);
+
         color += 0.01f; 
 
         glClearColor(sin(color/2) , sin(color / 3), sin(color / 4), 1.0f);
@@ -163,11 +184,15 @@ int main() {
         */
 
         // Will now draw information present from ELEMENT ARRAY BUFFER
+        shader.flush();
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
     }
     
     shader.cleanup();
 
+    if (headless)
+        nullGLPrintStats();
+
     glfwTerminate();
  
     return 0;
@@ -1,21 +1,75 @@
 #include <glad/glad.h>
 
+#include "buffers/stream_buffer.h"
 #include "camera/camera.h"
+#include "culling/culling.h"
+#include "culling/occlusion.h"
+#include "drawlist/draw_list.h"
+#include "glstate/gl_state.h"
+#include "jobs/job_pool.h"
+#include "mesh/lod_selector.h"
+#include "mesh/mesh_cache.h"
+#include "mesh/mesh_optimizer.h"
+#include "mesh/vertex_format.h"
+#include "nullgl/null_gl.h"
+#include "profiler/profiler.h"
+#include "raster/software_renderer.h"
+#include "scene/transform_hierarchy.h"
+#include "scheduler/frame_scheduler.h"
 #include "shaders/shader.h"
 #include "stb_image/stb_image.h"
+#include "uniforms/camera_block.h"
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
 #include <math.h>
+#include <random>
+#include <string.h>
+#include <vector>
 
 using namespace std;
 
 int screenWidth = 800, screenHeight = 600;
 Shader shader;
+Shader instancedShader;
 Camera cam;
+UniformBuffer<CameraBlock> cameraBuffer;
+StreamBuffer instanceBuffer;
+FrameScheduler scheduler;
+DrawList drawList;
+DrawIds programIds(drawkey::programLimit);
+DrawIds vertexArrayIds(drawkey::vertexArrayLimit);
+
+constexpr uint32_t modelName = uniformHash("model");
+constexpr uint32_t mixValueName = uniformHash("mixValue");
+
+// Draw the whole cube field with one glDrawElementsInstanced instead of one
+// glDrawElements per cube. Toggled at runtime with the I key.
+bool instancedRendering = true;
+bool instancingKeyDown = false;
+
+// Hide cubes behind the largest cubes on screen, rasterized on the CPU.
+// Toggled at runtime with the O key.
+bool occlusionCulling = true;
+bool occlusionKeyDown = false;
+
+// P pauses the cube animation, which lets the on-demand mode go idle
+bool animating = true;
+bool pauseKeyDown = false;
+
+// Everything the simulation advances in fixed ticks. Frames are drawn from a
+// blend of the previous and the current tick.
+struct SimulationState {
+  glm::vec3 cameraPos;
+  float time;
+  float color;
+  float mixValue;
+};
 
 // Camera Mouse handling
 bool firstMouse;
@@ -47,36 +101,185 @@ void mouse_callback(GLFWwindow *window, double xpos, double ypos) {
   front.y = sin(glm::radians(cam.pitch));
   front.z = sin(glm::radians(cam.yaw)) * cos(glm::radians(cam.pitch));
   cam.front = glm::normalize(front);
+  scheduler.requestRedraw();
 }
 
 // Update the glViewport based on the new size
 void framebufferSizeCallback(GLFWwindow *window, int width, int height) {
-  glViewport(0, 0, width, height);
+  screenWidth = width;
+  screenHeight = height;
+  glState.viewport(0, 0, width, height);
+  scheduler.requestRedraw();
 }
 
 void processInput(GLFWwindow *window) {
   if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
     glfwSetWindowShouldClose(window, true);
+
+  bool instancingKey = glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS;
+  if (instancingKey && !instancingKeyDown) {
+    instancedRendering = !instancedRendering;
+    scheduler.requestRedraw();
+  }
+  instancingKeyDown = instancingKey;
+
+  bool occlusionKey = glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS;
+  if (occlusionKey && !occlusionKeyDown) {
+    occlusionCulling = !occlusionCulling;
+    scheduler.requestRedraw();
+  }
+  occlusionKeyDown = occlusionKey;
+
+  bool pauseKey = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
+  if (pauseKey && !pauseKeyDown)
+    animating = !animating;
+  pauseKeyDown = pauseKey;
+}
+
+// One fixed step of everything that moves
+void simulate(GLFWwindow *window, SimulationState &state, float deltaTime) {
+  cam.updateCamera(window, deltaTime);
+  state.cameraPos = cam.pos;
+
+  if (animating) {
+    state.time += deltaTime;
+    state.color += 0.6f * deltaTime;
+  }
+
+  if (glfwGetKey(window, GLFW_KEY_UP))
+    state.mixValue += 0.6f * deltaTime;
+  else if (glfwGetKey(window, GLFW_KEY_DOWN))
+    state.mixValue -= 0.6f * deltaTime;
+}
+
+// The first ten cubes keep their hand-placed positions, the rest are scattered
+// in a box that grows with the cube count so the density stays about the same.
+vector<glm::vec3> createCubeField(unsigned int cubeCount) {
+  vector<glm::vec3> positions = {
+      glm::vec3(0.0f, 0.0f, 0.0f),    glm::vec3(2.0f, 5.0f, -15.0f),
+      glm::vec3(-1.5f, -2.2f, -2.5f), glm::vec3(-3.8f, -2.0f, -12.3f),
+      glm::vec3(2.4f, -0.4f, -3.5f),  glm::vec3(-1.7f, 3.0f, -7.5f),
+      glm::vec3(1.3f, -2.0f, -2.5f),  glm::vec3(1.5f, 2.0f, -2.5f),
+      glm::vec3(1.5f, 0.2f, -1.5f),   glm::vec3(-1.3f, 1.0f, -1.5f)};
+
+  if (cubeCount <= positions.size()) {
+    positions.resize(cubeCount);
+    return positions;
+  }
+
+  float extent = 2.5f * cbrt((float)cubeCount);
+  mt19937 rng(1337);
+  uniform_real_distribution<float> xy(-extent, extent);
+  uniform_real_distribution<float> z(-2.0f * extent, -1.0f);
+
+  positions.reserve(cubeCount);
+  while (positions.size() < cubeCount)
+    positions.push_back(glm::vec3(xy(rng), xy(rng), z(rng)));
+
+  return positions;
 }
 
-void setMatrices(Camera cam) {
-  unsigned int modelLoc, viewLoc, projLoc;
+// Every cube spins about the same axis, so its rotation at any time is its
+// starting rotation followed by a spin that all cubes share
+const glm::vec3 cubeSpinAxis = glm::normalize(glm::vec3(1.0f, 0.3f, 0.5f));
 
-  modelLoc = glGetUniformLocation(shader.ID, "model");
-  viewLoc = glGetUniformLocation(shader.ID, "view");
-  projLoc = glGetUniformLocation(shader.ID, "projection");
+glm::quat cubeRotation(unsigned int i) {
+  return glm::angleAxis(glm::radians(20.0f * i), cubeSpinAxis);
+}
+
+glm::quat cubeSpin(float time) {
+  return glm::angleAxis(glm::radians(time * 50.0f), cubeSpinAxis);
+}
 
-  glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(cam.model));
-  glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(cam.view));
-  glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(cam.projection));
+// Cubes culled per job. The visible indices of a job go on its stack.
+const size_t cullGrain = 1024;
+
+// The cubes drawn into the occlusion buffer: the largest on screen last frame,
+// as long as their radius covers this many of its pixels, and as many as fit
+// the triangle budget (but at least one)
+const size_t maxOccluders = 32;
+const size_t maxOccluderTriangles = 16384;
+const float minOccluderPixels = 4.0f;
+
+// Points the per-instance matrix attributes at the given byte offset, so a run
+// of the draw list can start anywhere in the instance buffer
+void setInstanceAttributes(GLintptr offset) {
+  for (unsigned int column = 0; column < 4; column++)
+    glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                          (void *)(offset + column * sizeof(glm::vec4)));
 }
 
-int main() {
-  // Window setup
+int main(int argc, char **argv) {
+  unsigned int cubeCount = 10;
+  // Run this many frames against the null GL backend, then quit
+  unsigned int headlessFrames = 0;
+  // Where to write a chrome://tracing profile, if anywhere
+  const char *tracePath = NULL;
+  // Frame pacing: vsync by default, headless runs go as fast as they can
+  FrameScheduler::Mode frameMode = FrameScheduler::VSync;
+  double frameCap = 60.0;
+  unsigned int threadCount = JobPool::defaultThreadCount();
+  // How per-frame instance data reaches the GPU
+  StreamBuffer::Strategy streamStrategy = StreamBuffer::Persistent;
+  // How the cube's vertices are stored: compact, or plain floats
+  VertexFormat cubeFormat = VertexFormat::compact();
+  // An OBJ or PLY file to draw in place of the cube
+  const char *meshPath = NULL;
+  // Also draw every frame on the CPU, and write the last one here as a PPM
+  const char *softwarePath = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--cubes") == 0 && i + 1 < argc)
+      cubeCount = (unsigned int)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--no-instancing") == 0)
+      instancedRendering = false;
+    else if (strcmp(argv[i], "--no-occlusion") == 0)
+      occlusionCulling = false;
+    else if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc)
+      headlessFrames = (unsigned int)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+      tracePath = argv[++i];
+    else if (strcmp(argv[i], "--vsync") == 0)
+      frameMode = FrameScheduler::VSync;
+    else if (strcmp(argv[i], "--uncapped") == 0)
+      frameMode = FrameScheduler::Uncapped;
+    else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
+      frameMode = FrameScheduler::Capped;
+      frameCap = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--on-demand") == 0)
+      frameMode = FrameScheduler::OnDemand;
+    else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+      threadCount = (unsigned int)atoi(argv[++i]);
+    else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc)
+      streamStrategy = strcmp(argv[++i], "orphan") == 0
+                           ? StreamBuffer::Orphaning
+                           : StreamBuffer::Persistent;
+    else if (strcmp(argv[i], "--vertex-format") == 0 && i + 1 < argc) {
+      const char *format = argv[++i];
+      cubeFormat = VertexFormat::compact();
+      if (strcmp(format, "float") == 0)
+        cubeFormat = VertexFormat::uncompressed();
+      else if (strcmp(format, "half") == 0)
+        cubeFormat.position = PositionHalf;
+    } else if (strcmp(argv[i], "--mesh") == 0 && i + 1 < argc)
+      meshPath = argv[++i];
+    else if (strcmp(argv[i], "--software") == 0 && i + 1 < argc)
+      softwarePath = argv[++i];
+  }
+  bool headless = headlessFrames > 0;
+  if (headless)
+    frameMode = FrameScheduler::Uncapped;
+
+  // Window setup. Headless runs need neither a display nor a GL context.
+#ifdef GLFW_PLATFORM_NULL
+  if (headless)
+    glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#endif
   glfwInit();
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+  if (headless)
+    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 
   GLFWwindow *window = glfwCreateWindow(800, 600, "OpenGL", NULL, NULL);
   if (window == NULL) {
@@ -88,19 +291,28 @@ int main() {
   glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
   // Set the current context to the windo's
-  glfwMakeContextCurrent(window);
+  if (!headless)
+    glfwMakeContextCurrent(window);
 
   // Initialize GLAD
-  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+  if (headless ? !gladLoadGLNull()
+               : !gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
     std::cout << "Failed to initialize GLAD" << std::endl;
     return -1;
   }
 
+  profiler.initGpu();
+  jobPool.start(threadCount);
+  if (tracePath) {
+    profiler.captureTrace(true);
+    profiler.setSummaryInterval(300);
+  }
+
   /* The first two parameters of glViewport set the location of the lower left
    corner of the window. The third and fourth parameter set the width and height
    of the rendering window in pixels, which we set equal to GLFW's window size.
    */
-  glViewport(0, 0, screenWidth, screenHeight);
+  glState.viewport(0, 0, screenWidth, screenHeight);
 
   // Used when window is resized
   glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
@@ -130,6 +342,78 @@ int main() {
       0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
       -0.5f, 0.5f,  0.5f,  0.0f, 0.0f, -0.5f, 0.5f,  -0.5f, 0.0f, 1.0f};
 
+  // What the vertex and index buffers are filled from: either the cube, or a
+  // mesh cache that is uploaded straight from its mapping
+  MeshCache meshCache;
+  QuantizedVertices cubeMesh;
+  vector<uint32_t> cubeIndices;
+  const void *vertexData;
+  size_t vertexBytes;
+  const uint32_t *indexData;
+  size_t indexBytes;
+  // Finest first, all ranges of the one index buffer
+  vector<MeshLod> cubeLods;
+  float cubeRadius;
+
+  double loadStart = glfwGetTime();
+  bool cacheRebuilt = false;
+  if (meshPath &&
+      loadCachedMesh(meshPath, cubeFormat, meshCache, &cacheRebuilt)) {
+    cubeMesh = meshCache.layout();
+    vertexData = meshCache.vertexData();
+    vertexBytes = meshCache.vertexBytes();
+    indexData = meshCache.indexData();
+    indexBytes = meshCache.indexBytes();
+    cubeLods.assign(meshCache.lods(),
+                    meshCache.lods() + meshCache.header->lodCount);
+    cubeRadius = meshCache.header->radius;
+    cout << "Mesh " << meshPath << ": " << meshCache.header->vertexCount
+         << " vertices, " << cubeLods[0].indexCount / 3 << " triangles, "
+         << (cacheRebuilt ? "cache rebuilt" : "cache up to date") << " in "
+         << (glfwGetTime() - loadStart) * 1000.0 << " ms" << endl;
+    for (size_t lod = 1; lod < cubeLods.size(); lod++)
+      cout << "  LOD " << lod << ": " << cubeLods[lod].indexCount / 3
+           << " triangles, error " << cubeLods[lod].error << endl;
+  } else {
+    // The cube is written out as 36 vertices; shared corners are merged into
+    // an indexed mesh, which is then reordered for the post-transform cache.
+    const size_t cubeStride = 5 * sizeof(float);
+    const size_t cubeCorners = sizeof(vertices) / cubeStride;
+    vector<uint32_t> remap;
+    size_t cubeVertexCount = generateVertexRemap(
+        remap, NULL, cubeCorners, vertices, cubeCorners, cubeStride);
+    vector<unsigned char> cubeVertices = remapVertices(
+        remap, cubeVertexCount, vertices, cubeCorners, cubeStride);
+    cubeIndices = remapIndices(remap, NULL, cubeCorners);
+    cubeVertexCount =
+        optimizeMesh(cubeVertices, cubeIndices, cubeVertexCount, cubeStride);
+
+    VertexCacheStats cubeStats =
+        analyzeVertexCache(cubeIndices, cubeVertexCount);
+    cout << "Cube mesh: " << cubeCorners << " -> " << cubeVertexCount
+         << " vertices, ACMR " << cubeStats.acmr << ", ATVR "
+         << cubeStats.atvr << endl;
+
+    const float *cubeFloats = (const float *)cubeVertices.data();
+    cubeRadius = computeMeshBounds(cubeFloats, cubeVertexCount, 5).radius;
+    // Every corner of the cube is a texture seam, so this stays one level
+    cubeLods = buildLods(cubeIndices, cubeFloats, cubeVertexCount, 5);
+
+    FloatVertexLayout cubeLayout = {5, 0, 3, -1};
+    cubeMesh =
+        quantizeVertices(cubeFloats, cubeVertexCount, cubeLayout, cubeFormat);
+    cout << "Cube vertices: " << positionFormatName(cubeFormat.position)
+         << ", " << cubeMesh.stride << " bytes each (" << cubeStride
+         << " as floats), largest error " << cubeMesh.positionError
+         << " in position, " << cubeMesh.texCoordError
+         << " in texture coords" << endl;
+
+    vertexData = cubeMesh.data.data();
+    vertexBytes = cubeMesh.data.size();
+    indexData = cubeIndices.data();
+    indexBytes = cubeIndices.size() * sizeof(uint32_t);
+  }
+
   // Generate vertex buffer object
   unsigned int VBO;
   glGenBuffers(1, &VBO);
@@ -137,28 +421,67 @@ int main() {
   unsigned int VAO;
   glGenVertexArrays(1, &VAO);
 
-  glBindVertexArray(VAO);
+  glState.bindVertexArray(VAO);
 
   // Assign buffer tyoe to GL_ARRAY_BUFFER
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
+  glState.bindBuffer(GL_ARRAY_BUFFER, VBO);
 
   // Copy information from vertices to the vbo
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+  uploadStaticBuffer(GL_ARRAY_BUFFER, vertexData, vertexBytes);
 
   // Associate ELEMENT ARRAY BUFFER TO EBO and pass in indices information
-  // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-  // glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices,
-  // GL_STATIC_DRAW);
+  unsigned int EBO;
+  glGenBuffers(1, &EBO);
+  glState.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+  uploadStaticBuffer(GL_ELEMENT_ARRAY_BUFFER, indexData, indexBytes);
+
+  // The occluder is the coarsest level that still has triangles, with only
+  // the vertices it uses, read back the way the shader reads them
+  vector<glm::vec3> occluderPositions;
+  vector<uint32_t> occluderIndices;
+  {
+    size_t coarsestLevel = cubeLods.size() - 1;
+    while (coarsestLevel > 0 && cubeLods[coarsestLevel].indexCount == 0)
+      coarsestLevel--;
+    const MeshLod &coarsest = cubeLods[coarsestLevel];
+    vector<uint32_t> occluderVertex(cubeMesh.vertexCount, UINT32_MAX);
+    for (uint32_t i = 0; i < coarsest.indexCount; i++) {
+      uint32_t index = indexData[coarsest.indexOffset + i];
+      if (occluderVertex[index] == UINT32_MAX) {
+        occluderVertex[index] = (uint32_t)occluderPositions.size();
+        occluderPositions.push_back(cubeMesh.position(vertexData, index));
+      }
+      occluderIndices.push_back(occluderVertex[index]);
+    }
+  }
 
-  shader = Shader("shaders/basicShader.vs", "shaders/mixValue.fs");
+  // The software renderer gets every level, dequantized
+  SoftwareMesh softwareMesh;
+  if (softwarePath) {
+    for (uint32_t i = 0; i < cubeMesh.vertexCount; i++) {
+      softwareMesh.positions.push_back(cubeMesh.position(vertexData, i));
+      softwareMesh.texCoords.push_back(cubeMesh.texCoord(vertexData, i));
+    }
+    softwareMesh.indices.assign(indexData,
+                                indexData + indexBytes / sizeof(uint32_t));
+  }
+
+  // GL has its own copy now
+  meshCache.close();
+
+  // Shared by every program, so it has to exist before they are built
+  cameraBuffer.create();
+
+  shader = Shader("shaders/basicShader.vs", "shaders/litMixValue.fs");
+  instancedShader =
+      Shader("shaders/instancedShader.vs", "shaders/litMixValue.fs");
   shader.use();
 
   // Textures
   unsigned int texID[2];
   glGenTextures(2, texID);
 
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, texID[0]);
+  glState.bindTexture(0, GL_TEXTURE_2D, texID[0]);
 
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -175,39 +498,110 @@ int main() {
                GL_UNSIGNED_BYTE, data);
   glGenerateMipmap(GL_TEXTURE_2D);
 
+  // Both are GL_RGB, so alpha always reads as 1
+  Texture softwareTextures[2];
+  if (softwarePath)
+    softwareTextures[0].setImage(data, width, height, nrChannels, false);
+
   stbi_image_free(data);
   data = stbi_load("res/awesomeface.png", &width, &height, &nrChannels, 0);
 
-  glActiveTexture(GL_TEXTURE1);
-  glBindTexture(GL_TEXTURE_2D, texID[1]);
+  glState.bindTexture(1, GL_TEXTURE_2D, texID[1]);
 
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGBA,
                GL_UNSIGNED_BYTE, data);
   glGenerateMipmap(GL_TEXTURE_2D);
 
+  if (softwarePath)
+    softwareTextures[1].setImage(data, width, height, nrChannels, false);
+
   // stbi_image_free(data);
 
   shader.setInt("texture1", 0);
   shader.setInt("texture2", 1);
 
-  glBindVertexArray(VAO);
-
-  // We use this to determine how the vertex information is processed. From
-  // learnopengl.com: Position (location = 0)
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
+  instancedShader.setInt("texture1", 0);
+  instancedShader.setInt("texture2", 1);
+
+  // Undo the position quantization and say how normals are packed. Every cube
+  // shares the mesh, so this is set once rather than per draw.
+  for (Shader *program : {&shader, &instancedShader}) {
+    program->setUniform3f("positionScale", cubeMesh.positionScale.x,
+                          cubeMesh.positionScale.y, cubeMesh.positionScale.z);
+    program->setUniform3f("positionOffset", cubeMesh.positionBias.x,
+                          cubeMesh.positionBias.y, cubeMesh.positionBias.z);
+    program->setInt("normalFormat", cubeMesh.normalOffset >= 0
+                                        ? (int)cubeMesh.format.normal
+                                        : -1);
+  }
 
-  // TexCoords (location = 2)
-  glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-                        (void *)(3 * sizeof(float)));
-  glEnableVertexAttribArray(1);
+  glState.bindVertexArray(VAO);
+
+  // Position (location = 0), TexCoords (location = 1) and, for imported meshes
+  // that have them, normals (location = 6), in whatever format the mesh was
+  // packed with
+  cubeMesh.setAttributes(0, 1, 6);
+
+  // Per-instance model matrices (locations 2 to 5, one per column). They are
+  // rewritten every frame, so they live in a stream buffer with room for every
+  // cube in each of its regions.
+  vector<glm::vec3> cubePositions = createCubeField(cubeCount);
+
+  // Every cube hangs off the root of the field. DrawPacket::object indexes
+  // cubeNodes.
+  TransformHierarchy transforms;
+  TransformHierarchy::Node fieldRoot = transforms.create();
+  vector<TransformHierarchy::Node> cubeNodes(cubePositions.size());
+  vector<glm::quat> cubeRotations(cubePositions.size());
+  for (size_t i = 0; i < cubePositions.size(); i++) {
+    cubeRotations[i] = cubeRotation(i);
+    cubeNodes[i] =
+        transforms.create(fieldRoot, cubePositions[i], cubeRotations[i]);
+  }
+  float animatedTime = 0.0f;
+
+  // The cubes only spin in place, so their bounds never change
+  SphereBounds cubeBounds;
+  cubeBounds.resize(cubePositions.size());
+  for (size_t i = 0; i < cubePositions.size(); i++)
+    cubeBounds.set(i, cubePositions[i], cubeRadius);
+
+  // Remembers the level each cube was drawn with last
+  LodSelector cubeLodSelector;
+  cubeLodSelector.resize(cubePositions.size());
+
+  // Occluders for the next frame are picked while building this one's draws,
+  // each worker keeping (size on screen, cube) pairs of its own
+  OcclusionBuffer occlusionBuffer;
+  vector<uint32_t> occluders;
+  vector<vector<pair<float, uint32_t>>> occluderCandidates;
+  size_t occlusionTested = 0, occlusionRejected = 0;
+
+  // With --software, the same draws again into memory
+  SoftwareRenderer softwareRenderer;
+  Framebuffer softwareTarget;
+  vector<glm::mat4> softwareModels;
+
+  instanceBuffer.create(GL_ARRAY_BUFFER,
+                        cubePositions.size() * sizeof(glm::mat4),
+                        streamStrategy);
+
+  GLintptr instanceOffset = 0;
+  setInstanceAttributes(instanceOffset);
+  for (unsigned int column = 0; column < 4; column++) {
+    glEnableVertexAttribArray(2 + column);
+    glVertexAttribDivisor(2 + column, 1);
+  }
 
-  glEnable(GL_DEPTH_TEST);
+  glState.enable(GL_DEPTH_TEST);
 
   // Render loop
-  float color = 0;
-  float currentMixValue = 0.2f;
-  shader.setFloat("mixValue", currentMixValue);
+  SimulationState state;
+  state.time = 0.0f;
+  state.color = 0.0f;
+  state.mixValue = 0.2f;
+  shader.setFloat("mixValue", state.mixValue);
+  instancedShader.setFloat("mixValue", state.mixValue);
 
   // Create canera
   cam = Camera();
@@ -215,82 +609,327 @@ int main() {
   // Used for getting mouse input
   glfwSetCursorPosCallback(window, mouse_callback);
 
-  // Set view
-  cam.setView(glm::lookAt(cam.pos, cam.target, glm::vec3(0.0f, 1.0f, 0.0f)));
+  // Set view and projection before the first tick
+  cam.updateCamera(window, 0.0f);
+  state.cameraPos = cam.pos;
+  SimulationState previousState = state;
 
-  // create for the model transformations
-  glm::mat4 transform = glm::mat4(
-      1.0f); // make sure to initialize matrix to identity matrix first
+  scheduler.setMode(frameMode);
+  scheduler.setFrameCap(frameCap);
+  // Software frames are compared by hash, so they can't depend on how long
+  // the previous frame took
+  scheduler.setFixedStep(softwarePath != NULL);
 
-  glm::vec3 cubePositions[] = {
-      glm::vec3(0.0f, 0.0f, 0.0f),    glm::vec3(2.0f, 5.0f, -15.0f),
-      glm::vec3(-1.5f, -2.2f, -2.5f), glm::vec3(-3.8f, -2.0f, -12.3f),
-      glm::vec3(2.4f, -0.4f, -3.5f),  glm::vec3(-1.7f, 3.0f, -7.5f),
-      glm::vec3(1.3f, -2.0f, -2.5f),  glm::vec3(1.5f, 2.0f, -2.5f),
-      glm::vec3(1.5f, 0.2f, -1.5f),   glm::vec3(-1.3f, 1.0f, -1.5f)};
+  unsigned int frames = 0;
+  double startTime = glfwGetTime();
 
-  // get matrix's uniform location and set matrix
-  // shader.use();
-  unsigned int transformLoc = glGetUniformLocation(shader.ID, "transform");
-  glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(transform));
+  while (!glfwWindowShouldClose(window)) {
+    profiler.beginFrame();
+
+    {
+      PROFILE_ZONE("Simulation");
+      processInput(window);
+
+      unsigned int ticks = scheduler.beginFrame();
+      for (unsigned int tick = 0; tick < ticks; tick++) {
+        previousState = state;
+        simulate(window, state, (float)scheduler.tickDelta());
+      }
+
+      // Keep asking even on frames too short for a tick, or on-demand mode
+      // would sleep until the next input event. The last tick's change
+      // stands until a tick finds nothing moving.
+      if (animating || state.cameraPos != previousState.cameraPos ||
+          state.mixValue != previousState.mixValue)
+        scheduler.requestRedraw();
+    }
 
-  float previousTime = glfwGetTime();
-  float deltaTime = 0;
+    if (!scheduler.shouldRender()) {
+      profiler.endFrame();
+      scheduler.endFrame();
+      continue;
+    }
 
-  while (!glfwWindowShouldClose(window)) {
-    deltaTime = glfwGetTime() - previousTime;
-    previousTime = glfwGetTime();
-
-    processInput(window);
-    cam.updateCamera(window, deltaTime);
-
-    glGetUniformfv(shader.ID, glGetUniformLocation(shader.ID, "mixValue"),
-                   &currentMixValue);
-    if (glfwGetKey(window, GLFW_KEY_UP)) {
-      currentMixValue += 0.01f;
-      glUniform1f(glGetUniformLocation(shader.ID, "mixValue"), currentMixValue);
-    } else if (glfwGetKey(window, GLFW_KEY_DOWN)) {
-      currentMixValue -= 0.01f;
-      glUniform1f(glGetUniformLocation(shader.ID, "mixValue"), currentMixValue);
+    // Draw where the simulation is between its last two ticks
+    float alpha = scheduler.alpha();
+    float time = glm::mix(previousState.time, state.time, alpha);
+    float color = glm::mix(previousState.color, state.color, alpha);
+
+    Camera renderCam = cam;
+    renderCam.pos = glm::mix(previousState.cameraPos, state.cameraPos, alpha);
+    renderCam.setView(
+        glm::lookAt(renderCam.pos, renderCam.pos + renderCam.front, cam.up));
+
+    Shader &activeShader = instancedRendering ? instancedShader : shader;
+    activeShader.setFloat(activeShader.uniform(mixValueName), state.mixValue);
+
+    // Only touches the cubes when the animation moved on, so a paused scene
+    // costs nothing here
+    {
+      PROFILE_ZONE("Transforms");
+      if (time != animatedTime) {
+        animatedTime = time;
+        glm::quat spin = cubeSpin(time);
+        jobPool.parallelFor(cubeNodes.size(), 4096,
+                            [&](size_t begin, size_t end, unsigned int) {
+                              for (size_t i = begin; i < end; i++)
+                                transforms.setRotation(cubeNodes[i],
+                                                       cubeRotations[i] * spin);
+                            });
+      }
+      transforms.update();
+    }
+
+    glm::mat4 viewProjection = renderCam.projection * renderCam.view;
+    if (occlusionCulling) {
+      PROFILE_ZONE("Occlusion");
+      occlusionBuffer.begin(viewProjection);
+      for (uint32_t i : occluders)
+        occlusionBuffer.addOccluder(
+            transforms.world(cubeNodes[i]), occluderPositions.data(),
+            occluderPositions.size(), occluderIndices.data(),
+            occluderIndices.size());
+      occlusionBuffer.rasterize();
     }
 
-    // Handle transforms
-    /*
-    cam.setView(glm::lookAt(cam.pos, cam.pos + cam.front, cam.up));
+    // Workers cull slices of the cube field and emit packets; everything after
+    // this only walks the sorted list
+    {
+      PROFILE_ZONE("Build draw list");
+      Frustum frustum = Frustum::fromMatrix(viewProjection);
+      drawList.reset(jobPool.workerCount());
+      cubeLodSelector.setView(renderCam.projection, screenHeight);
+
+      occluderCandidates.resize(jobPool.workerCount());
+      for (vector<pair<float, uint32_t>> &candidates : occluderCandidates)
+        candidates.clear();
+      float occluderScale =
+          renderCam.projection[1][1] * 0.5f * OcclusionBuffer::height;
+
+      // The cubes all share one opaque state, with both textures as set 0,
+      // apart from their level of detail
+      DrawState cubeState = {0, false, programIds.id(activeShader.ID), 0,
+                             vertexArrayIds.id(VAO), 0};
+
+      jobPool.parallelFor(
+          cubePositions.size(), cullGrain,
+          [&](size_t begin, size_t end, unsigned int worker) {
+            PROFILE_ZONE("Build draws");
+            uint32_t visible[cullGrain];
+            size_t visibleCount =
+                cullSpheres(frustum, cubeBounds, begin, end, visible);
+            if (occlusionCulling)
+              visibleCount = occlusionBuffer.cullSpheres(cubeBounds, visible,
+                                                         visibleCount);
+
+            vector<DrawPacket> &bucket = drawList.bucket(worker);
+            DrawState state = cubeState;
+            for (size_t v = 0; v < visibleCount; v++) {
+              uint32_t i = visible[v];
+              const glm::vec3 &position = cubePositions[i];
+              float depth = glm::dot(position - renderCam.pos, renderCam.front);
+              float distance =
+                  glm::length(position - renderCam.pos) - cubeRadius;
+              state.lod = cubeLodSelector.select(
+                  i, distance, cubeLods.data(), (uint32_t)cubeLods.size());
+              bucket.push_back(
+                  DrawPacket{makeDrawKey(state, depth), i, VAO});
+
+              // Only cubes wholly in front of the eye, as the occlusion
+              // buffer drops triangles that cross the near plane
+              float pixels = cubeRadius * occluderScale / depth;
+              if (occlusionCulling && depth > cubeRadius &&
+                  pixels >= minOccluderPixels)
+                occluderCandidates[worker].push_back(make_pair(pixels, i));
+            }
+          });
+
+      drawList.finish();
+    }
 
-    cam.setProjection(glm::perspective(glm::radians(45.0f),
-                                       (float)screenWidth / (float)screenHeight,
-                                       0.01f, 100.0f));
-                                       */
+    if (occlusionCulling) {
+      vector<pair<float, uint32_t>> &candidates = occluderCandidates[0];
+      for (size_t w = 1; w < occluderCandidates.size(); w++)
+        candidates.insert(candidates.end(), occluderCandidates[w].begin(),
+                          occluderCandidates[w].end());
+      size_t affordable =
+          occluderIndices.empty()
+              ? 0
+              : max((size_t)1,
+                    maxOccluderTriangles * 3 / occluderIndices.size());
+      size_t count = min(candidates.size(), min(maxOccluders, affordable));
+      partial_sort(candidates.begin(), candidates.begin() + count,
+                   candidates.end(), greater<pair<float, uint32_t>>());
+      occluders.clear();
+      for (size_t c = 0; c < count; c++)
+        occluders.push_back(candidates[c].second);
+
+      occlusionTested += occlusionBuffer.tested;
+      occlusionRejected += occlusionBuffer.rejected;
+    }
 
-    glfwSwapBuffers(window);
-    glfwPollEvents();
+    const vector<DrawPacket> &packets = drawList.packets();
 
-    color += 0.01f;
+    profiler.beginGpuZone("Scene");
 
     glClearColor(sin(color / 2), sin(color / 3), sin(color / 4), 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Will now draw information present from ELEMENT ARRAY BUFFER
-    for (unsigned int i = 0; i < 10; i++) {
-      glm::mat4 model;
-      float angle = 20.0f * i + (float)glfwGetTime() * 50.0f;
-      model = glm::mat4(1.0f);
-      model = glm::translate(model, cubePositions[i]);
+    // View and projection only change once per frame
+    cameraBuffer.update(CameraBlock::fromCamera(renderCam));
+
+    // Only reach GL if something else changed them since the last frame
+    glState.bindVertexArray(VAO);
+    glState.bindTexture(0, GL_TEXTURE_2D, texID[0]);
+    glState.bindTexture(1, GL_TEXTURE_2D, texID[1]);
+
+    if (instancedRendering && !packets.empty()) {
+      PROFILE_ZONE("Draw instanced");
+      instanceBuffer.beginFrame();
+      StreamBuffer::Allocation instances =
+          instanceBuffer.allocate(packets.size() * sizeof(glm::mat4));
+      glm::mat4 *instanceModels = (glm::mat4 *)instances.data;
+      {
+        // Straight into mapped memory when the buffer is persistent
+        PROFILE_ZONE("Instance transforms");
+        jobPool.parallelFor(packets.size(), 4096,
+                            [&](size_t begin, size_t end, unsigned int) {
+                              for (size_t i = begin; i < end; i++)
+                                instanceModels[i] =
+                                    transforms.world(
+                                        cubeNodes[packets[i].object]);
+                            });
+      }
+      {
+        PROFILE_ZONE("Instance upload");
+        instanceBuffer.commit();
+      }
+
+      glState.bindBuffer(GL_ARRAY_BUFFER, instanceBuffer.ID);
+      instancedShader.flush();
+      for (const DrawList::Run &run : drawList.runs()) {
+        DrawState state = decodeDrawKey(run.state);
+        glState.bindVertexArray(packets[run.begin].vertexArray);
+        GLintptr offset = instances.offset + run.begin * sizeof(glm::mat4);
+        if (offset != instanceOffset) {
+          instanceOffset = offset;
+          setInstanceAttributes(instanceOffset);
+        }
+        const MeshLod &lod = cubeLods[state.lod];
+        glDrawElementsInstanced(
+            GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT,
+            (void *)(lod.indexOffset * sizeof(uint32_t)), run.end - run.begin);
+      }
+      instanceBuffer.endFrame();
+    } else if (!instancedRendering) {
+      PROFILE_ZONE("Draw per cube");
+      Shader::Uniform modelUniform = shader.uniform(modelName);
+
+      // Will now draw information present from ELEMENT ARRAY BUFFER
+      for (const DrawPacket &packet : packets) {
+        shader.setMat4(modelUniform,
+                       transforms.world(cubeNodes[packet.object]));
+        shader.flush();
+        const MeshLod &lod = cubeLods[decodeDrawKey(packet.key).lod];
+        glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT,
+                       (void *)(lod.indexOffset * sizeof(uint32_t)));
+      }
+    }
+
+    profiler.endGpuZone();
+
+    if (softwarePath) {
+      PROFILE_ZONE("Software render");
+      if (softwareTarget.width != screenWidth ||
+          softwareTarget.height != screenHeight)
+        softwareTarget.resize(screenWidth, screenHeight);
+      softwareTarget.clear(
+          glm::vec4(sin(color / 2), sin(color / 3), sin(color / 4), 1.0f));
+      softwareRenderer.begin(
+          softwareTarget,
+          SoftwareRenderer::Uniforms{viewProjection, &softwareTextures[0],
+                                     &softwareTextures[1], state.mixValue});
+
+      softwareModels.resize(packets.size());
+      jobPool.parallelFor(packets.size(), 4096,
+                          [&](size_t begin, size_t end, unsigned int) {
+                            for (size_t i = begin; i < end; i++)
+                              softwareModels[i] = transforms.world(
+                                  cubeNodes[packets[i].object]);
+                          });
+      for (const DrawList::Run &run : drawList.runs()) {
+        const MeshLod &lod = cubeLods[decodeDrawKey(run.state).lod];
+        softwareRenderer.draw(softwareMesh, lod.indexOffset, lod.indexCount,
+                              &softwareModels[run.begin], run.end - run.begin);
+      }
+      softwareRenderer.finish();
+    }
 
-      model =
-          glm::rotate(model, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
+    {
+      PROFILE_ZONE("Swap");
+      if (!headless)
+        glfwSwapBuffers(window);
+    }
 
-      cam.setModel(model);
+    if (headless && ++frames >= headlessFrames)
+      glfwSetWindowShouldClose(window, true);
 
-      setMatrices(cam);
+    profiler.endFrame();
 
-      shader.setMat4("model", model);
-      glDrawArrays(GL_TRIANGLES, 0, 36);
-    }
+    // Waits for the next frame (or for input, when idle) outside the profile
+    scheduler.endFrame();
   }
 
   shader.cleanup();
+  instancedShader.cleanup();
+  cameraBuffer.cleanup();
+  instanceBuffer.cleanup();
+  profiler.cleanupGpu();
+  jobPool.stop();
+
+  if (tracePath) {
+    profiler.printSummary();
+    if (!profiler.writeChromeTrace(tracePath))
+      cout << "Failed to write profile to " << tracePath << endl;
+  }
+
+  glState.printCounters();
+
+  if (occlusionTested)
+    cout << "Occlusion culling (" << occlusionKernelName() << "): "
+         << occlusionRejected * 100.0 / occlusionTested << "% of "
+         << occlusionTested << " draws rejected, " << occluders.size()
+         << " occluders, " << occlusionBuffer.triangleCount()
+         << " occluder triangles in the last frame" << endl;
+
+  if (softwarePath && softwareRenderer.stats.frames) {
+    const SoftwareRenderStats &stats = softwareRenderer.stats;
+    cout << "Software renderer (" << softwareRasterKernelName()
+         << "): " << stats.frames << " frames, "
+         << stats.seconds * 1000.0 / stats.frames
+         << " ms each, " << stats.triangles / stats.seconds / 1e6
+         << " Mtris/s submitted (" << stats.trianglesSetUp / stats.frames
+         << " set up per frame), " << stats.fragments / stats.seconds / 1e6
+         << " Mpix/s shaded" << endl;
+    if (softwareTarget.writePPM(softwarePath))
+      cout << "  Last frame written to " << softwarePath << ", hash " << hex
+           << softwareTarget.colorHash() << dec << endl;
+    else
+      cout << "Failed to write the software frame to " << softwarePath
+           << endl;
+  }
+
+  cout << "Instance data: "
+       << StreamBuffer::strategyName(instanceBuffer.strategy()) << ", "
+       << instanceBuffer.stalls() << " stalls ("
+       << instanceBuffer.stalledMilliseconds() << " ms)" << endl;
+
+  if (headless) {
+    double elapsed = glfwGetTime() - startTime;
+    cout << frames << " frames, " << elapsed * 1000.0 / frames
+         << " ms per frame on the CPU" << endl;
+    nullGLPrintStats();
+  }
 
   glfwTerminate();
 
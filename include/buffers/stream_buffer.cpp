@@ -0,0 +1,148 @@
+#include "stream_buffer.h"
+#include "glstate/gl_state.h"
+
+#include <chrono>
+#include <iostream>
+
+StreamBuffer::StreamBuffer() {
+  ID = 0;
+  target = GL_ARRAY_BUFFER;
+  mode = Orphaning;
+  regionSize = 0;
+  region = 0;
+  used = committed = 0;
+  mapped = NULL;
+  for (GLsync &fence : fences)
+    fence = NULL;
+  stallCount = 0;
+  stallTime = 0.0;
+}
+
+void StreamBuffer::create(GLenum newTarget, GLsizeiptr bytesPerFrame,
+                          Strategy preferred) {
+  target = newTarget;
+  // Keep regions aligned for glBindBufferRange on uniform buffers too. An
+  // empty frame (no cubes) still gets one region's worth: glBufferStorage
+  // rejects a size of 0 and the buffer would be left without storage.
+  if (bytesPerFrame < 1)
+    bytesPerFrame = 1;
+  regionSize = (bytesPerFrame + 255) & ~(GLsizeiptr)255;
+  mode = preferred;
+  if (mode == Persistent && !(GLAD_GL_ARB_buffer_storage && glBufferStorage)) {
+    cout << "GL_ARB_buffer_storage is not supported, orphaning instead"
+         << endl;
+    mode = Orphaning;
+  }
+
+  glGenBuffers(1, &ID);
+  glState.bindBuffer(target, ID);
+
+  if (mode == Persistent) {
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(target, regionSize * regionCount, NULL, flags);
+    mapped = (unsigned char *)glMapBufferRange(target, 0,
+                                               regionSize * regionCount, flags);
+    if (!mapped) {
+      cout << "Failed to map the stream buffer persistently, orphaning instead"
+           << endl;
+      // Immutable storage can't be orphaned, so start over with a new buffer
+      glState.deleteBuffers(1, &ID);
+      glGenBuffers(1, &ID);
+      glState.bindBuffer(target, ID);
+      mode = Orphaning;
+    }
+  }
+
+  if (mode == Orphaning) {
+    glBufferData(target, regionSize, NULL, GL_STREAM_DRAW);
+    staging.resize(regionSize);
+  }
+}
+
+void StreamBuffer::cleanup() {
+  for (GLsync &fence : fences) {
+    if (fence)
+      glDeleteSync(fence);
+    fence = NULL;
+  }
+
+  if (mapped) {
+    glState.bindBuffer(target, ID);
+    glUnmapBuffer(target);
+    mapped = NULL;
+  }
+  glState.deleteBuffers(1, &ID);
+}
+
+StreamBuffer::Strategy StreamBuffer::strategy() const { return mode; }
+
+const char *StreamBuffer::strategyName(Strategy strategy) {
+  return strategy == Persistent ? "persistent mapping" : "orphaning";
+}
+
+void StreamBuffer::beginFrame() {
+  used = committed = 0;
+  if (mode != Persistent)
+    return;
+
+  region = (region + 1) % regionCount;
+  GLsync &fence = fences[region];
+  if (!fence)
+    return;
+
+  // Normally signaled long ago; if not, the GPU is regionCount frames behind
+  GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+  if (result == GL_TIMEOUT_EXPIRED) {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    stallCount++;
+    do {
+      result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    } while (result == GL_TIMEOUT_EXPIRED);
+    stallTime += chrono::duration<double, milli>(chrono::steady_clock::now() -
+                                                 start)
+                     .count();
+  }
+
+  glDeleteSync(fence);
+  fence = NULL;
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(GLsizeiptr size,
+                                                GLsizeiptr alignment) {
+  GLsizeiptr start = (used + alignment - 1) / alignment * alignment;
+  if (start + size > regionSize)
+    return Allocation{NULL, 0, 0};
+
+  used = start + size;
+  unsigned char *base = mode == Persistent ? mapped + regionStart()
+                                           : staging.data();
+  return Allocation{base + start, regionStart() + start, size};
+}
+
+void StreamBuffer::commit() {
+  if (mode != Orphaning || committed == used)
+    return;
+
+  glState.bindBuffer(target, ID);
+  // Only the first commit of a frame orphans, later ones would throw away
+  // data that draws of this frame still need
+  if (committed == 0)
+    glBufferData(target, regionSize, NULL, GL_STREAM_DRAW);
+  glBufferSubData(target, committed, used - committed,
+                  staging.data() + committed);
+  committed = used;
+}
+
+void StreamBuffer::endFrame() {
+  if (mode == Persistent && used > 0)
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+uint64_t StreamBuffer::stalls() const { return stallCount; }
+
+double StreamBuffer::stalledMilliseconds() const { return stallTime; }
+
+GLintptr StreamBuffer::regionStart() const {
+  return mode == Persistent ? region * regionSize : 0;
+}
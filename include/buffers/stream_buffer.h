@@ -0,0 +1,74 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h> // include glad to get all the required OpenGL headers
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Allocator for data that is rewritten every frame (instance data, debug
+ lines, UI quads). The buffer is split into regionCount regions and each
+ frame writes into the next one, so the CPU is filling one region while the
+ GPU still reads the previous ones.
+
+ Persistent  GL_ARB_buffer_storage: the whole buffer stays mapped (persistent
+             and coherent), allocations point straight into it, and a fence
+             per region keeps us from overwriting what the GPU still reads.
+ Orphaning   allocations point into a CPU copy, and commit() hands it to GL
+             with glBufferData(NULL) and glBufferSubData. Works everywhere.
+
+ Per frame: beginFrame(), allocate() and fill, commit() before the draws that
+ read it, then endFrame() after them.
+ */
+class StreamBuffer {
+public:
+  enum Strategy { Persistent, Orphaning };
+
+  static const unsigned int regionCount = 3;
+
+  struct Allocation {
+    void *data;      // NULL when the region is full
+    GLintptr offset; // Where the data is in the buffer, for attrib pointers
+    GLsizeiptr size;
+  };
+
+  StreamBuffer();
+
+  unsigned int ID;
+  GLenum target;
+
+  // Falls back to Orphaning when Persistent is asked for but not supported
+  void create(GLenum target, GLsizeiptr bytesPerFrame, Strategy preferred);
+  void cleanup();
+
+  Strategy strategy() const;
+  static const char *strategyName(Strategy strategy);
+
+  void beginFrame();
+  Allocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+  void commit();
+  void endFrame();
+
+  // Frames that had to wait for the GPU to release their region
+  uint64_t stalls() const;
+  double stalledMilliseconds() const;
+
+private:
+  Strategy mode;
+  GLsizeiptr regionSize;
+  unsigned int region;
+  GLsizeiptr used, committed;
+
+  unsigned char *mapped;
+  GLsync fences[regionCount];
+  vector<unsigned char> staging;
+
+  uint64_t stallCount;
+  double stallTime;
+
+  GLintptr regionStart() const;
+};
+
+#endif
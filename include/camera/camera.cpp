@@ -24,8 +24,6 @@ void Camera::setProjection(glm::mat4 newProjection) {
 }
 
 void Camera::updateCamera(GLFWwindow *window, float deltaTime) {
-  cout << "yee yaw " << yaw << " pitch perfect " << pitch << endl;
-
   if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
     pos += speed * deltaTime * front;
   if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
@@ -39,8 +37,6 @@ void Camera::updateCamera(GLFWwindow *window, float deltaTime) {
   if (glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
     pos += speed * deltaTime * up;
 
-  cout << pos.x << "," << pos.y << "," << pos.z << endl;
-
   // Handle transforms
   setView(glm::lookAt(pos, pos + front, up));
 
@@ -0,0 +1,323 @@
+#include "culling.h"
+#include "jobs/job_pool.h"
+
+#include <glm/simd/bits.h>
+#include <glm/simd/platform.h>
+#include <math.h>
+#include <string.h>
+
+// glm only sets the SIMD bits of GLM_ARCH when GLM_FORCE_INTRINSICS is on, so
+// fall back on the compiler's own target macros to pick the kernel
+#if (GLM_ARCH & GLM_ARCH_AVX_BIT) || defined(__AVX__)
+#define CULLING_AVX
+#include <immintrin.h>
+#elif (GLM_ARCH & GLM_ARCH_SSE2_BIT) || defined(__SSE2__) ||                   \
+    defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CULLING_SSE
+#include <emmintrin.h>
+#endif
+
+// Bounds
+
+void SphereBounds::resize(size_t count) {
+  x.resize(count);
+  y.resize(count);
+  z.resize(count);
+  radius.resize(count);
+}
+
+size_t SphereBounds::size() const { return x.size(); }
+
+void SphereBounds::set(size_t i, const glm::vec3 &center, float r) {
+  x[i] = center.x;
+  y[i] = center.y;
+  z[i] = center.z;
+  radius[i] = r;
+}
+
+void BoxBounds::resize(size_t count) {
+  x.resize(count);
+  y.resize(count);
+  z.resize(count);
+  extentX.resize(count);
+  extentY.resize(count);
+  extentZ.resize(count);
+}
+
+size_t BoxBounds::size() const { return x.size(); }
+
+void BoxBounds::set(size_t i, const glm::vec3 &center,
+                    const glm::vec3 &halfExtent) {
+  x[i] = center.x;
+  y[i] = center.y;
+  z[i] = center.z;
+  extentX[i] = halfExtent.x;
+  extentY[i] = halfExtent.y;
+  extentZ[i] = halfExtent.z;
+}
+
+// Kernels. An instance is outside when, for some plane, the signed distance
+// of its centre is below minus its radius (for boxes, the extent projected on
+// the plane normal). Lanes stay "inside" until one plane rejects them.
+
+namespace {
+
+// Appends the set bits of a lane mask as indices, lowest lane first
+inline size_t emitMask(unsigned int mask, size_t base, uint32_t *visible) {
+  size_t count = 0;
+  while (mask) {
+    visible[count++] = (uint32_t)(base + glm_lowest_bit(mask));
+    mask &= mask - 1;
+  }
+  return count;
+}
+
+inline float sphereDistance(const glm::vec4 &plane, const SphereBounds &b,
+                            size_t i) {
+  return plane.x * b.x[i] + plane.y * b.y[i] + plane.z * b.z[i] + plane.w +
+         b.radius[i];
+}
+
+inline float boxDistance(const glm::vec4 &plane, const BoxBounds &b,
+                         size_t i) {
+  return plane.x * b.x[i] + plane.y * b.y[i] + plane.z * b.z[i] + plane.w +
+         fabsf(plane.x) * b.extentX[i] + fabsf(plane.y) * b.extentY[i] +
+         fabsf(plane.z) * b.extentZ[i];
+}
+
+template <typename Bounds, typename Distance>
+size_t cullScalar(const Frustum &frustum, const Bounds &bounds, size_t begin,
+                  size_t end, uint32_t *visible, Distance distance) {
+  size_t count = 0;
+  for (size_t i = begin; i < end; i++) {
+    bool inside = true;
+    for (const glm::vec4 &plane : frustum.planes)
+      inside = inside && distance(plane, bounds, i) >= 0.0f;
+    if (inside)
+      visible[count++] = (uint32_t)i;
+  }
+  return count;
+}
+
+#if defined(CULLING_AVX)
+
+const size_t laneCount = 8;
+
+struct Planes {
+  __m256 x[6], y[6], z[6], w[6], absX[6], absY[6], absZ[6];
+
+  Planes(const Frustum &frustum) {
+    for (int p = 0; p < 6; p++) {
+      const glm::vec4 &plane = frustum.planes[p];
+      x[p] = _mm256_set1_ps(plane.x);
+      y[p] = _mm256_set1_ps(plane.y);
+      z[p] = _mm256_set1_ps(plane.z);
+      w[p] = _mm256_set1_ps(plane.w);
+      absX[p] = _mm256_set1_ps(fabsf(plane.x));
+      absY[p] = _mm256_set1_ps(fabsf(plane.y));
+      absZ[p] = _mm256_set1_ps(fabsf(plane.z));
+    }
+  }
+};
+
+inline __m256 centreDistance(const Planes &planes, int p, __m256 x, __m256 y,
+                             __m256 z) {
+  __m256 d = _mm256_add_ps(_mm256_mul_ps(planes.x[p], x), planes.w[p]);
+  d = _mm256_add_ps(d, _mm256_mul_ps(planes.y[p], y));
+  return _mm256_add_ps(d, _mm256_mul_ps(planes.z[p], z));
+}
+
+size_t cullSpheresWide(const Frustum &frustum, const SphereBounds &b,
+                       size_t begin, size_t end, uint32_t *visible) {
+  Planes planes(frustum);
+  __m256 zero = _mm256_setzero_ps();
+  size_t count = 0, i = begin;
+  for (; i + laneCount <= end; i += laneCount) {
+    __m256 x = _mm256_loadu_ps(&b.x[i]);
+    __m256 y = _mm256_loadu_ps(&b.y[i]);
+    __m256 z = _mm256_loadu_ps(&b.z[i]);
+    __m256 r = _mm256_loadu_ps(&b.radius[i]);
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int p = 0; p < 6; p++) {
+      __m256 d = _mm256_add_ps(centreDistance(planes, p, x, y, z), r);
+      inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+    }
+    count += emitMask(_mm256_movemask_ps(inside), i, visible + count);
+  }
+  return count + cullScalar(frustum, b, i, end, visible + count,
+                            sphereDistance);
+}
+
+size_t cullBoxesWide(const Frustum &frustum, const BoxBounds &b, size_t begin,
+                     size_t end, uint32_t *visible) {
+  Planes planes(frustum);
+  __m256 zero = _mm256_setzero_ps();
+  size_t count = 0, i = begin;
+  for (; i + laneCount <= end; i += laneCount) {
+    __m256 x = _mm256_loadu_ps(&b.x[i]);
+    __m256 y = _mm256_loadu_ps(&b.y[i]);
+    __m256 z = _mm256_loadu_ps(&b.z[i]);
+    __m256 ex = _mm256_loadu_ps(&b.extentX[i]);
+    __m256 ey = _mm256_loadu_ps(&b.extentY[i]);
+    __m256 ez = _mm256_loadu_ps(&b.extentZ[i]);
+
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (int p = 0; p < 6; p++) {
+      __m256 r = _mm256_mul_ps(planes.absX[p], ex);
+      r = _mm256_add_ps(r, _mm256_mul_ps(planes.absY[p], ey));
+      r = _mm256_add_ps(r, _mm256_mul_ps(planes.absZ[p], ez));
+      __m256 d = _mm256_add_ps(centreDistance(planes, p, x, y, z), r);
+      inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, zero, _CMP_GE_OQ));
+    }
+    count += emitMask(_mm256_movemask_ps(inside), i, visible + count);
+  }
+  return count + cullScalar(frustum, b, i, end, visible + count, boxDistance);
+}
+
+#elif defined(CULLING_SSE)
+
+const size_t laneCount = 4;
+
+struct Planes {
+  __m128 x[6], y[6], z[6], w[6], absX[6], absY[6], absZ[6];
+
+  Planes(const Frustum &frustum) {
+    for (int p = 0; p < 6; p++) {
+      const glm::vec4 &plane = frustum.planes[p];
+      x[p] = _mm_set1_ps(plane.x);
+      y[p] = _mm_set1_ps(plane.y);
+      z[p] = _mm_set1_ps(plane.z);
+      w[p] = _mm_set1_ps(plane.w);
+      absX[p] = _mm_set1_ps(fabsf(plane.x));
+      absY[p] = _mm_set1_ps(fabsf(plane.y));
+      absZ[p] = _mm_set1_ps(fabsf(plane.z));
+    }
+  }
+};
+
+inline __m128 centreDistance(const Planes &planes, int p, __m128 x, __m128 y,
+                             __m128 z) {
+  __m128 d = _mm_add_ps(_mm_mul_ps(planes.x[p], x), planes.w[p]);
+  d = _mm_add_ps(d, _mm_mul_ps(planes.y[p], y));
+  return _mm_add_ps(d, _mm_mul_ps(planes.z[p], z));
+}
+
+size_t cullSpheresWide(const Frustum &frustum, const SphereBounds &b,
+                       size_t begin, size_t end, uint32_t *visible) {
+  Planes planes(frustum);
+  __m128 zero = _mm_setzero_ps();
+  size_t count = 0, i = begin;
+  for (; i + laneCount <= end; i += laneCount) {
+    __m128 x = _mm_loadu_ps(&b.x[i]);
+    __m128 y = _mm_loadu_ps(&b.y[i]);
+    __m128 z = _mm_loadu_ps(&b.z[i]);
+    __m128 r = _mm_loadu_ps(&b.radius[i]);
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; p++) {
+      __m128 d = _mm_add_ps(centreDistance(planes, p, x, y, z), r);
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+    }
+    count += emitMask(_mm_movemask_ps(inside), i, visible + count);
+  }
+  return count + cullScalar(frustum, b, i, end, visible + count,
+                            sphereDistance);
+}
+
+size_t cullBoxesWide(const Frustum &frustum, const BoxBounds &b, size_t begin,
+                     size_t end, uint32_t *visible) {
+  Planes planes(frustum);
+  __m128 zero = _mm_setzero_ps();
+  size_t count = 0, i = begin;
+  for (; i + laneCount <= end; i += laneCount) {
+    __m128 x = _mm_loadu_ps(&b.x[i]);
+    __m128 y = _mm_loadu_ps(&b.y[i]);
+    __m128 z = _mm_loadu_ps(&b.z[i]);
+    __m128 ex = _mm_loadu_ps(&b.extentX[i]);
+    __m128 ey = _mm_loadu_ps(&b.extentY[i]);
+    __m128 ez = _mm_loadu_ps(&b.extentZ[i]);
+
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (int p = 0; p < 6; p++) {
+      __m128 r = _mm_mul_ps(planes.absX[p], ex);
+      r = _mm_add_ps(r, _mm_mul_ps(planes.absY[p], ey));
+      r = _mm_add_ps(r, _mm_mul_ps(planes.absZ[p], ez));
+      __m128 d = _mm_add_ps(centreDistance(planes, p, x, y, z), r);
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(d, zero));
+    }
+    count += emitMask(_mm_movemask_ps(inside), i, visible + count);
+  }
+  return count + cullScalar(frustum, b, i, end, visible + count, boxDistance);
+}
+
+#endif
+
+// Each chunk culls into its own slice of `visible`, then the slices are
+// packed together in chunk order so the result stays sorted
+const size_t parallelGrain = 16384;
+
+template <typename Bounds, typename Cull>
+void cullParallel(const Frustum &frustum, const Bounds &bounds,
+                  vector<uint32_t> &visible, Cull cull) {
+  size_t count = bounds.size();
+  size_t chunks = (count + parallelGrain - 1) / parallelGrain;
+  vector<size_t> chunkCounts(chunks);
+  visible.resize(count);
+
+  jobPool.parallelFor(count, parallelGrain,
+                      [&](size_t begin, size_t end, unsigned int) {
+                        chunkCounts[begin / parallelGrain] = cull(
+                            frustum, bounds, begin, end, &visible[begin]);
+                      });
+
+  size_t total = 0;
+  for (size_t chunk = 0; chunk < chunks; chunk++) {
+    size_t first = chunk * parallelGrain;
+    if (total != first)
+      memmove(&visible[total], &visible[first],
+              chunkCounts[chunk] * sizeof(uint32_t));
+    total += chunkCounts[chunk];
+  }
+  visible.resize(total);
+}
+
+} // namespace
+
+size_t cullSpheres(const Frustum &frustum, const SphereBounds &bounds,
+                   size_t begin, size_t end, uint32_t *visible) {
+#if defined(CULLING_AVX) || defined(CULLING_SSE)
+  return cullSpheresWide(frustum, bounds, begin, end, visible);
+#else
+  return cullScalar(frustum, bounds, begin, end, visible, sphereDistance);
+#endif
+}
+
+size_t cullBoxes(const Frustum &frustum, const BoxBounds &bounds, size_t begin,
+                 size_t end, uint32_t *visible) {
+#if defined(CULLING_AVX) || defined(CULLING_SSE)
+  return cullBoxesWide(frustum, bounds, begin, end, visible);
+#else
+  return cullScalar(frustum, bounds, begin, end, visible, boxDistance);
+#endif
+}
+
+void cullSpheresParallel(const Frustum &frustum, const SphereBounds &bounds,
+                         vector<uint32_t> &visible) {
+  cullParallel(frustum, bounds, visible, cullSpheres);
+}
+
+void cullBoxesParallel(const Frustum &frustum, const BoxBounds &bounds,
+                       vector<uint32_t> &visible) {
+  cullParallel(frustum, bounds, visible, cullBoxes);
+}
+
+const char *cullingKernelName() {
+#if defined(CULLING_AVX)
+  return "AVX";
+#elif defined(CULLING_SSE)
+  return "SSE";
+#else
+  return "scalar";
+#endif
+}
@@ -0,0 +1,50 @@
+#ifndef CULLING_H
+#define CULLING_H
+
+#include "culling/frustum.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Bounds of many instances, one array per component so that the kernels can
+ load 4 (SSE) or 8 (AVX) instances with a single instruction each.
+ */
+struct SphereBounds {
+  vector<float> x, y, z, radius;
+
+  void resize(size_t count);
+  size_t size() const;
+  void set(size_t i, const glm::vec3 &center, float r);
+};
+
+// Axis aligned boxes, as centres and half extents
+struct BoxBounds {
+  vector<float> x, y, z;
+  vector<float> extentX, extentY, extentZ;
+
+  void resize(size_t count);
+  size_t size() const;
+  void set(size_t i, const glm::vec3 &center, const glm::vec3 &halfExtent);
+};
+
+/* Write the indices in [begin, end) of the instances that intersect the
+ frustum to `visible`, in ascending order, and return how many there are.
+ `visible` needs room for end - begin indices.
+ */
+size_t cullSpheres(const Frustum &frustum, const SphereBounds &bounds,
+                   size_t begin, size_t end, uint32_t *visible);
+size_t cullBoxes(const Frustum &frustum, const BoxBounds &bounds, size_t begin,
+                 size_t end, uint32_t *visible);
+
+// Splits the scene over the job pool, for scenes large enough to be worth it
+void cullSpheresParallel(const Frustum &frustum, const SphereBounds &bounds,
+                         vector<uint32_t> &visible);
+void cullBoxesParallel(const Frustum &frustum, const BoxBounds &bounds,
+                       vector<uint32_t> &visible);
+
+// Which kernel this build uses: "AVX", "SSE" or "scalar"
+const char *cullingKernelName();
+
+#endif
@@ -0,0 +1,28 @@
+#include "frustum.h"
+
+Frustum Frustum::fromMatrix(const glm::mat4 &m) {
+  // glm is column major, so row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+  glm::vec4 row[4];
+  for (int i = 0; i < 4; i++)
+    row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+  Frustum frustum;
+  frustum.planes[0] = row[3] + row[0]; // left
+  frustum.planes[1] = row[3] - row[0]; // right
+  frustum.planes[2] = row[3] + row[1]; // bottom
+  frustum.planes[3] = row[3] - row[1]; // top
+  frustum.planes[4] = row[3] + row[2]; // near
+  frustum.planes[5] = row[3] - row[2]; // far
+
+  for (glm::vec4 &plane : frustum.planes)
+    plane /= glm::length(glm::vec3(plane));
+  return frustum;
+}
+
+bool Frustum::intersectsSphere(const glm::vec3 &center, float radius) const {
+  for (const glm::vec4 &plane : planes) {
+    if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+      return false;
+  }
+  return true;
+}
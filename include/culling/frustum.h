@@ -0,0 +1,20 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+
+/* The six planes of a view frustum, pointing inwards, in world space when
+ built from a view-projection matrix. A plane is (normal, distance) with
+ dot(normal, p) + distance >= 0 on the inside.
+ */
+struct Frustum {
+  glm::vec4 planes[6];
+
+  // Gribb and Hartmann: the planes are sums and differences of matrix rows
+  static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+  // Conservative: spheres near a corner may pass without being visible
+  bool intersectsSphere(const glm::vec3 &center, float radius) const;
+};
+
+#endif
@@ -0,0 +1,447 @@
+#include "occlusion.h"
+#include "jobs/job_pool.h"
+
+#include <algorithm>
+#include <float.h>
+#include <glm/simd/batch.h>
+#include <math.h>
+
+// The AVX2 rasterizer is built whatever the compiler targets and picked at
+// runtime, through the CPU detection of glm's batched kernels
+#ifdef GLM_BATCH_DISPATCH
+#define OCCLUSION_AVX2
+#endif
+
+OcclusionBuffer::OcclusionBuffer() : tested(0), rejected(0) {
+  viewProjection = glm::mat4(1.0f);
+  rowLengths = glm::vec4(1.0f);
+  viewDirection = glm::vec3(0.0f, 0.0f, -1.0f);
+  triangles = 0;
+
+  int levelWidth = width, levelHeight = height;
+  for (;;) {
+    Level level;
+    level.width = levelWidth;
+    level.height = levelHeight;
+    level.farthest.assign(levelWidth * levelHeight, 1.0f);
+    if (!levels.empty())
+      level.nearest.assign(levelWidth * levelHeight, 1.0f);
+    levels.push_back(level);
+    if (levelWidth == 1 && levelHeight == 1)
+      break;
+    levelWidth = max(1, levelWidth / 2);
+    levelHeight = max(1, levelHeight / 2);
+  }
+}
+
+void OcclusionBuffer::begin(const glm::mat4 &newViewProjection) {
+  viewProjection = newViewProjection;
+  for (int row = 0; row < 4; row++)
+    rowLengths[row] =
+        glm::length(glm::vec3(viewProjection[0][row], viewProjection[1][row],
+                              viewProjection[2][row]));
+  // Under an orthographic projection w is constant and depth grows along z
+  int depthRow = rowLengths.w > 0.0f ? 3 : 2;
+  viewDirection = glm::normalize(glm::vec3(viewProjection[0][depthRow],
+                                           viewProjection[1][depthRow],
+                                           viewProjection[2][depthRow]));
+  occluders.clear();
+  bins.resize(jobPool.workerCount());
+  for (Bins &worker : bins) {
+    worker.triangles.clear();
+    for (vector<uint32_t> &tile : worker.tiles)
+      tile.clear();
+  }
+  fill(levels[0].farthest.begin(), levels[0].farthest.end(), 1.0f);
+  triangles = 0;
+  tested = 0;
+  rejected = 0;
+}
+
+void OcclusionBuffer::addOccluder(const glm::mat4 &model,
+                                  const glm::vec3 *positions,
+                                  size_t vertexCount, const uint32_t *indices,
+                                  size_t indexCount) {
+  occluders.push_back(
+      Occluder{model, positions, vertexCount, indices, indexCount});
+}
+
+size_t OcclusionBuffer::occluderCount() const { return occluders.size(); }
+
+size_t OcclusionBuffer::triangleCount() const { return triangles; }
+
+const float *OcclusionBuffer::depth() const {
+  return levels[0].farthest.data();
+}
+
+float OcclusionBuffer::rejectedFraction() const {
+  size_t total = tested;
+  return total ? (float)rejected / (float)total : 0.0f;
+}
+
+// Setup and binning
+
+void OcclusionBuffer::setupOccluder(const Occluder &occluder,
+                                    Bins &out) const {
+  glm::mat4 transform = viewProjection * occluder.model;
+  out.vertices.resize(occluder.vertexCount);
+  for (size_t v = 0; v < occluder.vertexCount; v++) {
+    glm::vec4 clip = transform * glm::vec4(occluder.positions[v], 1.0f);
+    if (clip.w <= 0.0f || clip.z < -clip.w) {
+      out.vertices[v] = glm::vec4(0.0f, 0.0f, 0.0f, -1.0f);
+      continue;
+    }
+    float inverseW = 1.0f / clip.w;
+    out.vertices[v] = glm::vec4((clip.x * inverseW * 0.5f + 0.5f) * width,
+                                (clip.y * inverseW * 0.5f + 0.5f) * height,
+                                clip.z * inverseW * 0.5f + 0.5f, clip.w);
+  }
+
+  for (size_t i = 0; i + 2 < occluder.indexCount; i += 3) {
+    const glm::vec4 *corners[3];
+    bool clipped = false;
+    for (int c = 0; c < 3; c++) {
+      corners[c] = &out.vertices[occluder.indices[i + c]];
+      clipped |= corners[c]->w < 0.0f;
+    }
+    if (!clipped)
+      setupTriangle(corners, out);
+  }
+}
+
+void OcclusionBuffer::setupTriangle(const glm::vec4 *corners[3],
+                                    Bins &out) const {
+  glm::vec3 p0(*corners[0]), p1(*corners[1]), p2(*corners[2]);
+  float area = (p1.x - p0.x) * (p2.y - p0.y) - (p2.x - p0.x) * (p1.y - p0.y);
+  // Faces are not culled, so either winding occludes; make it
+  // counter-clockwise
+  if (area < 0.0f) {
+    swap(p1, p2);
+    area = -area;
+  }
+  if (!(area > 0.0f))
+    return;
+
+  float lowX = min(p0.x, min(p1.x, p2.x)), highX = max(p0.x, max(p1.x, p2.x));
+  float lowY = min(p0.y, min(p1.y, p2.y)), highY = max(p0.y, max(p1.y, p2.y));
+  if (highX < 0.0f || lowX > (float)width || highY < 0.0f ||
+      lowY > (float)height)
+    return;
+
+  // Pixels whose centres are inside the bounds
+  Triangle triangle;
+  triangle.minX = max(0, (int)ceilf(max(lowX, 0.0f) - 0.5f));
+  triangle.minY = max(0, (int)ceilf(max(lowY, 0.0f) - 0.5f));
+  triangle.maxX = min(width - 1, (int)floorf(min(highX, (float)width) - 0.5f));
+  triangle.maxY =
+      min(height - 1, (int)floorf(min(highY, (float)height) - 0.5f));
+  if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+    return;
+
+  float originX = triangle.minX + 0.5f, originY = triangle.minY + 0.5f;
+  const glm::vec3 *p[3] = {&p0, &p1, &p2};
+  for (int e = 0; e < 3; e++) {
+    const glm::vec3 &a = *p[e], &b = *p[(e + 1) % 3];
+    triangle.edgeX[e] = a.y - b.y;
+    triangle.edgeY[e] = b.x - a.x;
+    triangle.edgeC[e] = triangle.edgeX[e] * (originX - a.x) +
+                        triangle.edgeY[e] * (originY - a.y);
+  }
+
+  float inverseArea = 1.0f / area;
+  triangle.depthX = ((p1.z - p0.z) * (p2.y - p0.y) -
+                     (p2.z - p0.z) * (p1.y - p0.y)) *
+                    inverseArea;
+  triangle.depthY = ((p1.x - p0.x) * (p2.z - p0.z) -
+                     (p2.x - p0.x) * (p1.z - p0.z)) *
+                    inverseArea;
+  triangle.depthC = p0.z + triangle.depthX * (originX - p0.x) +
+                    triangle.depthY * (originY - p0.y);
+
+  uint32_t index = (uint32_t)out.triangles.size();
+  out.triangles.push_back(triangle);
+  for (int tileY = triangle.minY / tileHeight;
+       tileY <= triangle.maxY / tileHeight; tileY++)
+    for (int tileX = triangle.minX / tileWidth;
+         tileX <= triangle.maxX / tileWidth; tileX++)
+      out.tiles[tileY * tilesX + tileX].push_back(index);
+}
+
+// Rasterization. Every tile only writes its own pixels, and keeping the
+// nearest depth doesn't depend on the order triangles come in, so tiles need
+// no locks and the result is the same for any number of workers.
+
+void OcclusionBuffer::rasterizeScalar(const Triangle &t, float *depth, int x0,
+                                      int x1, int y0, int y1) {
+  for (int y = y0; y <= y1; y++) {
+    float dy = (float)(y - t.minY);
+    float *row = depth + y * width;
+    for (int x = x0; x <= x1; x++) {
+      float dx = (float)(x - t.minX);
+      bool inside = true;
+      for (int e = 0; e < 3; e++) {
+        float rowEdge = t.edgeC[e] + t.edgeY[e] * dy;
+        inside = inside && t.edgeX[e] * dx + rowEdge >= 0.0f;
+      }
+      float rowDepth = t.depthC + t.depthY * dy;
+      if (inside)
+        row[x] = min(row[x], t.depthX * dx + rowDepth);
+    }
+  }
+}
+
+#if defined(OCCLUSION_AVX2)
+GLM_BATCH_TARGET("avx2")
+void OcclusionBuffer::rasterizeAVX2(const Triangle &t, float *depth, int x0,
+                                    int x1, int y0, int y1) {
+  // Whole 8-pixel steps from an aligned start; tiles are a multiple of 8
+  // wide, so the extra lanes are still in the tile and are tested like
+  // any other pixel
+  x0 &= ~7;
+  __m256 laneOffsets = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f,
+                                      6.0f, 7.0f);
+  __m256 edgeX[3];
+  for (int e = 0; e < 3; e++)
+    edgeX[e] = _mm256_set1_ps(t.edgeX[e]);
+  __m256 depthX = _mm256_set1_ps(t.depthX);
+  __m256 zero = _mm256_setzero_ps();
+
+  for (int y = y0; y <= y1; y++) {
+    float dy = (float)(y - t.minY);
+    __m256 rowEdge[3];
+    for (int e = 0; e < 3; e++)
+      rowEdge[e] = _mm256_set1_ps(t.edgeC[e] + t.edgeY[e] * dy);
+    __m256 rowDepth = _mm256_set1_ps(t.depthC + t.depthY * dy);
+
+    float *row = depth + y * width;
+    for (int x = x0; x <= x1; x += 8) {
+      __m256 dx = _mm256_add_ps(_mm256_set1_ps((float)(x - t.minX)),
+                                laneOffsets);
+      __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+      for (int e = 0; e < 3; e++) {
+        __m256 value = _mm256_add_ps(_mm256_mul_ps(edgeX[e], dx), rowEdge[e]);
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(value, zero, _CMP_GE_OQ));
+      }
+      if (_mm256_testz_ps(inside, inside))
+        continue;
+
+      __m256 z = _mm256_add_ps(_mm256_mul_ps(depthX, dx), rowDepth);
+      __m256 old = _mm256_loadu_ps(row + x);
+      __m256 nearer = _mm256_min_ps(old, z);
+      _mm256_storeu_ps(row + x, _mm256_blendv_ps(old, nearer, inside));
+    }
+  }
+}
+#endif
+
+void OcclusionBuffer::rasterizeTile(int tile) {
+  int tileX = tile % tilesX * tileWidth;
+  int tileY = tile / tilesX * tileHeight;
+  float *depth = levels[0].farthest.data();
+#if defined(OCCLUSION_AVX2)
+  bool useAVX2 = glm_batch_get_isa() >= GLM_BATCH_AVX2;
+#endif
+
+  for (const Bins &worker : bins) {
+    for (uint32_t index : worker.tiles[tile]) {
+      const Triangle &t = worker.triangles[index];
+      int x0 = max(t.minX, tileX), x1 = min(t.maxX, tileX + tileWidth - 1);
+      int y0 = max(t.minY, tileY), y1 = min(t.maxY, tileY + tileHeight - 1);
+
+#if defined(OCCLUSION_AVX2)
+      if (useAVX2) {
+        rasterizeAVX2(t, depth, x0, x1, y0, y1);
+        continue;
+      }
+#endif
+      rasterizeScalar(t, depth, x0, x1, y0, y1);
+    }
+  }
+}
+
+void OcclusionBuffer::buildPyramid() {
+  for (size_t l = 1; l < levels.size(); l++) {
+    const Level &below = levels[l - 1];
+    Level &level = levels[l];
+    // Level 0 has one depth, so it is both the nearest and the farthest
+    const vector<float> &belowNearest = l == 1 ? below.farthest : below.nearest;
+
+    for (int y = 0; y < level.height; y++) {
+      int y0 = 2 * y, y1 = min(2 * y + 1, below.height - 1);
+      for (int x = 0; x < level.width; x++) {
+        int x0 = 2 * x, x1 = min(2 * x + 1, below.width - 1);
+        float nearest = 1.0f, farthest = 0.0f;
+        for (int by = y0; by <= y1; by++) {
+          for (int bx = x0; bx <= x1; bx++) {
+            nearest = min(nearest, belowNearest[by * below.width + bx]);
+            farthest = max(farthest, below.farthest[by * below.width + bx]);
+          }
+        }
+        level.nearest[y * level.width + x] = nearest;
+        level.farthest[y * level.width + x] = farthest;
+      }
+    }
+  }
+}
+
+void OcclusionBuffer::rasterize() {
+  jobPool.parallelFor(occluders.size(), 1,
+                      [&](size_t begin, size_t end, unsigned int worker) {
+                        for (size_t o = begin; o < end; o++)
+                          setupOccluder(occluders[o], bins[worker]);
+                      });
+
+  triangles = 0;
+  for (const Bins &worker : bins)
+    triangles += worker.triangles.size();
+  if (triangles == 0) {
+    // Level 0 was cleared by begin(); the levels above still hold the last
+    // frame, and direct boxVisible()/sphereVisible() calls read them
+    for (size_t l = 1; l < levels.size(); l++) {
+      fill(levels[l].nearest.begin(), levels[l].nearest.end(), 1.0f);
+      fill(levels[l].farthest.begin(), levels[l].farthest.end(), 1.0f);
+    }
+    return;
+  }
+
+  jobPool.parallelFor(tilesX * tilesY, 1,
+                      [&](size_t begin, size_t end, unsigned int) {
+                        for (size_t tile = begin; tile < end; tile++)
+                          rasterizeTile((int)tile);
+                      });
+  buildPyramid();
+}
+
+// Testing
+
+/* Walks down from a texel while the answer is unclear: behind the farthest
+ depth of a block is hidden everywhere in it, in front of the nearest is
+ visible somewhere in it. rect is the inclusive pixel rectangle
+ {x0, y0, x1, y1} being tested, so only blocks that overlap it are visited.
+ */
+bool OcclusionBuffer::texelVisible(int level, int x, int y, const int rect[4],
+                                   float depth) const {
+  const Level &texels = levels[level];
+  int i = y * texels.width + x;
+  if (depth > texels.farthest[i])
+    return false;
+  if (level == 0 || depth <= texels.nearest[i])
+    return true;
+
+  int below = level - 1;
+  int x0 = max(2 * x, rect[0] >> below), x1 = min(2 * x + 1, rect[2] >> below);
+  int y0 = max(2 * y, rect[1] >> below), y1 = min(2 * y + 1, rect[3] >> below);
+  for (int by = y0; by <= y1; by++)
+    for (int bx = x0; bx <= x1; bx++)
+      if (texelVisible(below, bx, by, rect, depth))
+        return true;
+  return false;
+}
+
+// The test itself, on the normalized device rectangle and nearest depth of
+// whatever is being tested
+bool OcclusionBuffer::regionVisible(float lowX, float lowY, float highX,
+                                    float highY, float nearest) const {
+  // Every pixel the region overlaps at all
+  int rect[4];
+  rect[0] = max(0, (int)floorf(max((lowX * 0.5f + 0.5f) * width, -1.0f)));
+  rect[1] = max(0, (int)floorf(max((lowY * 0.5f + 0.5f) * height, -1.0f)));
+  rect[2] = min(width - 1,
+                (int)floorf(min((highX * 0.5f + 0.5f) * width, width + 1.0f)));
+  rect[3] = min(height - 1, (int)floorf(min((highY * 0.5f + 0.5f) * height,
+                                            height + 1.0f)));
+  // Off screen is the frustum's business
+  if (rect[0] > rect[2] || rect[1] > rect[3])
+    return true;
+
+  // The coarsest level where the rectangle is at most 2x2 texels
+  int level = 0;
+  while ((rect[2] >> level) - (rect[0] >> level) > 1 ||
+         (rect[3] >> level) - (rect[1] >> level) > 1)
+    level++;
+
+  float depth = nearest * 0.5f + 0.5f;
+  for (int y = rect[1] >> level; y <= rect[3] >> level; y++)
+    for (int x = rect[0] >> level; x <= rect[2] >> level; x++)
+      if (texelVisible(level, x, y, rect, depth))
+        return true;
+  return false;
+}
+
+bool OcclusionBuffer::boxVisible(const glm::vec3 &center,
+                                 const glm::vec3 &halfExtent) const {
+  float lowX = FLT_MAX, lowY = FLT_MAX, highX = -FLT_MAX, highY = -FLT_MAX;
+  float nearest = FLT_MAX;
+  for (int corner = 0; corner < 8; corner++) {
+    glm::vec3 offset((corner & 1) ? halfExtent.x : -halfExtent.x,
+                     (corner & 2) ? halfExtent.y : -halfExtent.y,
+                     (corner & 4) ? halfExtent.z : -halfExtent.z);
+    glm::vec4 clip = viewProjection * glm::vec4(center + offset, 1.0f);
+    // Reaches past the near plane: nothing in the buffer can be in front
+    if (clip.w <= 0.0f || clip.z < -clip.w)
+      return true;
+    float inverseW = 1.0f / clip.w;
+    float x = clip.x * inverseW, y = clip.y * inverseW;
+    lowX = min(lowX, x);
+    highX = max(highX, x);
+    lowY = min(lowY, y);
+    highY = max(highY, y);
+    nearest = min(nearest, clip.z * inverseW);
+  }
+  return regionVisible(lowX, lowY, highX, highY, nearest);
+}
+
+// x, y and w are linear in the position, so over the sphere each lies within
+// its value at the centre plus or minus radius times the length of its row of
+// viewProjection. Dividing those ranges bounds the sphere on screen a little
+// more loosely than the eight corners of its box, for one transform. Depth
+// only grows with w, so the nearest is that of the point nearest the eye.
+bool OcclusionBuffer::sphereVisible(const glm::vec3 &center,
+                                    float radius) const {
+  glm::vec4 clip = viewProjection * glm::vec4(center, 1.0f);
+  glm::vec4 spread = rowLengths * radius;
+  float nearW = clip.w - spread.w, farW = clip.w + spread.w;
+  if (nearW <= 0.0f)
+    return true;
+  glm::vec4 front =
+      viewProjection * glm::vec4(center - viewDirection * radius, 1.0f);
+  if (front.z < -front.w)
+    return true;
+
+  // Smallest and largest of value / w for value and w in their ranges
+  float inverseNear = 1.0f / nearW, inverseFar = 1.0f / farW;
+  auto low = [&](float value) {
+    return value * (value < 0.0f ? inverseNear : inverseFar);
+  };
+  auto high = [&](float value) {
+    return value * (value > 0.0f ? inverseNear : inverseFar);
+  };
+  return regionVisible(low(clip.x - spread.x), low(clip.y - spread.y),
+                       high(clip.x + spread.x), high(clip.y + spread.y),
+                       front.z / front.w);
+}
+
+size_t OcclusionBuffer::cullSpheres(const SphereBounds &bounds,
+                                    uint32_t *visible, size_t count) {
+  size_t kept = count;
+  if (triangles > 0) {
+    kept = 0;
+    for (size_t i = 0; i < count; i++) {
+      uint32_t index = visible[i];
+      glm::vec3 center(bounds.x[index], bounds.y[index], bounds.z[index]);
+      if (sphereVisible(center, bounds.radius[index]))
+        visible[kept++] = index;
+    }
+  }
+  tested += count;
+  rejected += count - kept;
+  return kept;
+}
+
+const char *occlusionKernelName() {
+#if defined(OCCLUSION_AVX2)
+  if (glm_batch_get_isa() >= GLM_BATCH_AVX2)
+    return "AVX2";
+#endif
+  return "scalar";
+}
@@ -0,0 +1,139 @@
+#ifndef OCCLUSION_H
+#define OCCLUSION_H
+
+#include "culling/culling.h"
+
+#include <atomic>
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Software occlusion culling. A few large occluders are rasterized on the
+ CPU into a small depth buffer, which is reduced into a pyramid holding the
+ nearest and farthest depth of every block. Bounds are then tested against
+ the pyramid: an instance is hidden when the nearest point of its box is
+ behind everything drawn over the screen rectangle it covers.
+
+ Each frame goes begin() -> addOccluder() -> rasterize() -> test/cull. The
+ tests only read, so they can run on any number of workers once rasterize()
+ has returned.
+
+ Depth is window depth (0 near, 1 far) and rows go bottom up, like GL.
+ Occluder triangles that reach in front of the near plane are dropped rather
+ than clipped, which only ever makes the buffer hide less.
+ */
+class OcclusionBuffer {
+public:
+  static constexpr int width = 256;
+  static constexpr int height = 128;
+  // Rasterized one tile per job; a tile row is a whole number of 8-wide
+  // kernel steps
+  static constexpr int tileWidth = 32;
+  static constexpr int tileHeight = 16;
+  static constexpr int tilesX = width / tileWidth;
+  static constexpr int tilesY = height / tileHeight;
+
+  // Draws tested and rejected since begin()
+  atomic<size_t> tested;
+  atomic<size_t> rejected;
+
+  OcclusionBuffer();
+
+  // Clears the buffer and the occluder list for a frame seen through
+  // viewProjection
+  void begin(const glm::mat4 &viewProjection);
+
+  // Positions and indices are only read by rasterize(), and have to stay
+  // alive until then
+  void addOccluder(const glm::mat4 &model, const glm::vec3 *positions,
+                   size_t vertexCount, const uint32_t *indices,
+                   size_t indexCount);
+  size_t occluderCount() const;
+
+  // Sets up and bins the occluder triangles, rasterizes the tiles and builds
+  // the pyramid, all on jobPool
+  void rasterize();
+
+  // Whether any part of the box or sphere may be visible. Not counted in
+  // the stats.
+  bool boxVisible(const glm::vec3 &center, const glm::vec3 &halfExtent) const;
+  bool sphereVisible(const glm::vec3 &center, float radius) const;
+
+  /* Removes the instances hidden by the occluders from `visible` (as
+   written by cullSpheres) and returns how many are left, in the same order.
+   */
+  size_t cullSpheres(const SphereBounds &bounds, uint32_t *visible,
+                     size_t count);
+
+  float rejectedFraction() const;
+  // Occluder triangles rasterized by the last rasterize()
+  size_t triangleCount() const;
+  // width * height window depths, bottom row first
+  const float *depth() const;
+
+private:
+  struct Occluder {
+    glm::mat4 model;
+    const glm::vec3 *positions;
+    size_t vertexCount;
+    const uint32_t *indices;
+    size_t indexCount;
+  };
+
+  // Edge functions and the depth plane of a screen space triangle, covering
+  // pixel centres (x + 0.5, y + 0.5) where all three edges are >= 0. The
+  // constants are the values at the centre of pixel (minX, minY), which keeps
+  // them small.
+  struct Triangle {
+    float edgeX[3], edgeY[3], edgeC[3];
+    float depthX, depthY, depthC;
+    int minX, minY, maxX, maxY;
+  };
+
+  // What one worker set up: its triangles, and which of them touch each tile
+  struct alignas(64) Bins {
+    vector<Triangle> triangles;
+    vector<uint32_t> tiles[tilesX * tilesY];
+    // Window coordinates of the occluder being set up; w < 0 marks vertices
+    // in front of the near plane
+    vector<glm::vec4> vertices;
+  };
+
+  // Level l has the nearest and farthest depth of each 2^l x 2^l block.
+  // Level 0 is the depth buffer itself, kept in `farthest` only.
+  struct Level {
+    int width, height;
+    vector<float> nearest, farthest;
+  };
+
+  glm::mat4 viewProjection;
+  // Lengths of the xyz part of each row of viewProjection, and the direction
+  // the w row measures along
+  glm::vec4 rowLengths;
+  glm::vec3 viewDirection;
+  vector<Occluder> occluders;
+  vector<Bins> bins;
+  vector<Level> levels;
+  size_t triangles;
+
+  void setupOccluder(const Occluder &occluder, Bins &out) const;
+  void setupTriangle(const glm::vec4 *corners[3], Bins &out) const;
+  void rasterizeTile(int tile);
+  static void rasterizeScalar(const Triangle &t, float *depth, int x0, int x1,
+                              int y0, int y1);
+  static void rasterizeAVX2(const Triangle &t, float *depth, int x0, int x1,
+                            int y0, int y1);
+  void buildPyramid();
+  bool texelVisible(int level, int x, int y, const int rect[4],
+                    float depth) const;
+  bool regionVisible(float lowX, float lowY, float highX, float highY,
+                     float nearest) const;
+};
+
+// Which rasterizer kernel this CPU runs: "AVX2" or "scalar"
+const char *occlusionKernelName();
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef DRAW_KEY_H
+#define DRAW_KEY_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+/* Everything a draw needs bound. Program, texture set and vertex array are
+ dense ids from a DrawIds table, not GL names, since GL names can grow past
+ the bits the key gives them. lod picks the level of detail (MeshLod) of the
+ mesh.
+ */
+struct DrawState {
+  uint32_t layer;       // 4 bits: drawn in ascending order (scene, UI, ...)
+  bool translucent;     // Drawn after every opaque draw of its layer
+  uint32_t program;     // 12 bits
+  uint32_t textureSet;  // 10 bits
+  uint32_t vertexArray; // 10 bits
+  uint32_t lod;         // 3 bits: the range of the index buffer drawn
+};
+
+/* Packs a draw into a 64-bit sort key, so that sorting the keys gives the
+ submission order:
+
+ opaque       | layer:4 | 0 | program:12 | textures:10 | vao:10 | lod:3 | depth:24 |
+ translucent  | layer:4 | 1 | far-depth:24 | program:12 | textures:10 | vao:10 | lod:3 |
+
+ Opaque draws are grouped by state, then go front to back to help early-z.
+ Translucent draws have to go back to front to blend correctly, so their
+ depth comes before the state.
+ */
+namespace drawkey {
+
+const uint64_t depthMask = 0xFFFFFF;
+const uint32_t programLimit = 1 << 12;
+const uint32_t textureSetLimit = 1 << 10;
+const uint32_t vertexArrayLimit = 1 << 10;
+
+// The top 24 bits of a non-negative float keep its order
+inline uint64_t quantizeDepth(float depth) {
+  if (!(depth > 0.0f))
+    return 0;
+  uint32_t bits;
+  memcpy(&bits, &depth, sizeof(bits));
+  return bits >> 7;
+}
+
+inline uint64_t stateBits(const DrawState &state) {
+  assert(state.layer < 16 && state.lod < 8);
+  assert(state.program < programLimit &&
+         state.textureSet < textureSetLimit &&
+         state.vertexArray < vertexArrayLimit);
+  return ((uint64_t)(state.program & 0xFFF) << 23) |
+         ((uint64_t)(state.textureSet & 0x3FF) << 13) |
+         ((uint64_t)(state.vertexArray & 0x3FF) << 3) |
+         (uint64_t)(state.lod & 0x7);
+}
+
+} // namespace drawkey
+
+/* Hands out dense ids, in order of first use, for one kind of GL object, so
+ the key fields stay small however large the GL names get. Lookups walk the
+ table, which only ever holds a handful of names; fill it on one thread.
+ */
+class DrawIds {
+public:
+  explicit DrawIds(uint32_t limit) : limit(limit) {}
+
+  uint32_t id(uint32_t name) {
+    for (size_t i = 0; i < names.size(); i++)
+      if (names[i] == name)
+        return (uint32_t)i;
+    assert(names.size() < limit);
+    names.push_back(name);
+    return (uint32_t)names.size() - 1;
+  }
+
+  uint32_t name(uint32_t id) const { return names[id]; }
+
+private:
+  uint32_t limit;
+  vector<uint32_t> names;
+};
+
+inline uint64_t makeDrawKey(const DrawState &state, float depth) {
+  uint64_t key = (uint64_t)(state.layer & 0xF) << 60;
+  uint64_t depthBits = drawkey::quantizeDepth(depth);
+  if (!state.translucent)
+    return key | drawkey::stateBits(state) << 24 | depthBits;
+
+  key |= (uint64_t)1 << 59;
+  return key | (drawkey::depthMask - depthBits) << 35 |
+         drawkey::stateBits(state);
+}
+
+// The key with its depth cleared: equal for draws that can share state
+inline uint64_t drawKeyState(uint64_t key) {
+  bool translucent = (key >> 59) & 1;
+  return translucent ? key & ~(drawkey::depthMask << 35)
+                     : key & ~drawkey::depthMask;
+}
+
+inline DrawState decodeDrawKey(uint64_t key) {
+  DrawState state;
+  state.layer = (uint32_t)(key >> 60);
+  state.translucent = (key >> 59) & 1;
+  uint64_t bits = state.translucent ? key : key >> 24;
+  state.program = (uint32_t)(bits >> 23) & 0xFFF;
+  state.textureSet = (uint32_t)(bits >> 13) & 0x3FF;
+  state.vertexArray = (uint32_t)(bits >> 3) & 0x3FF;
+  state.lod = (uint32_t)bits & 0x7;
+  return state;
+}
+
+#endif
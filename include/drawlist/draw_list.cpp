@@ -0,0 +1,40 @@
+#include "draw_list.h"
+#include "radix_sort.h"
+
+void DrawList::reset(unsigned int workerCount) {
+  if (buckets.size() < workerCount)
+    buckets.resize(workerCount);
+
+  // clear() keeps the capacity, so steady state allocates nothing
+  for (Bucket &b : buckets)
+    b.packets.clear();
+  sorted.clear();
+  stateRuns.clear();
+}
+
+vector<DrawPacket> &DrawList::bucket(unsigned int worker) {
+  return buckets[worker].packets;
+}
+
+void DrawList::finish() {
+  size_t total = 0;
+  for (const Bucket &b : buckets)
+    total += b.packets.size();
+
+  sorted.reserve(total);
+  for (const Bucket &b : buckets)
+    sorted.insert(sorted.end(), b.packets.begin(), b.packets.end());
+
+  radixSortPackets(sorted, scratch);
+
+  for (size_t i = 0; i < sorted.size(); i++) {
+    uint64_t state = drawKeyState(sorted[i].key);
+    if (stateRuns.empty() || stateRuns.back().state != state)
+      stateRuns.push_back(Run{state, i, i});
+    stateRuns.back().end = i + 1;
+  }
+}
+
+const vector<DrawPacket> &DrawList::packets() const { return sorted; }
+
+const vector<DrawList::Run> &DrawList::runs() const { return stateRuns; }
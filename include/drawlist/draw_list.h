@@ -0,0 +1,55 @@
+#ifndef DRAW_LIST_H
+#define DRAW_LIST_H
+
+#include "drawlist/draw_key.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* One draw, as emitted by the workers that build the frame. `object` indexes
+ whatever per-object data the caller keeps (transforms, bounds) and `key`,
+ from makeDrawKey(), decides the submission order. The key only holds dense
+ ids, so the VAO to bind travels with the packet as its GL name.
+ */
+struct DrawPacket {
+  uint64_t key;
+  uint32_t object;
+  uint32_t vertexArray;
+};
+
+/* Collects the packets of one frame. Each worker appends to its own bucket,
+ so building needs no locks; finish() then merges them and radix sorts them
+ by key, and the thread that talks to GL only has to walk the result.
+ */
+class DrawList {
+public:
+  // A range of sorted packets that share their draw state (drawKeyState)
+  struct Run {
+    uint64_t state;
+    size_t begin, end;
+  };
+
+  // Empties the list and makes sure there is a bucket for every worker
+  void reset(unsigned int workerCount);
+  vector<DrawPacket> &bucket(unsigned int worker);
+
+  void finish();
+
+  const vector<DrawPacket> &packets() const;
+  const vector<Run> &runs() const;
+
+private:
+  // Padded to a cache line so workers don't share one while appending
+  struct alignas(64) Bucket {
+    vector<DrawPacket> packets;
+  };
+
+  vector<Bucket> buckets;
+  vector<DrawPacket> sorted;
+  vector<DrawPacket> scratch;
+  vector<Run> stateRuns;
+};
+
+#endif
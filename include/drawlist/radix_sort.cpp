@@ -0,0 +1,113 @@
+#include "radix_sort.h"
+#include "jobs/job_pool.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace {
+
+const unsigned int passCount = 8;
+const unsigned int bucketCount = 256;
+
+inline unsigned int keyByte(uint64_t key, unsigned int pass) {
+  return (unsigned int)(key >> (pass * 8)) & 0xFF;
+}
+
+void sortSerial(vector<DrawPacket> &packets, vector<DrawPacket> &scratch) {
+  size_t count = packets.size();
+
+  // All histograms in one read of the keys
+  uint32_t histograms[passCount][bucketCount];
+  memset(histograms, 0, sizeof(histograms));
+  for (const DrawPacket &packet : packets) {
+    for (unsigned int pass = 0; pass < passCount; pass++)
+      histograms[pass][keyByte(packet.key, pass)]++;
+  }
+
+  DrawPacket *source = packets.data();
+  DrawPacket *target = scratch.data();
+  for (unsigned int pass = 0; pass < passCount; pass++) {
+    uint32_t *histogram = histograms[pass];
+    if (histogram[keyByte(source[0].key, pass)] == count)
+      continue;
+
+    uint32_t offsets[bucketCount];
+    uint32_t sum = 0;
+    for (unsigned int b = 0; b < bucketCount; b++) {
+      offsets[b] = sum;
+      sum += histogram[b];
+    }
+    for (size_t i = 0; i < count; i++)
+      target[offsets[keyByte(source[i].key, pass)]++] = source[i];
+    swap(source, target);
+  }
+
+  if (source != packets.data())
+    packets.swap(scratch);
+}
+
+// Each worker owns a contiguous block of the input. Blocks count their own
+// histograms, a prefix sum over (bucket, block) gives every block its own
+// output ranges, and then all blocks scatter at once. Block order is kept
+// within each bucket, so the sort stays stable.
+void sortParallel(vector<DrawPacket> &packets, vector<DrawPacket> &scratch) {
+  size_t count = packets.size();
+  size_t blocks = jobPool.workerCount();
+  size_t blockSize = (count + blocks - 1) / blocks;
+  vector<uint32_t> histograms(blocks * bucketCount);
+
+  DrawPacket *source = packets.data();
+  DrawPacket *target = scratch.data();
+  for (unsigned int pass = 0; pass < passCount; pass++) {
+    jobPool.parallelFor(blocks, 1, [&](size_t block, size_t, unsigned int) {
+      uint32_t *histogram = &histograms[block * bucketCount];
+      memset(histogram, 0, bucketCount * sizeof(uint32_t));
+      size_t end = min(count, (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; i++)
+        histogram[keyByte(source[i].key, pass)]++;
+    });
+
+    // Skip the pass when one bucket holds everything
+    unsigned int first = keyByte(source[0].key, pass);
+    size_t inFirst = 0;
+    for (size_t block = 0; block < blocks; block++)
+      inFirst += histograms[block * bucketCount + first];
+    if (inFirst == count)
+      continue;
+
+    uint32_t sum = 0;
+    for (unsigned int b = 0; b < bucketCount; b++) {
+      for (size_t block = 0; block < blocks; block++) {
+        uint32_t &slot = histograms[block * bucketCount + b];
+        uint32_t n = slot;
+        slot = sum;
+        sum += n;
+      }
+    }
+
+    jobPool.parallelFor(blocks, 1, [&](size_t block, size_t, unsigned int) {
+      uint32_t *offsets = &histograms[block * bucketCount];
+      size_t end = min(count, (block + 1) * blockSize);
+      for (size_t i = block * blockSize; i < end; i++)
+        target[offsets[keyByte(source[i].key, pass)]++] = source[i];
+    });
+    swap(source, target);
+  }
+
+  if (source != packets.data())
+    packets.swap(scratch);
+}
+
+} // namespace
+
+void radixSortPackets(vector<DrawPacket> &packets,
+                      vector<DrawPacket> &scratch) {
+  if (packets.size() < 2)
+    return;
+  scratch.resize(packets.size());
+
+  if (packets.size() >= radixSortParallelThreshold && jobPool.workerCount() > 1)
+    sortParallel(packets, scratch);
+  else
+    sortSerial(packets, scratch);
+}
@@ -0,0 +1,17 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "drawlist/draw_list.h"
+
+/* Stable LSD radix sort of draw packets by key, one byte per pass. Passes
+ where every key has the same byte (common: most bits of a draw key are
+ state shared by many draws) are skipped. Large inputs build their
+ histograms and scatter on the job pool. `scratch` is resized as needed and
+ can be kept between calls to avoid reallocating.
+ */
+void radixSortPackets(vector<DrawPacket> &packets, vector<DrawPacket> &scratch);
+
+// Below this many packets a single thread is faster
+const size_t radixSortParallelThreshold = 1 << 16;
+
+#endif
@@ -60,6 +60,43 @@ namespace detail
 	};
 */
 
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_quat_mul<double, Q, true>
+	{
+		static qua<double, Q> call(qua<double, Q> const& p, qua<double, Q> const& q)
+		{
+			// Lane by lane this is the generic code, term for term and in the same order, so
+			// without contraction the results are bit-identical:
+			// p.w (x, y, z, w) + (x, y, z, x)(w, w, w, -x) + (y, z, x, y)(z, x, y, -y) + (z, x, y, z)(-y, -z, -x, -z)
+#			if GLM_ARCH & GLM_ARCH_AVX2_BIT
+				__m256d const pxyzx = _mm256_permute4x64_pd(p.data, _MM_SHUFFLE(0, 2, 1, 0));
+				__m256d const pyzxy = _mm256_permute4x64_pd(p.data, _MM_SHUFFLE(1, 0, 2, 1));
+				__m256d const pzxyz = _mm256_permute4x64_pd(p.data, _MM_SHUFFLE(2, 1, 0, 2));
+				__m256d const qwwwx = _mm256_permute4x64_pd(q.data, _MM_SHUFFLE(0, 3, 3, 3));
+				__m256d const qzxyy = _mm256_permute4x64_pd(q.data, _MM_SHUFFLE(1, 1, 0, 2));
+				__m256d const qyzxz = _mm256_permute4x64_pd(q.data, _MM_SHUFFLE(2, 0, 2, 1));
+#			else
+				__m256d const pxyzx = _mm256_setr_pd(p.x, p.y, p.z, p.x);
+				__m256d const pyzxy = _mm256_setr_pd(p.y, p.z, p.x, p.y);
+				__m256d const pzxyz = _mm256_setr_pd(p.z, p.x, p.y, p.z);
+				__m256d const qwwwx = _mm256_setr_pd(q.w, q.w, q.w, q.x);
+				__m256d const qzxyy = _mm256_setr_pd(q.z, q.x, q.y, q.y);
+				__m256d const qyzxz = _mm256_setr_pd(q.y, q.z, q.x, q.z);
+#			endif
+
+			__m256d const mul0 = _mm256_mul_pd(glm_dvec4_splat_w(p.data), q.data);
+			__m256d const mul1 = _mm256_mul_pd(pxyzx, _mm256_mul_pd(qwwwx, _mm256_setr_pd(1.0, 1.0, 1.0, -1.0)));
+			__m256d const mul2 = _mm256_mul_pd(pyzxy, _mm256_mul_pd(qzxyy, _mm256_setr_pd(1.0, 1.0, 1.0, -1.0)));
+			__m256d const mul3 = _mm256_mul_pd(pzxyz, _mm256_mul_pd(qyzxz, _mm256_set1_pd(-1.0)));
+
+			qua<double, Q> Result;
+			Result.data = _mm256_add_pd(_mm256_add_pd(_mm256_add_pd(mul0, mul1), mul2), mul3);
+			return Result;
+		}
+	};
+#	endif
+
 	template<qualifier Q>
 	struct compute_quat_add<float, Q, true>
 	{
@@ -126,7 +163,7 @@ namespace detail
 		static qua<double, Q> call(qua<double, Q> const& q, double s)
 		{
 			qua<double, Q> Result;
-			Result.data = _mm256_mul_pd(q.data, _mm_set_ps1(s));
+			Result.data = _mm256_mul_pd(q.data, _mm256_set1_pd(s));
 			return Result;
 		}
 	};
@@ -150,7 +187,7 @@ namespace detail
 		static qua<double, Q> call(qua<double, Q> const& q, double s)
 		{
 			qua<double, Q> Result;
-			Result.data = _mm256_div_pd(q.data, _mm_set_ps1(s));
+			Result.data = _mm256_div_pd(q.data, _mm256_set1_pd(s));
 			return Result;
 		}
 	};
@@ -0,0 +1,142 @@
+/// @ref simd
+/// @file glm/simd/batch_kernels.h
+///
+/// The kernels behind glm/simd/batch.h, written once over the register type of
+/// the enclosing namespace: wide, lanes, fused, the arithmetic on wide and
+/// load3/store3 for packed vec3. Included once per instruction set, inside its
+/// namespace and with GLM_BATCH_KERNEL giving the target, so no include guard.
+///
+/// Every kernel evaluates in the same order as its batch_scalar counterpart and
+/// hands what is left after the last full register to it.
+
+GLM_BATCH_KERNEL void mat4_mul_vec4(float const m[16], float const* in, float* out, std::size_t count)
+{
+	wide const c0 = broadcast4(m), c1 = broadcast4(m + 4), c2 = broadcast4(m + 8), c3 = broadcast4(m + 12);
+	std::size_t const step = lanes / 4;
+	std::size_t i = 0;
+	for(; i + step <= count; i += step)
+	{
+		wide const v = load(in + i * 4);
+		wide r = mul(c0, splat_x(v));
+		r = madd(c1, splat_y(v), r);
+		r = madd(c2, splat_z(v), r);
+		r = madd(c3, splat_w(v), r);
+		store(out + i * 4, r);
+	}
+	batch_scalar::mat4_mul_vec4<fused>(m, in + i * 4, out + i * 4, count - i);
+}
+
+GLM_BATCH_KERNEL void mat4_mul_vec4_soa(float const m[16], float const* const in[4], float* const out[4], std::size_t count)
+{
+	wide c[16];
+	for(int e = 0; e < 16; ++e)
+		c[e] = set1(m[e]);
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+	{
+		wide const x = load(in[0] + i), y = load(in[1] + i), z = load(in[2] + i), w = load(in[3] + i);
+		wide r[4];
+		for(int row = 0; row < 4; ++row)
+			r[row] = madd(c[12 + row], w, madd(c[8 + row], z, madd(c[4 + row], y, mul(c[row], x))));
+		for(int row = 0; row < 4; ++row)
+			store(out[row] + i, r[row]);
+	}
+	float const* const restIn[4] = {in[0] + i, in[1] + i, in[2] + i, in[3] + i};
+	float* const restOut[4] = {out[0] + i, out[1] + i, out[2] + i, out[3] + i};
+	batch_scalar::mat4_mul_vec4_soa<fused>(m, restIn, restOut, count - i);
+}
+
+GLM_BATCH_KERNEL wide dot(wide ax, wide ay, wide az, wide bx, wide by, wide bz)
+{
+	return madd(az, bz, madd(ay, by, mul(ax, bx)));
+}
+
+GLM_BATCH_KERNEL void vec3_dot(float const* a, float const* b, float* out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+	{
+		wide ax, ay, az, bx, by, bz;
+		load3(a + i * 3, ax, ay, az);
+		load3(b + i * 3, bx, by, bz);
+		store(out + i, dot(ax, ay, az, bx, by, bz));
+	}
+	batch_scalar::vec3_dot<fused>(a + i * 3, b + i * 3, out + i, count - i);
+}
+
+GLM_BATCH_KERNEL void vec3_dot_soa(float const* const a[3], float const* const b[3], float* out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+		store(out + i, dot(load(a[0] + i), load(a[1] + i), load(a[2] + i), load(b[0] + i), load(b[1] + i), load(b[2] + i)));
+	float const* const restA[3] = {a[0] + i, a[1] + i, a[2] + i};
+	float const* const restB[3] = {b[0] + i, b[1] + i, b[2] + i};
+	batch_scalar::vec3_dot_soa<fused>(restA, restB, out + i, count - i);
+}
+
+GLM_BATCH_KERNEL void cross(wide ax, wide ay, wide az, wide bx, wide by, wide bz, wide& x, wide& y, wide& z)
+{
+	x = msub(ay, bz, mul(az, by));
+	y = msub(az, bx, mul(ax, bz));
+	z = msub(ax, by, mul(ay, bx));
+}
+
+GLM_BATCH_KERNEL void vec3_cross(float const* a, float const* b, float* out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+	{
+		wide ax, ay, az, bx, by, bz, x, y, z;
+		load3(a + i * 3, ax, ay, az);
+		load3(b + i * 3, bx, by, bz);
+		cross(ax, ay, az, bx, by, bz, x, y, z);
+		store3(out + i * 3, x, y, z);
+	}
+	batch_scalar::vec3_cross<fused>(a + i * 3, b + i * 3, out + i * 3, count - i);
+}
+
+GLM_BATCH_KERNEL void vec3_cross_soa(float const* const a[3], float const* const b[3], float* const out[3], std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+	{
+		wide x, y, z;
+		cross(load(a[0] + i), load(a[1] + i), load(a[2] + i), load(b[0] + i), load(b[1] + i), load(b[2] + i), x, y, z);
+		store(out[0] + i, x);
+		store(out[1] + i, y);
+		store(out[2] + i, z);
+	}
+	float const* const restA[3] = {a[0] + i, a[1] + i, a[2] + i};
+	float const* const restB[3] = {b[0] + i, b[1] + i, b[2] + i};
+	float* const restOut[3] = {out[0] + i, out[1] + i, out[2] + i};
+	batch_scalar::vec3_cross_soa<fused>(restA, restB, restOut, count - i);
+}
+
+GLM_BATCH_KERNEL void vec3_normalize(float const* in, float* out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+	{
+		wide x, y, z;
+		load3(in + i * 3, x, y, z);
+		wide const length = sqrt(dot(x, y, z, x, y, z));
+		store3(out + i * 3, div(x, length), div(y, length), div(z, length));
+	}
+	batch_scalar::vec3_normalize<fused>(in + i * 3, out + i * 3, count - i);
+}
+
+GLM_BATCH_KERNEL void vec3_normalize_soa(float const* const in[3], float* const out[3], std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + lanes <= count; i += lanes)
+	{
+		wide const x = load(in[0] + i), y = load(in[1] + i), z = load(in[2] + i);
+		wide const length = sqrt(dot(x, y, z, x, y, z));
+		store(out[0] + i, div(x, length));
+		store(out[1] + i, div(y, length));
+		store(out[2] + i, div(z, length));
+	}
+	float const* const restIn[3] = {in[0] + i, in[1] + i, in[2] + i};
+	float* const restOut[3] = {out[0] + i, out[1] + i, out[2] + i};
+	batch_scalar::vec3_normalize_soa<fused>(restIn, restOut, count - i);
+}
@@ -0,0 +1,28 @@
+/// @ref simd
+/// @file glm/simd/bits.h
+
+#pragma once
+
+#include "../detail/setup.hpp"
+
+#if GLM_HAS_BITSCAN_WINDOWS
+#	include <intrin.h>
+#endif
+
+/// Index of the lowest set bit of mask, which must not be 0. Walks the lanes
+/// of a movemask result.
+GLM_FUNC_QUALIFIER int glm_lowest_bit(unsigned int mask)
+{
+#	if GLM_HAS_BITSCAN_WINDOWS
+		unsigned long Result(0);
+		_BitScanForward(&Result, mask);
+		return int(Result);
+#	elif GLM_COMPILER & (GLM_COMPILER_GCC | GLM_COMPILER_CLANG)
+		return __builtin_ctz(mask);
+#	else
+		int Result = 0;
+		for(; !(mask & 1u); mask >>= 1)
+			++Result;
+		return Result;
+#	endif
+}
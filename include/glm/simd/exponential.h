@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include "platform.h"
+#include "trigonometric.h"
 
 #if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
@@ -17,4 +17,255 @@ GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sqrt_lowp(glm_f32vec4 x)
 	return _mm_mul_ps(_mm_rsqrt_ps(x), x);
 }
 
+// As in glm/simd/trigonometric.h, exp and log evaluate in single precision
+// and stay within 2 ULP of the correctly rounded result over the whole float
+// range, denormals included. pow multiplies log(x) by y, which would scale its
+// rounding error up to hundreds of ULP, so it takes both in double precision
+// and is within 1 ULP. The _lowp functions stay in single precision: exp
+// within 1e-5 relative, log within 1e-5 absolute, pow within 1e-4 relative
+// while |y log(x)| < 20, and denormal results flushed to zero.
+
+// e^x for |x| < 709, with x = n * ln2 + r and |r| <= ln2 / 2. ln2_hi has 32
+// significant bits, so n * ln2_hi is exact.
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_exp(glm_f64vec2 x)
+{
+	glm_i32vec4 const n = _mm_cvtpd_epi32(_mm_mul_pd(x, _mm_set1_pd(1.44269504088896340736)));
+	glm_f64vec2 const nd = _mm_cvtepi32_pd(n);
+	glm_f64vec2 r = _mm_sub_pd(x, _mm_mul_pd(nd, _mm_set1_pd(6.93147180369123816490e-01)));
+	r = _mm_sub_pd(r, _mm_mul_pd(nd, _mm_set1_pd(1.90821492927058770002e-10)));
+
+	glm_f64vec2 p = _mm_set1_pd(1.98412698412698412698e-04);
+	p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(1.38888888888888888889e-03));
+	p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(8.33333333333333333333e-03));
+	p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(4.16666666666666666667e-02));
+	p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(1.66666666666666666667e-01));
+	p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(0.5));
+	p = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(p, r), r), r);
+	p = _mm_add_pd(p, _mm_set1_pd(1.0));
+
+	// 2^n, built in the exponent field: (0, n0, 0, n1) << 20 is n << 52
+	glm_i32vec4 const biased = _mm_add_epi32(n, _mm_set1_epi32(1023));
+	glm_i32vec4 const scale = _mm_slli_epi64(_mm_unpacklo_epi32(_mm_setzero_si128(), biased), 20);
+	return _mm_mul_pd(p, _mm_castsi128_pd(scale));
+}
+
+// log(x) for x > 0, to about 1e-12 relative: x = 2^e * m with
+// sqrt(2) / 2 < m <= sqrt(2), then log(m) = 2 atanh(s), s = (m - 1) / (m + 1).
+// 0 gives -inf and inf gives inf, as pow expects.
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_log(glm_f64vec2 x)
+{
+	glm_i32vec4 const bits = _mm_castpd_si128(x);
+	glm_i32vec4 const exponent = _mm_sub_epi32(_mm_srli_epi64(bits, 52), _mm_set1_epi32(1023));
+	glm_f64vec2 e = _mm_cvtepi32_pd(_mm_shuffle_epi32(exponent, _MM_SHUFFLE(3, 3, 2, 0)));
+	glm_f64vec2 m = _mm_castsi128_pd(_mm_or_si128(
+		_mm_and_si128(bits, _mm_set_epi32(0x000FFFFF, -1, 0x000FFFFF, -1)),
+		_mm_set_epi32(0x3FF00000, 0, 0x3FF00000, 0)));
+
+	glm_f64vec2 const above = _mm_cmpgt_pd(m, _mm_set1_pd(1.41421356237309504880));
+	m = _mm_mul_pd(m, _mm_or_pd(_mm_and_pd(above, _mm_set1_pd(0.5)), _mm_andnot_pd(above, _mm_set1_pd(1.0))));
+	e = _mm_add_pd(e, _mm_and_pd(above, _mm_set1_pd(1.0)));
+
+	glm_f64vec2 const f = _mm_sub_pd(m, _mm_set1_pd(1.0));
+	glm_f64vec2 const s = _mm_div_pd(f, _mm_add_pd(f, _mm_set1_pd(2.0)));
+	glm_f64vec2 const z = _mm_mul_pd(s, s);
+	glm_f64vec2 p = _mm_set1_pd(2.0 / 13.0);
+	p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(2.0 / 11.0));
+	p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(2.0 / 9.0));
+	p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(2.0 / 7.0));
+	p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(2.0 / 5.0));
+	p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(2.0 / 3.0));
+	glm_f64vec2 const logm = _mm_add_pd(_mm_add_pd(s, s), _mm_mul_pd(_mm_mul_pd(s, z), p));
+	glm_f64vec2 const result = _mm_add_pd(_mm_mul_pd(e, _mm_set1_pd(6.93147180559945309417e-01)), logm);
+
+	glm_f64vec2 const zero = _mm_cmpeq_pd(x, _mm_setzero_pd());
+	glm_f64vec2 const inf = _mm_cmpeq_pd(x, _mm_set1_pd(HUGE_VAL));
+	glm_f64vec2 const special = _mm_or_pd(_mm_and_pd(zero, _mm_set1_pd(-HUGE_VAL)), _mm_and_pd(inf, x));
+	return _mm_or_pd(_mm_andnot_pd(_mm_or_pd(zero, inf), result), special);
+}
+
+// Negative x, including -0, gives NaN, and so does NaN
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log_domain(glm_f32vec4 x, glm_f32vec4 result)
+{
+	glm_f32vec4 const invalid = _mm_or_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_cmpunord_ps(x, x));
+	return _mm_or_ps(result, invalid);
+}
+
+// 2^n for -252 <= n <= 254, as two factors, since either end is out of
+// range of a single float exponent. Applying them one after the other rounds
+// a denormal result only once.
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_scale_exp2(glm_f32vec4 x, glm_i32vec4 n)
+{
+	glm_i32vec4 const n1 = _mm_srai_epi32(n, 1);
+	glm_i32vec4 const n2 = _mm_sub_epi32(n, n1);
+	glm_f32vec4 const scale1 = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n1, _mm_set1_epi32(127)), 23));
+	glm_f32vec4 const scale2 = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n2, _mm_set1_epi32(127)), 23));
+	return glm_vec4_mul(glm_vec4_mul(x, scale1), scale2);
+}
+
+// e^x with x = n * ln2 + r and |r| <= ln2 / 2, and the polynomial of Cephes'
+// expf. ln2_hi has 9 significant bits, so n * ln2_hi is exact.
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_exp(glm_f32vec4 x)
+{
+	// e^89 overflows and e^-104 rounds to zero in single precision
+	glm_f32vec4 const clamped = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-104.0f)), _mm_set1_ps(89.0f));
+	glm_i32vec4 const n = _mm_cvtps_epi32(glm_vec4_mul(clamped, _mm_set1_ps(1.44269504f)));
+	glm_f32vec4 const nf = _mm_cvtepi32_ps(n);
+	glm_f32vec4 r = glm_vec4_sub(clamped, glm_vec4_mul(nf, _mm_set1_ps(0.693359375f)));
+	r = glm_vec4_sub(r, glm_vec4_mul(nf, _mm_set1_ps(-2.12194440e-4f)));
+
+	glm_f32vec4 p = glm_vec4_fma(r, _mm_set1_ps(1.9875691500e-4f), _mm_set1_ps(1.3981999507e-3f));
+	p = glm_vec4_fma(r, p, _mm_set1_ps(8.3334519073e-3f));
+	p = glm_vec4_fma(r, p, _mm_set1_ps(4.1665795894e-2f));
+	p = glm_vec4_fma(r, p, _mm_set1_ps(1.6666665459e-1f));
+	p = glm_vec4_fma(r, p, _mm_set1_ps(5.0000001201e-1f));
+	p = glm_vec4_fma(glm_vec4_mul(r, r), p, r);
+	p = glm_vec4_add(p, _mm_set1_ps(1.0f));
+
+	return _mm_or_ps(glm_vec4_scale_exp2(p, n), _mm_cmpunord_ps(x, x));
+}
+
+// x = 2^e * m with sqrt(2) / 2 < m <= sqrt(2), for finite x > 0, denormals
+// scaled up first
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log_split(glm_f32vec4 x, glm_f32vec4& e)
+{
+	glm_f32vec4 const denormal = _mm_cmplt_ps(x, _mm_set1_ps(1.17549435e-38f));
+	glm_f32vec4 const scaled = _mm_or_ps(_mm_andnot_ps(denormal, x), _mm_and_ps(denormal, glm_vec4_mul(x, _mm_set1_ps(8388608.0f))));
+	glm_i32vec4 const bits = _mm_castps_si128(scaled);
+	e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	e = glm_vec4_sub(e, _mm_and_ps(denormal, _mm_set1_ps(23.0f)));
+	glm_f32vec4 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+	glm_f32vec4 const above = _mm_cmpgt_ps(m, _mm_set1_ps(1.41421356f));
+	m = glm_vec4_mul(m, _mm_or_ps(_mm_and_ps(above, _mm_set1_ps(0.5f)), _mm_andnot_ps(above, _mm_set1_ps(1.0f))));
+	e = glm_vec4_add(e, _mm_and_ps(above, _mm_set1_ps(1.0f)));
+	return m;
+}
+
+// 0 gives -inf and inf gives inf, as pow expects
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log_special(glm_f32vec4 x, glm_f32vec4 result)
+{
+	glm_f32vec4 const zero = _mm_cmpeq_ps(x, _mm_setzero_ps());
+	glm_f32vec4 const inf = _mm_cmpeq_ps(x, _mm_set1_ps(HUGE_VALF));
+	glm_f32vec4 const special = _mm_or_ps(_mm_and_ps(zero, _mm_set1_ps(-HUGE_VALF)), _mm_and_ps(inf, x));
+	return _mm_or_ps(_mm_andnot_ps(_mm_or_ps(zero, inf), result), special);
+}
+
+// log(x) for x > 0 with the polynomial of Cephes' logf: log(m) from
+// f = m - 1, which is exact, and e * ln2 added in two parts, low one first
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log_positive(glm_f32vec4 x)
+{
+	glm_f32vec4 e;
+	glm_f32vec4 const f = glm_vec4_sub(glm_vec4_log_split(x, e), _mm_set1_ps(1.0f));
+	glm_f32vec4 const z = glm_vec4_mul(f, f);
+	glm_f32vec4 p = glm_vec4_fma(f, _mm_set1_ps(7.0376836292e-2f), _mm_set1_ps(-1.1514610310e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(1.1676998740e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(-1.2420140846e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(1.4249322787e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(-1.6668057665e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(2.0000714765e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(-2.4999993993e-1f));
+	p = glm_vec4_fma(f, p, _mm_set1_ps(3.3333331174e-1f));
+	glm_f32vec4 y = glm_vec4_mul(glm_vec4_mul(p, f), z);
+	y = glm_vec4_fma(e, _mm_set1_ps(-2.12194440e-4f), y);
+	y = glm_vec4_fma(z, _mm_set1_ps(-0.5f), y);
+	return glm_vec4_log_special(x, glm_vec4_fma(e, _mm_set1_ps(0.693359375f), glm_vec4_add(f, y)));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log(glm_f32vec4 x)
+{
+	return glm_vec4_log_domain(x, glm_vec4_log_positive(x));
+}
+
+// Takes |x|^y, computed with log(0) = -inf and log(inf) = inf, to the C
+// library's pow(x, y): the sign for negative x and odd integer y, NaN for
+// finite negative x and finite non integer y or for NaN in either, and 1
+// for y = 0, x = 1 and x = -1 with infinite y.
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_pow_special(glm_f32vec4 x, glm_f32vec4 y, glm_f32vec4 magnitude)
+{
+	glm_f32vec4 const one = _mm_set1_ps(1.0f);
+	glm_f32vec4 const inf = _mm_set1_ps(HUGE_VALF);
+	glm_f32vec4 const ax = glm_vec4_abs(x);
+	glm_f32vec4 const ay = glm_vec4_abs(y);
+
+	// Past 2^24 every float is an even integer, and so is inf for pow
+	glm_f32vec4 const large = _mm_cmpge_ps(ay, _mm_set1_ps(16777216.0f));
+	glm_i32vec4 const truncated = _mm_cvttps_epi32(y);
+	glm_f32vec4 const integer = _mm_or_ps(large, _mm_cmpeq_ps(_mm_cvtepi32_ps(truncated), y));
+	glm_f32vec4 const odd = _mm_andnot_ps(large, _mm_and_ps(integer,
+		_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(truncated, _mm_set1_epi32(1)), _mm_set1_epi32(1)))));
+
+	glm_f32vec4 const negativeFinite = _mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_cmpneq_ps(ax, inf));
+	glm_f32vec4 const invalid = _mm_or_ps(
+		_mm_andnot_ps(integer, _mm_and_ps(negativeFinite, _mm_cmpneq_ps(ay, inf))),
+		_mm_or_ps(_mm_cmpunord_ps(x, x), _mm_cmpunord_ps(y, y)));
+	glm_f32vec4 const sign = _mm_and_ps(odd, _mm_and_ps(x, _mm_set1_ps(-0.0f)));
+	glm_f32vec4 const result = _mm_or_ps(_mm_xor_ps(magnitude, sign), invalid);
+
+	glm_f32vec4 const unit = _mm_or_ps(
+		_mm_or_ps(_mm_cmpeq_ps(y, _mm_setzero_ps()), _mm_cmpeq_ps(x, one)),
+		_mm_and_ps(_mm_cmpeq_ps(ax, one), _mm_cmpeq_ps(ay, inf)));
+	return _mm_or_ps(_mm_andnot_ps(unit, result), _mm_and_ps(unit, one));
+}
+
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_pow_magnitude(glm_f64vec2 ax, glm_f64vec2 y)
+{
+	glm_f64vec2 const t = _mm_mul_pd(y, glm_dvec2_log(ax));
+	return glm_dvec2_exp(_mm_min_pd(_mm_max_pd(t, _mm_set1_pd(-104.0)), _mm_set1_pd(89.0)));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_pow(glm_f32vec4 x, glm_f32vec4 y)
+{
+	glm_f32vec4 const ax = glm_vec4_abs(x);
+	glm_f32vec4 const magnitude = glm_dvec2_to_vec4(
+		glm_dvec2_pow_magnitude(glm_vec4_lo_to_dvec2(ax), glm_vec4_lo_to_dvec2(y)),
+		glm_dvec2_pow_magnitude(glm_vec4_hi_to_dvec2(ax), glm_vec4_hi_to_dvec2(y)));
+	return glm_vec4_pow_special(x, y, magnitude);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_exp_lowp(glm_f32vec4 x)
+{
+	// Between log(FLT_MIN) and log(FLT_MAX)
+	glm_f32vec4 const clamped = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-87.3365448f)), _mm_set1_ps(88.7228391f));
+	glm_i32vec4 const n = _mm_cvtps_epi32(glm_vec4_mul(clamped, _mm_set1_ps(1.44269504f)));
+	glm_f32vec4 const nf = _mm_cvtepi32_ps(n);
+	glm_f32vec4 r = glm_vec4_sub(clamped, glm_vec4_mul(nf, _mm_set1_ps(0.693359375f)));
+	r = glm_vec4_sub(r, glm_vec4_mul(nf, _mm_set1_ps(-2.12194440e-4f)));
+
+	glm_f32vec4 p = glm_vec4_fma(r, _mm_set1_ps(8.33333333e-3f), _mm_set1_ps(4.16666667e-2f));
+	p = glm_vec4_fma(r, p, _mm_set1_ps(1.66666667e-1f));
+	p = glm_vec4_fma(r, p, _mm_set1_ps(0.5f));
+	p = glm_vec4_fma(glm_vec4_mul(r, r), p, r);
+	p = glm_vec4_add(p, _mm_set1_ps(1.0f));
+
+	glm_f32vec4 const result = glm_vec4_scale_exp2(p, n);
+
+	glm_f32vec4 const over = _mm_cmpgt_ps(x, _mm_set1_ps(88.7228391f));
+	glm_f32vec4 const under = _mm_cmplt_ps(x, _mm_set1_ps(-87.3365448f));
+	glm_f32vec4 const inRange = _mm_andnot_ps(_mm_or_ps(over, under), result);
+	return _mm_or_ps(_mm_or_ps(inRange, _mm_and_ps(over, _mm_set1_ps(HUGE_VALF))), _mm_cmpunord_ps(x, x));
+}
+
+// Same as glm_dvec2_log in single precision
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log_positive_lowp(glm_f32vec4 x)
+{
+	glm_f32vec4 e;
+	glm_f32vec4 const f = glm_vec4_sub(glm_vec4_log_split(x, e), _mm_set1_ps(1.0f));
+	glm_f32vec4 const s = glm_vec4_div(f, glm_vec4_add(f, _mm_set1_ps(2.0f)));
+	glm_f32vec4 const z = glm_vec4_mul(s, s);
+	glm_f32vec4 const p = glm_vec4_fma(z, _mm_set1_ps(0.4f), _mm_set1_ps(0.666666667f));
+	glm_f32vec4 const logm = glm_vec4_fma(glm_vec4_mul(s, z), p, glm_vec4_add(s, s));
+	return glm_vec4_log_special(x, glm_vec4_fma(e, _mm_set1_ps(0.693147181f), logm));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_log_lowp(glm_f32vec4 x)
+{
+	return glm_vec4_log_domain(x, glm_vec4_log_positive_lowp(x));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_pow_lowp(glm_f32vec4 x, glm_f32vec4 y)
+{
+	glm_f32vec4 const magnitude = glm_vec4_exp_lowp(glm_vec4_mul(y, glm_vec4_log_positive_lowp(glm_vec4_abs(x))));
+	return glm_vec4_pow_special(x, y, magnitude);
+}
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -391,6 +391,13 @@
 	typedef __m256i			glm_u64vec4;
 #endif
 
+// Every AVX2 processor has FMA3 but GCC and Clang only enable it with -mfma or -march
+#if (GLM_ARCH & GLM_ARCH_AVX2_BIT) && (defined(__FMA__) || (GLM_COMPILER & GLM_COMPILER_VC))
+#	define GLM_HAS_FMA 1
+#else
+#	define GLM_HAS_FMA 0
+#endif
+
 #if GLM_ARCH & GLM_ARCH_NEON_BIT
 	typedef float32x4_t			glm_f32vec4;
 	typedef int32x4_t			glm_i32vec4;
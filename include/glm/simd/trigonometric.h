@@ -3,7 +3,401 @@
 
 #pragma once
 
+#include "common.h"
+
+#include <cmath>
+
 #if GLM_ARCH & GLM_ARCH_SSE2_BIT
 
-#endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
+// The default functions evaluate in single precision, four lanes at a time,
+// and stay within 2 ULP of the correctly rounded result. The few lanes the
+// single precision reduction can't take that far, |x| past about 12867 or
+// just next to a multiple of pi / 2, are redone in double precision, two at a
+// time; past 2^20, infinities and NaNs go to the C library.
+//
+// The _lowp functions stay in single precision with shorter polynomials, in
+// the spirit of GTX_fast_trigonometry: sin, cos and atan within 1e-4
+// absolute for |x| < 1e5, tan as their ratio.
+
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_vec4_lo_to_dvec2(glm_f32vec4 x)
+{
+	return _mm_cvtps_pd(x);
+}
+
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_vec4_hi_to_dvec2(glm_f32vec4 x)
+{
+	return _mm_cvtps_pd(_mm_movehl_ps(x, x));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_dvec2_to_vec4(glm_f64vec2 lo, glm_f64vec2 hi)
+{
+	return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+// Repeats the low two 32-bit lanes across the 64-bit lanes: (a, a, b, b)
+GLM_FUNC_QUALIFIER glm_i32vec4 glm_ivec4_spread_lo(glm_i32vec4 x)
+{
+	return _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 1, 0, 0));
+}
+
+// Lanes 0 and 1, or 2 and 3, of a float mask as a double mask
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_vec4_lo_mask_to_dvec2(glm_f32vec4 mask)
+{
+	return _mm_castsi128_pd(glm_ivec4_spread_lo(_mm_castps_si128(mask)));
+}
+
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_vec4_hi_mask_to_dvec2(glm_f32vec4 mask)
+{
+	return _mm_castsi128_pd(_mm_shuffle_epi32(_mm_castps_si128(mask), _MM_SHUFFLE(3, 3, 2, 2)));
+}
+
+// Rounds to float and returns what rounding lost in tail
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_dvec2_to_vec4_split(glm_f64vec2 lo, glm_f64vec2 hi, glm_f32vec4& tail)
+{
+	glm_f32vec4 const head = glm_dvec2_to_vec4(lo, hi);
+	tail = glm_dvec2_to_vec4(
+		_mm_sub_pd(lo, glm_vec4_lo_to_dvec2(head)),
+		_mm_sub_pd(hi, glm_vec4_hi_to_dvec2(head)));
+	return head;
+}
+
+// Recomputes the lanes set in mask with func
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_patch_lanes(glm_f32vec4 x, glm_f32vec4 result, glm_f32vec4 mask, float (*func)(float))
+{
+	int const lanes = _mm_movemask_ps(mask);
+	if(lanes == 0)
+		return result;
+
+	float in[4], out[4];
+	_mm_storeu_ps(in, x);
+	_mm_storeu_ps(out, result);
+	for(int i = 0; i < 4; ++i)
+		if(lanes & (1 << i))
+			out[i] = func(in[i]);
+	return _mm_loadu_ps(out);
+}
+
+// x = q * pi / 2 + r with |r| <= pi / 4. pio2_1 has 33 significant bits, so
+// q * pio2_1 is exact and the reduction is as long as |q| < 2^20.
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_reduce_half_pi(glm_f64vec2 x, glm_i32vec4& q)
+{
+	glm_f64vec2 const two_over_pi = _mm_set1_pd(6.36619772367581382433e-01);
+	glm_f64vec2 const pio2_1 = _mm_set1_pd(1.57079632673412561417e+00);
+	glm_f64vec2 const pio2_1t = _mm_set1_pd(6.07710050650619224932e-11);
+
+	q = _mm_cvtpd_epi32(_mm_mul_pd(x, two_over_pi));
+	glm_f64vec2 const n = _mm_cvtepi32_pd(q);
+	glm_f64vec2 const r = _mm_sub_pd(x, _mm_mul_pd(n, pio2_1));
+	return _mm_sub_pd(r, _mm_mul_pd(n, pio2_1t));
+}
+
+// sin(r) and cos(r) for |r| <= pi / 4, to about 2e-9 relative
+GLM_FUNC_QUALIFIER void glm_dvec2_sincos_reduced(glm_f64vec2 r, glm_f64vec2& s, glm_f64vec2& c)
+{
+	glm_f64vec2 const z = _mm_mul_pd(r, r);
+
+	glm_f64vec2 ps = _mm_set1_pd(2.75573192239858906526e-06);
+	ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(-1.98412698412698412698e-04));
+	ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(8.33333333333333333333e-03));
+	ps = _mm_add_pd(_mm_mul_pd(ps, z), _mm_set1_pd(-1.66666666666666666667e-01));
+	// As a product, so that sin(-0) stays -0
+	s = _mm_mul_pd(r, _mm_add_pd(_mm_set1_pd(1.0), _mm_mul_pd(z, ps)));
+
+	glm_f64vec2 pc = _mm_set1_pd(-2.75573192239858906526e-07);
+	pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(2.48015873015873015873e-05));
+	pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(-1.38888888888888888889e-03));
+	pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(4.16666666666666666667e-02));
+	pc = _mm_add_pd(_mm_mul_pd(pc, z), _mm_set1_pd(-0.5));
+	c = _mm_add_pd(_mm_set1_pd(1.0), _mm_mul_pd(z, pc));
+}
+
+// sin(x + shift * pi / 2)
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_sin_shifted(glm_f64vec2 x, int shift)
+{
+	glm_i32vec4 q;
+	glm_f64vec2 s, c;
+	glm_dvec2_sincos_reduced(glm_dvec2_reduce_half_pi(x, q), s, c);
+
+	glm_i32vec4 const quadrant = glm_ivec4_spread_lo(_mm_add_epi32(q, _mm_set1_epi32(shift)));
+	glm_f64vec2 const odd = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_f64vec2 const sign = _mm_castsi128_pd(_mm_slli_epi64(quadrant, 62));
+	glm_f64vec2 const sel = _mm_or_pd(_mm_and_pd(odd, c), _mm_andnot_pd(odd, s));
+	return _mm_xor_pd(sel, _mm_and_pd(sign, _mm_set1_pd(-0.0)));
+}
+
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_tan(glm_f64vec2 x)
+{
+	glm_i32vec4 q;
+	glm_f64vec2 s, c;
+	glm_dvec2_sincos_reduced(glm_dvec2_reduce_half_pi(x, q), s, c);
+
+	// tan(r + pi / 2) = -cos(r) / sin(r)
+	glm_i32vec4 const quadrant = glm_ivec4_spread_lo(q);
+	glm_f64vec2 const odd = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_f64vec2 const num = _mm_or_pd(_mm_and_pd(odd, _mm_xor_pd(c, _mm_set1_pd(-0.0))), _mm_andnot_pd(odd, s));
+	glm_f64vec2 const den = _mm_or_pd(_mm_and_pd(odd, s), _mm_andnot_pd(odd, c));
+	return _mm_div_pd(num, den);
+}
+
+// lanes glm_dvec2_reduce_half_pi can't take, NaNs included
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_outside_half_pi_reduction(glm_f32vec4 x)
+{
+	return _mm_cmpnle_ps(glm_vec4_abs(x), _mm_set1_ps(1048576.0f));
+}
+
+// sin(x + shift * pi / 2) in double precision, for the lanes the single
+// precision reduction gives up on
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sin_shifted_wide(glm_f32vec4 x, int shift)
+{
+	glm_f32vec4 const result = glm_dvec2_to_vec4(
+		glm_dvec2_sin_shifted(glm_vec4_lo_to_dvec2(x), shift),
+		glm_dvec2_sin_shifted(glm_vec4_hi_to_dvec2(x), shift));
+	float (*const func)(float) = shift ? static_cast<float (*)(float)>(std::cos) : static_cast<float (*)(float)>(std::sin);
+	return glm_vec4_patch_lanes(x, result, glm_vec4_outside_half_pi_reduction(x), func);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_tan_wide(glm_f32vec4 x)
+{
+	glm_f32vec4 const result = glm_dvec2_to_vec4(
+		glm_dvec2_tan(glm_vec4_lo_to_dvec2(x)),
+		glm_dvec2_tan(glm_vec4_hi_to_dvec2(x)));
+	return glm_vec4_patch_lanes(x, result, glm_vec4_outside_half_pi_reduction(x), static_cast<float (*)(float)>(std::tan));
+}
+
+// Takes the lanes in mask from func(x) instead
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_widen_lanes(glm_f32vec4 x, glm_f32vec4 result, glm_f32vec4 mask, glm_f32vec4 (*func)(glm_f32vec4))
+{
+	if(_mm_movemask_ps(mask) == 0)
+		return result;
+	return _mm_or_ps(_mm_and_ps(mask, func(x)), _mm_andnot_ps(mask, result));
+}
+
+// x = q * pi / 2 + r + tail in single precision, in three parts (Cody and
+// Waite). pio2_1 has 8 significant bits and pio2_2 11, so while |q| < 2^13
+// both products and the first two differences are exact, and tail is what
+// rounding the last one lost. The parts leave out about |q| * 1.3e-14, so
+// lanes with |r| below |q| * 2^-20 are flagged in inexact, along with larger
+// q, infinities and NaNs.
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_reduce_half_pi(glm_f32vec4 x, glm_i32vec4& q, glm_f32vec4& tail, glm_f32vec4& inexact)
+{
+	q = _mm_cvtps_epi32(glm_vec4_mul(x, _mm_set1_ps(0.636619772f)));
+	glm_f32vec4 const n = _mm_cvtepi32_ps(q);
+	glm_f32vec4 r = glm_vec4_sub(x, glm_vec4_mul(n, _mm_set1_ps(1.5703125f)));
+	r = glm_vec4_sub(r, glm_vec4_mul(n, _mm_set1_ps(4.837512969970703125e-4f)));
+	glm_f32vec4 const p3 = glm_vec4_mul(n, _mm_set1_ps(7.54978995489188216e-8f));
+	glm_f32vec4 const head = glm_vec4_sub(r, p3);
+	tail = glm_vec4_sub(glm_vec4_sub(r, head), p3);
+
+	glm_f32vec4 const an = glm_vec4_abs(n);
+	inexact = _mm_or_ps(
+		_mm_cmpge_ps(an, _mm_set1_ps(8192.0f)),
+		_mm_cmplt_ps(glm_vec4_abs(head), glm_vec4_mul(an, _mm_set1_ps(9.53674316e-7f))));
+	return head;
+}
+
+// sin(r + tail) and cos(r + tail) for |r| <= pi / 4, with the minimax
+// polynomials of Cephes' sinf and cosf. tail goes in to first order.
+GLM_FUNC_QUALIFIER void glm_vec4_sincos_reduced(glm_f32vec4 r, glm_f32vec4 tail, glm_f32vec4& s, glm_f32vec4& c)
+{
+	glm_f32vec4 const z = glm_vec4_mul(r, r);
+
+	glm_f32vec4 ps = glm_vec4_fma(z, _mm_set1_ps(-1.9515295891e-4f), _mm_set1_ps(8.3321608736e-3f));
+	ps = glm_vec4_fma(z, ps, _mm_set1_ps(-1.6666654611e-1f));
+	s = glm_vec4_add(r, glm_vec4_fma(glm_vec4_mul(r, z), ps, tail));
+	// sin(r) has the sign of r, which keeps sin(-0) = -0
+	s = _mm_or_ps(s, _mm_and_ps(r, _mm_set1_ps(-0.0f)));
 
+	glm_f32vec4 pc = glm_vec4_fma(z, _mm_set1_ps(2.443315711809948e-5f), _mm_set1_ps(-1.388731625493765e-3f));
+	pc = glm_vec4_fma(z, pc, _mm_set1_ps(4.166664568298827e-2f));
+	glm_f32vec4 const low = glm_vec4_sub(glm_vec4_mul(z, _mm_set1_ps(-0.5f)), glm_vec4_mul(r, tail));
+	c = glm_vec4_add(_mm_set1_ps(1.0f), glm_vec4_fma(glm_vec4_mul(z, z), pc, low));
+}
+
+// sin(r + quadrant * pi / 2) from sin(r) and cos(r)
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sin_quadrant(glm_i32vec4 quadrant, glm_f32vec4 s, glm_f32vec4 c)
+{
+	glm_f32vec4 const odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_f32vec4 const sign = _mm_castsi128_ps(_mm_slli_epi32(quadrant, 30));
+	glm_f32vec4 const sel = _mm_or_ps(_mm_and_ps(odd, c), _mm_andnot_ps(odd, s));
+	return _mm_xor_ps(sel, _mm_and_ps(sign, _mm_set1_ps(-0.0f)));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sin_wide(glm_f32vec4 x)
+{
+	return glm_vec4_sin_shifted_wide(x, 0);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_cos_wide(glm_f32vec4 x)
+{
+	return glm_vec4_sin_shifted_wide(x, 1);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sin(glm_f32vec4 x)
+{
+	glm_i32vec4 q;
+	glm_f32vec4 tail, inexact, s, c;
+	glm_f32vec4 const r = glm_vec4_reduce_half_pi(x, q, tail, inexact);
+	glm_vec4_sincos_reduced(r, tail, s, c);
+	return glm_vec4_widen_lanes(x, glm_vec4_sin_quadrant(q, s, c), inexact, glm_vec4_sin_wide);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_cos(glm_f32vec4 x)
+{
+	glm_i32vec4 q;
+	glm_f32vec4 tail, inexact, s, c;
+	glm_f32vec4 const r = glm_vec4_reduce_half_pi(x, q, tail, inexact);
+	glm_vec4_sincos_reduced(r, tail, s, c);
+	glm_f32vec4 const result = glm_vec4_sin_quadrant(_mm_add_epi32(q, _mm_set1_epi32(1)), s, c);
+	return glm_vec4_widen_lanes(x, result, inexact, glm_vec4_cos_wide);
+}
+
+// -1 / (head + tail) in the lanes in odd and head + tail in the others,
+// summed and divided in double precision so that the result is rounded once
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_tan_quadrant(glm_f64vec2 head, glm_f64vec2 tail, glm_f64vec2 odd)
+{
+	glm_f64vec2 const t = _mm_add_pd(head, tail);
+	glm_f64vec2 const cot = _mm_div_pd(_mm_set1_pd(-1.0), t);
+	return _mm_or_pd(_mm_and_pd(odd, cot), _mm_andnot_pd(odd, t));
+}
+
+// tan(r) for |r| <= pi / 4, and -1 / tan(r) = tan(r + pi / 2) in the odd
+// quadrants, with the polynomial of Cephes' tanf. A float reciprocal would
+// add half an ULP to what r already costs, too much for 2 ULP, so the
+// quotient is taken in double precision.
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_tan(glm_f32vec4 x)
+{
+	glm_i32vec4 q;
+	glm_f32vec4 tail, inexact;
+	glm_f32vec4 const r = glm_vec4_reduce_half_pi(x, q, tail, inexact);
+
+	glm_f32vec4 const z = glm_vec4_mul(r, r);
+	glm_f32vec4 p = glm_vec4_fma(z, _mm_set1_ps(9.38540185543e-3f), _mm_set1_ps(3.11992232697e-3f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(2.44301354525e-2f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(5.34112807005e-2f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(1.33387994085e-1f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(3.33331568548e-1f));
+	// head + low is r + w exactly, as |r| >= |w|
+	glm_f32vec4 const w = glm_vec4_fma(glm_vec4_mul(r, z), p, tail);
+	glm_f32vec4 const head = glm_vec4_add(r, w);
+	glm_f32vec4 const low = glm_vec4_sub(w, glm_vec4_sub(head, r));
+
+	glm_f32vec4 const odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_f32vec4 const result = glm_dvec2_to_vec4(
+		glm_dvec2_tan_quadrant(glm_vec4_lo_to_dvec2(head), glm_vec4_lo_to_dvec2(low), glm_vec4_lo_mask_to_dvec2(odd)),
+		glm_dvec2_tan_quadrant(glm_vec4_hi_to_dvec2(head), glm_vec4_hi_to_dvec2(low), glm_vec4_hi_mask_to_dvec2(odd)));
+	return glm_vec4_widen_lanes(x, result, inexact, glm_vec4_tan_wide);
+}
+
+// t = -1 / |x| in the lanes in big, (|x| - 1) / (|x| + 1) in those in mid and
+// |x| in the others. In double precision only the division rounds; in float,
+// the sums would too, and cost atan about an ULP.
+GLM_FUNC_QUALIFIER glm_f64vec2 glm_dvec2_atan_reduce(glm_f64vec2 ax, glm_f64vec2 big, glm_f64vec2 mid)
+{
+	glm_f64vec2 const one = _mm_set1_pd(1.0);
+	glm_f64vec2 const reduced = _mm_or_pd(big, mid);
+	glm_f64vec2 const num = _mm_or_pd(_mm_and_pd(big, _mm_set1_pd(-1.0)), _mm_andnot_pd(big, _mm_sub_pd(ax, _mm_and_pd(mid, one))));
+	glm_f64vec2 const den = _mm_or_pd(_mm_and_pd(reduced, _mm_add_pd(ax, _mm_and_pd(mid, one))), _mm_andnot_pd(reduced, one));
+	return _mm_div_pd(num, den);
+}
+
+// atan(|x|) = base + atan(t) with |t| <= tan(pi / 8): base is pi / 2 past
+// tan(3 pi / 8) and pi / 4 past tan(pi / 8). t comes in two parts and base in
+// two more, the low ones added before the polynomial of Cephes' atanf.
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_atan(glm_f32vec4 x)
+{
+	glm_f32vec4 const sign = _mm_and_ps(x, _mm_set1_ps(-0.0f));
+	glm_f32vec4 const ax = _mm_xor_ps(x, sign);
+
+	glm_f32vec4 const big = _mm_cmpgt_ps(ax, _mm_set1_ps(2.414213562f));
+	glm_f32vec4 const mid = _mm_andnot_ps(big, _mm_cmpgt_ps(ax, _mm_set1_ps(0.414213562f)));
+	glm_f32vec4 tail;
+	glm_f32vec4 const t = glm_dvec2_to_vec4_split(
+		glm_dvec2_atan_reduce(glm_vec4_lo_to_dvec2(ax), glm_vec4_lo_mask_to_dvec2(big), glm_vec4_lo_mask_to_dvec2(mid)),
+		glm_dvec2_atan_reduce(glm_vec4_hi_to_dvec2(ax), glm_vec4_hi_mask_to_dvec2(big), glm_vec4_hi_mask_to_dvec2(mid)),
+		tail);
+	glm_f32vec4 const base = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.57079637f)), _mm_and_ps(mid, _mm_set1_ps(0.785398185f)));
+	glm_f32vec4 const baseTail = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(-4.37113883e-8f)), _mm_and_ps(mid, _mm_set1_ps(-2.18556941e-8f)));
+
+	glm_f32vec4 const z = glm_vec4_mul(t, t);
+	glm_f32vec4 p = glm_vec4_fma(z, _mm_set1_ps(8.05374449538e-2f), _mm_set1_ps(-1.38776856032e-1f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(1.99777106478e-1f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(-3.33329491539e-1f));
+	glm_f32vec4 const w = glm_vec4_fma(glm_vec4_mul(t, z), p, glm_vec4_add(tail, baseTail));
+	glm_f32vec4 const r = glm_vec4_add(base, glm_vec4_add(t, w));
+	return _mm_xor_ps(r, sign);
+}
+
+// Single precision reduction by pi / 2, in two parts: 1.5703125 has 8
+// significant bits, so n * 1.5703125 is exact while |n| < 2^16
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_reduce_half_pi_lowp(glm_f32vec4 x, glm_i32vec4& q)
+{
+	q = _mm_cvtps_epi32(glm_vec4_mul(x, _mm_set1_ps(0.636619772f)));
+	glm_f32vec4 const n = _mm_cvtepi32_ps(q);
+	glm_f32vec4 const r = glm_vec4_sub(x, glm_vec4_mul(n, _mm_set1_ps(1.5703125f)));
+	return glm_vec4_sub(r, glm_vec4_mul(n, _mm_set1_ps(4.83826794897e-4f)));
+}
+
+GLM_FUNC_QUALIFIER void glm_vec4_sincos_reduced_lowp(glm_f32vec4 r, glm_f32vec4& s, glm_f32vec4& c)
+{
+	glm_f32vec4 const z = glm_vec4_mul(r, r);
+
+	glm_f32vec4 const ps = glm_vec4_fma(z, _mm_set1_ps(8.33333333e-3f), _mm_set1_ps(-1.66666667e-1f));
+	s = glm_vec4_mul(r, glm_vec4_fma(z, ps, _mm_set1_ps(1.0f)));
+
+	glm_f32vec4 pc = glm_vec4_fma(z, _mm_set1_ps(-1.38888889e-3f), _mm_set1_ps(4.16666667e-2f));
+	pc = glm_vec4_fma(z, pc, _mm_set1_ps(-0.5f));
+	c = glm_vec4_fma(z, pc, _mm_set1_ps(1.0f));
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sin_shifted_lowp(glm_f32vec4 x, int shift)
+{
+	glm_i32vec4 q;
+	glm_f32vec4 s, c;
+	glm_vec4_sincos_reduced_lowp(glm_vec4_reduce_half_pi_lowp(x, q), s, c);
+
+	return glm_vec4_sin_quadrant(_mm_add_epi32(q, _mm_set1_epi32(shift)), s, c);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_sin_lowp(glm_f32vec4 x)
+{
+	return glm_vec4_sin_shifted_lowp(x, 0);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_cos_lowp(glm_f32vec4 x)
+{
+	return glm_vec4_sin_shifted_lowp(x, 1);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_tan_lowp(glm_f32vec4 x)
+{
+	glm_i32vec4 q;
+	glm_f32vec4 s, c;
+	glm_vec4_sincos_reduced_lowp(glm_vec4_reduce_half_pi_lowp(x, q), s, c);
+
+	glm_f32vec4 const odd = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+	glm_f32vec4 const num = _mm_or_ps(_mm_and_ps(odd, _mm_xor_ps(c, _mm_set1_ps(-0.0f))), _mm_andnot_ps(odd, s));
+	glm_f32vec4 const den = _mm_or_ps(_mm_and_ps(odd, s), _mm_andnot_ps(odd, c));
+	return glm_vec4_div(num, den);
+}
+
+GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_atan_lowp(glm_f32vec4 x)
+{
+	glm_f32vec4 const sign = _mm_and_ps(x, _mm_set1_ps(-0.0f));
+	glm_f32vec4 const ax = _mm_xor_ps(x, sign);
+	glm_f32vec4 const one = _mm_set1_ps(1.0f);
+
+	glm_f32vec4 const big = _mm_cmpgt_ps(ax, _mm_set1_ps(2.414213562f));
+	glm_f32vec4 const mid = _mm_andnot_ps(big, _mm_cmpgt_ps(ax, _mm_set1_ps(0.414213562f)));
+	glm_f32vec4 const tbig = glm_vec4_div(_mm_set1_ps(-1.0f), ax);
+	glm_f32vec4 const tmid = glm_vec4_div(glm_vec4_sub(ax, one), glm_vec4_add(ax, one));
+	glm_f32vec4 const t = _mm_or_ps(_mm_or_ps(_mm_and_ps(big, tbig), _mm_and_ps(mid, tmid)), _mm_andnot_ps(_mm_or_ps(big, mid), ax));
+	glm_f32vec4 const base = _mm_or_ps(_mm_and_ps(big, _mm_set1_ps(1.570796327f)), _mm_and_ps(mid, _mm_set1_ps(0.785398163f)));
+
+	glm_f32vec4 const z = glm_vec4_mul(t, t);
+	glm_f32vec4 p = glm_vec4_fma(z, _mm_set1_ps(-1.0f / 7.0f), _mm_set1_ps(1.0f / 5.0f));
+	p = glm_vec4_fma(z, p, _mm_set1_ps(-1.0f / 3.0f));
+	glm_f32vec4 const r = glm_vec4_add(base, glm_vec4_fma(glm_vec4_mul(t, z), p, t));
+	return _mm_xor_ps(r, sign);
+}
+
+#endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -0,0 +1,283 @@
+#include "gl_state.h"
+
+#include <iostream>
+#include <string.h>
+
+using namespace std;
+
+GLStateCache glState;
+
+static const char *callNames[GLStateCache::CallCount] = {
+    "glUseProgram",  "glBindVertexArray", "glBindBuffer", "glActiveTexture",
+    "glBindTexture", "glEnable/Disable",  "glBlendFunc",  "glDepthFunc",
+    "glDepthMask",   "glViewport"};
+
+GLStateCache::GLStateCache() {
+  invalidate();
+  resetCounters();
+}
+
+bool GLStateCache::changed(Call call, bool differs) {
+  if (differs)
+    stats.issued[call]++;
+  else
+    stats.elided[call]++;
+  return differs;
+}
+
+void GLStateCache::useProgram(GLuint newProgram) {
+  if (changed(UseProgram, program != newProgram)) {
+    program = newProgram;
+    glUseProgram(program);
+  }
+}
+
+void GLStateCache::bindVertexArray(GLuint newVertexArray) {
+  if (changed(BindVertexArray, vertexArray != newVertexArray)) {
+    vertexArray = newVertexArray;
+    glBindVertexArray(vertexArray);
+
+    // The element array binding is part of the vertex array object
+    buffers[ElementArrayBuffer] = unknown;
+  }
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+  int slot = bufferSlot(target);
+  if (slot < 0) {
+    changed(BindBuffer, true);
+    glBindBuffer(target, buffer);
+    return;
+  }
+
+  if (changed(BindBuffer, buffers[slot] != buffer)) {
+    buffers[slot] = buffer;
+    glBindBuffer(target, buffer);
+  }
+}
+
+void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+  // Indexed bindings are not tracked, but they also bind the generic target
+  glBindBufferBase(target, index, buffer);
+
+  int slot = bufferSlot(target);
+  if (slot >= 0)
+    buffers[slot] = buffer;
+}
+
+void GLStateCache::activeTexture(GLenum unit) {
+  if (changed(ActiveTexture, activeUnit != unit)) {
+    activeUnit = unit;
+    glActiveTexture(unit);
+  }
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+  unsigned int unit = activeUnit == unknown ? maxTextureUnits
+                                            : activeUnit - GL_TEXTURE0;
+  int slot = textureSlot(target);
+  if (slot < 0 || unit >= maxTextureUnits) {
+    changed(BindTexture, true);
+    glBindTexture(target, texture);
+    return;
+  }
+
+  if (changed(BindTexture, textures[unit][slot] != texture)) {
+    textures[unit][slot] = texture;
+    glBindTexture(target, texture);
+  }
+}
+
+void GLStateCache::bindTexture(unsigned int unit, GLenum target,
+                               GLuint texture) {
+  // Only switch units when the binding actually has to change
+  int slot = textureSlot(target);
+  if (slot >= 0 && unit < maxTextureUnits &&
+      textures[unit][slot] == texture) {
+    changed(BindTexture, false);
+    return;
+  }
+
+  activeTexture(GL_TEXTURE0 + unit);
+  bindTexture(target, texture);
+}
+
+void GLStateCache::setCapability(GLenum capability, bool enabled) {
+  int slot = capabilitySlot(capability);
+  if (slot < 0) {
+    changed(Capability, true);
+    enabled ? glEnable(capability) : glDisable(capability);
+    return;
+  }
+
+  if (changed(Capability, capabilities[slot] != (GLuint)enabled)) {
+    capabilities[slot] = enabled;
+    enabled ? glEnable(capability) : glDisable(capability);
+  }
+}
+
+void GLStateCache::enable(GLenum capability) { setCapability(capability, true); }
+
+void GLStateCache::disable(GLenum capability) {
+  setCapability(capability, false);
+}
+
+void GLStateCache::blendFunc(GLenum source, GLenum destination) {
+  if (changed(BlendFunc,
+              blendSource != source || blendDestination != destination)) {
+    blendSource = source;
+    blendDestination = destination;
+    glBlendFunc(source, destination);
+  }
+}
+
+void GLStateCache::depthFunc(GLenum func) {
+  if (changed(DepthFunc, depthFunction != func)) {
+    depthFunction = func;
+    glDepthFunc(func);
+  }
+}
+
+void GLStateCache::depthMask(GLboolean flag) {
+  if (changed(DepthMask, depthWrite != (GLuint)flag)) {
+    depthWrite = flag;
+    glDepthMask(flag);
+  }
+}
+
+void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+  GLint rect[4] = {x, y, width, height};
+  if (changed(Viewport, memcmp(viewportRect, rect, sizeof(rect)) != 0)) {
+    memcpy(viewportRect, rect, sizeof(rect));
+    glViewport(x, y, width, height);
+  }
+}
+
+void GLStateCache::deleteProgram(GLuint deleted) {
+  // A program in use is only flagged for deletion, so it stays bound
+  glDeleteProgram(deleted);
+}
+
+void GLStateCache::deleteVertexArrays(GLsizei count,
+                                      const GLuint *vertexArrays) {
+  for (GLsizei i = 0; i < count; i++) {
+    if (vertexArray == vertexArrays[i]) {
+      vertexArray = 0;
+      buffers[ElementArrayBuffer] = unknown;
+    }
+  }
+  glDeleteVertexArrays(count, vertexArrays);
+}
+
+void GLStateCache::deleteBuffers(GLsizei count, const GLuint *deleted) {
+  for (GLsizei i = 0; i < count; i++) {
+    for (int slot = 0; slot < BufferTargetCount; slot++) {
+      if (buffers[slot] == deleted[i])
+        buffers[slot] = 0;
+    }
+  }
+  glDeleteBuffers(count, deleted);
+}
+
+void GLStateCache::deleteTextures(GLsizei count, const GLuint *deleted) {
+  for (GLsizei i = 0; i < count; i++) {
+    for (unsigned int unit = 0; unit < maxTextureUnits; unit++) {
+      for (int slot = 0; slot < TextureTargetCount; slot++) {
+        if (textures[unit][slot] == deleted[i])
+          textures[unit][slot] = 0;
+      }
+    }
+  }
+  glDeleteTextures(count, deleted);
+}
+
+GLuint GLStateCache::currentProgram() const { return program; }
+
+GLuint GLStateCache::currentVertexArray() const { return vertexArray; }
+
+void GLStateCache::invalidate() {
+  program = unknown;
+  vertexArray = unknown;
+  activeUnit = unknown;
+  blendSource = blendDestination = unknown;
+  depthFunction = unknown;
+  depthWrite = unknown;
+
+  for (int slot = 0; slot < BufferTargetCount; slot++)
+    buffers[slot] = unknown;
+  for (unsigned int unit = 0; unit < maxTextureUnits; unit++) {
+    for (int slot = 0; slot < TextureTargetCount; slot++)
+      textures[unit][slot] = unknown;
+  }
+  for (int slot = 0; slot < CapabilityCount; slot++)
+    capabilities[slot] = unknown;
+  for (int i = 0; i < 4; i++)
+    viewportRect[i] = -1;
+}
+
+const GLStateCache::Counters &GLStateCache::counters() const { return stats; }
+
+void GLStateCache::resetCounters() { memset(&stats, 0, sizeof(stats)); }
+
+void GLStateCache::printCounters() const {
+  uint64_t issued = 0, elided = 0;
+  cout << "GL state calls (issued / elided)" << endl;
+  for (int call = 0; call < CallCount; call++) {
+    if (stats.issued[call] == 0 && stats.elided[call] == 0)
+      continue;
+    cout << "  " << callNames[call] << ": " << stats.issued[call] << " / "
+         << stats.elided[call] << endl;
+    issued += stats.issued[call];
+    elided += stats.elided[call];
+  }
+  cout << "  total: " << issued << " / " << elided << endl;
+}
+
+int GLStateCache::bufferSlot(GLenum target) {
+  switch (target) {
+  case GL_ARRAY_BUFFER:
+    return ArrayBuffer;
+  case GL_ELEMENT_ARRAY_BUFFER:
+    return ElementArrayBuffer;
+  case GL_UNIFORM_BUFFER:
+    return UniformBuffer;
+  case GL_COPY_READ_BUFFER:
+    return CopyReadBuffer;
+  case GL_COPY_WRITE_BUFFER:
+    return CopyWriteBuffer;
+  case GL_PIXEL_UNPACK_BUFFER:
+    return PixelUnpackBuffer;
+  default:
+    return -1;
+  }
+}
+
+int GLStateCache::textureSlot(GLenum target) {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return Texture2D;
+  case GL_TEXTURE_3D:
+    return Texture3D;
+  case GL_TEXTURE_CUBE_MAP:
+    return TextureCubeMap;
+  case GL_TEXTURE_2D_ARRAY:
+    return Texture2DArray;
+  default:
+    return -1;
+  }
+}
+
+int GLStateCache::capabilitySlot(GLenum capability) {
+  switch (capability) {
+  case GL_DEPTH_TEST:
+    return DepthTest;
+  case GL_BLEND:
+    return Blend;
+  case GL_CULL_FACE:
+    return CullFace;
+  case GL_SCISSOR_TEST:
+    return ScissorTest;
+  default:
+    return -1;
+  }
+}
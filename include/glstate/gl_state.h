@@ -0,0 +1,123 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h> // include glad to get all the required OpenGL headers
+
+#include <stdint.h>
+
+/* Shadows the GL state the app touches, so that binding something that is
+ already bound never reaches the driver. Everything that changes this state
+ has to go through the cache (or call invalidate() afterwards), otherwise the
+ shadow copy goes stale.
+ */
+class GLStateCache {
+public:
+  // What each counter slot refers to
+  enum Call {
+    UseProgram,
+    BindVertexArray,
+    BindBuffer,
+    ActiveTexture,
+    BindTexture,
+    Capability,
+    BlendFunc,
+    DepthFunc,
+    DepthMask,
+    Viewport,
+    CallCount
+  };
+
+  struct Counters {
+    uint64_t issued[CallCount];
+    uint64_t elided[CallCount];
+  };
+
+  static const unsigned int maxTextureUnits = 32;
+
+  GLStateCache();
+
+  void useProgram(GLuint program);
+  void bindVertexArray(GLuint vertexArray);
+  void bindBuffer(GLenum target, GLuint buffer);
+  void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+  void activeTexture(GLenum unit);
+  void bindTexture(GLenum target, GLuint texture);
+  void bindTexture(unsigned int unit, GLenum target, GLuint texture);
+  void enable(GLenum capability);
+  void disable(GLenum capability);
+  void blendFunc(GLenum source, GLenum destination);
+  void depthFunc(GLenum func);
+  void depthMask(GLboolean flag);
+  void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  // GL unbinds deleted objects, so the cache has to forget them too
+  void deleteProgram(GLuint program);
+  void deleteVertexArrays(GLsizei count, const GLuint *vertexArrays);
+  void deleteBuffers(GLsizei count, const GLuint *buffers);
+  void deleteTextures(GLsizei count, const GLuint *textures);
+
+  GLuint currentProgram() const;
+  GLuint currentVertexArray() const;
+
+  // Forget everything, e.g. after code outside the cache changed GL state
+  void invalidate();
+
+  const Counters &counters() const;
+  void resetCounters();
+  void printCounters() const;
+
+private:
+  // Buffer and texture targets the cache knows about; others pass through
+  enum BufferTarget {
+    ArrayBuffer,
+    ElementArrayBuffer,
+    UniformBuffer,
+    CopyReadBuffer,
+    CopyWriteBuffer,
+    PixelUnpackBuffer,
+    BufferTargetCount
+  };
+  enum TextureTarget {
+    Texture2D,
+    Texture3D,
+    TextureCubeMap,
+    Texture2DArray,
+    TextureTargetCount
+  };
+  enum CapabilityIndex {
+    DepthTest,
+    Blend,
+    CullFace,
+    ScissorTest,
+    CapabilityCount
+  };
+
+  // State that is not known yet (start up, or after invalidate())
+  static const GLuint unknown = 0xFFFFFFFFu;
+
+  GLuint program;
+  GLuint vertexArray;
+  GLuint buffers[BufferTargetCount];
+  GLenum activeUnit;
+  GLuint textures[maxTextureUnits][TextureTargetCount];
+  GLuint capabilities[CapabilityCount];
+  GLenum blendSource, blendDestination;
+  GLenum depthFunction;
+  GLuint depthWrite;
+  GLint viewportRect[4];
+
+  Counters stats;
+
+  // True if the call has to reach GL; counts it either way
+  bool changed(Call call, bool differs);
+  void setCapability(GLenum capability, bool enabled);
+
+  static int bufferSlot(GLenum target);
+  static int textureSlot(GLenum target);
+  static int capabilitySlot(GLenum capability);
+};
+
+// The state of the one GL context the app uses
+extern GLStateCache glState;
+
+#endif
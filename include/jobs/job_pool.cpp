@@ -0,0 +1,126 @@
+#include "job_pool.h"
+
+#include <algorithm>
+
+JobPool jobPool;
+
+JobPool::JobPool() {
+  generation = 0;
+  stopping = false;
+  busy = 0;
+  job = NULL;
+  count = grain = chunks = 0;
+  nextChunk = 0;
+  remaining = 0;
+}
+
+JobPool::~JobPool() { stop(); }
+
+void JobPool::start(unsigned int threadCount) {
+  stop();
+  stopping = false;
+  for (unsigned int i = 0; i < threadCount; i++)
+    threads.push_back(thread(&JobPool::workerLoop, this, i + 1));
+}
+
+void JobPool::stop() {
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (thread &worker : threads)
+    worker.join();
+  threads.clear();
+}
+
+unsigned int JobPool::workerCount() const {
+  return (unsigned int)threads.size() + 1;
+}
+
+unsigned int JobPool::defaultThreadCount() {
+  unsigned int cores = thread::hardware_concurrency();
+  return cores > 1 ? cores - 1 : 0;
+}
+
+void JobPool::parallelFor(size_t itemCount, size_t itemGrain,
+                          const RangeJob &rangeJob) {
+  if (itemCount == 0)
+    return;
+
+  // Chunks never exceed the grain, even inline: jobs may size scratch by it
+  itemGrain = max(itemGrain, (size_t)1);
+  if (threads.empty() || itemCount <= itemGrain) {
+    for (size_t begin = 0; begin < itemCount; begin += itemGrain)
+      rangeJob(begin, min(begin + itemGrain, itemCount), 0);
+    return;
+  }
+
+  size_t chunkCount = (itemCount + itemGrain - 1) / itemGrain;
+  {
+    lock_guard<mutex> guard(lock);
+    job = &rangeJob;
+    count = itemCount;
+    grain = itemGrain;
+    chunks = chunkCount;
+    nextChunk.store(0, memory_order_relaxed);
+    remaining.store(chunkCount, memory_order_relaxed);
+    generation++;
+  }
+  wake.notify_all();
+
+  runChunks(rangeJob, itemCount, itemGrain, chunkCount, 0);
+
+  // Workers hold on to the job until they leave runChunks, so wait for them
+  // too before the job goes out of scope
+  unique_lock<mutex> guard(lock);
+  done.wait(guard, [this] {
+    return remaining.load(memory_order_acquire) == 0 && busy == 0;
+  });
+  job = NULL;
+}
+
+void JobPool::runChunks(const RangeJob &rangeJob, size_t itemCount,
+                        size_t itemGrain, size_t chunkCount,
+                        unsigned int worker) {
+  for (;;) {
+    size_t chunk = nextChunk.fetch_add(1, memory_order_relaxed);
+    if (chunk >= chunkCount)
+      return;
+
+    size_t begin = chunk * itemGrain;
+    rangeJob(begin, min(begin + itemGrain, itemCount), worker);
+    remaining.fetch_sub(1, memory_order_release);
+  }
+}
+
+void JobPool::workerLoop(unsigned int worker) {
+  uint64_t seen = 0;
+  for (;;) {
+    const RangeJob *rangeJob;
+    size_t itemCount, itemGrain, chunkCount;
+    {
+      unique_lock<mutex> guard(lock);
+      wake.wait(guard, [&] { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+      // Woke after the call had already finished
+      if (!job)
+        continue;
+      busy++;
+      rangeJob = job;
+      itemCount = count;
+      itemGrain = grain;
+      chunkCount = chunks;
+    }
+
+    runChunks(*rangeJob, itemCount, itemGrain, chunkCount, worker);
+
+    {
+      lock_guard<mutex> guard(lock);
+      busy--;
+    }
+    done.notify_one();
+  }
+}
@@ -0,0 +1,67 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* A fixed set of worker threads for data-parallel loops. parallelFor splits
+ [0, count) into chunks of `grain` items that the workers and the calling
+ thread take in turn, and returns once all of them are done. Worker 0 is
+ always the calling thread, so per-worker scratch space can be indexed by the
+ worker argument with workerCount() slots.
+
+ Only one thread may call parallelFor at a time, and jobs must not call it
+ themselves. GL must stay on the calling thread.
+ */
+class JobPool {
+public:
+  typedef function<void(size_t begin, size_t end, unsigned int worker)>
+      RangeJob;
+
+  JobPool();
+  ~JobPool();
+
+  // Threads besides the caller. 0 runs every job inline.
+  void start(unsigned int threadCount);
+  void stop();
+
+  unsigned int workerCount() const;
+  void parallelFor(size_t count, size_t grain, const RangeJob &job);
+
+  // One thread per core, minus the one that calls parallelFor
+  static unsigned int defaultThreadCount();
+
+private:
+  vector<thread> threads;
+
+  mutex lock;
+  condition_variable wake;
+  condition_variable done;
+  uint64_t generation;
+  bool stopping;
+  unsigned int busy;
+
+  // The current call, only touched under the lock. Workers copy it when they
+  // join, and job is NULL between calls so late wakers don't join a call
+  // that has already returned.
+  const RangeJob *job;
+  size_t count, grain, chunks;
+  // Reset under the lock while no worker is in runChunks
+  atomic<size_t> nextChunk;
+  atomic<size_t> remaining;
+
+  void workerLoop(unsigned int worker);
+  void runChunks(const RangeJob &rangeJob, size_t itemCount, size_t itemGrain,
+                 size_t chunkCount, unsigned int worker);
+};
+
+extern JobPool jobPool;
+
+#endif
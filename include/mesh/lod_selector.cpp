@@ -0,0 +1,38 @@
+#include "lod_selector.h"
+
+#include <algorithm>
+
+// Closer than this everything is treated as touching the eye
+static const float minimumDistance = 1e-4f;
+
+LodSelector::LodSelector() {
+  pixelError = 1.0f;
+  hysteresis = 0.25f;
+  projectionScale = 1.0f;
+}
+
+void LodSelector::resize(size_t instanceCount) {
+  current.assign(instanceCount, 0);
+}
+
+void LodSelector::setView(const glm::mat4 &projection, int viewportHeight) {
+  // projection[1][1] is cot(fovy / 2): the height of the view at distance 1
+  // is 2 / projection[1][1]
+  projectionScale = projection[1][1] * (float)viewportHeight * 0.5f;
+}
+
+uint32_t LodSelector::select(size_t instance, float distance,
+                             const MeshLod *lods, uint32_t lodCount) {
+  // The most error, in model units, that stays under pixelError
+  float limit = pixelError * max(distance, minimumDistance) / projectionScale;
+
+  uint32_t lod = min<uint32_t>(current[instance], lodCount - 1);
+  while (lod > 0 && lods[lod].error > limit)
+    lod--;
+  float coarsenLimit = limit * (1.0f - hysteresis);
+  while (lod + 1 < lodCount && lods[lod + 1].error <= coarsenLimit)
+    lod++;
+
+  current[instance] = (uint8_t)lod;
+  return lod;
+}
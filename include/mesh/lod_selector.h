@@ -0,0 +1,46 @@
+#ifndef LOD_SELECTOR_H
+#define LOD_SELECTOR_H
+
+#include "mesh/mesh_simplifier.h"
+
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Picks a level of detail for every instance of a mesh, the coarsest whose
+ error covers at most pixelError pixels on screen. Each instance remembers
+ its level, and only moves to a coarser one once that is well inside the
+ budget (by `hysteresis`), so instances near a switching distance don't pop
+ back and forth from frame to frame.
+
+ select() only writes the entry of its own instance, so instances can be
+ split over workers.
+ */
+class LodSelector {
+public:
+  float pixelError;
+  // Fraction of the budget a coarser level has to stay under to be picked
+  float hysteresis;
+
+  LodSelector();
+
+  void resize(size_t instanceCount);
+  // Camera::projection (a perspective projection) and the viewport height in
+  // pixels it is drawn at
+  void setView(const glm::mat4 &projection, int viewportHeight);
+
+  // `distance` is from the eye to the closest point of the instance's bounds;
+  // lods are finest first, as buildLods returns them
+  uint32_t select(size_t instance, float distance, const MeshLod *lods,
+                  uint32_t lodCount);
+
+private:
+  // Pixels per model unit at distance 1
+  float projectionScale;
+  vector<uint8_t> current;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "mapped_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MAPPED_FILE_HAS_MMAP
+#endif
+
+MappedFile::MappedFile() {
+  data = NULL;
+  size = 0;
+  mapped = false;
+}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const string &path) {
+  close();
+
+#ifdef MAPPED_FILE_HAS_MMAP
+  int file = ::open(path.c_str(), O_RDONLY);
+  if (file < 0)
+    return false;
+
+  struct stat info;
+  if (fstat(file, &info) != 0) {
+    ::close(file);
+    return false;
+  }
+
+  size = (size_t)info.st_size;
+  if (size > 0) {
+    void *view = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (view != MAP_FAILED) {
+      // Parsers read front to back
+      madvise(view, size, MADV_SEQUENTIAL);
+      data = (const unsigned char *)view;
+      mapped = true;
+    }
+  }
+  ::close(file);
+  if (mapped || size == 0)
+    return true;
+#endif
+
+  FILE *stream = fopen(path.c_str(), "rb");
+  if (!stream)
+    return false;
+  fseek(stream, 0, SEEK_END);
+  long length = ftell(stream);
+  fseek(stream, 0, SEEK_SET);
+
+  unsigned char *buffer = (unsigned char *)malloc(length > 0 ? length : 1);
+  size = fread(buffer, 1, length > 0 ? length : 0, stream);
+  fclose(stream);
+  data = buffer;
+  return true;
+}
+
+void MappedFile::close() {
+#ifdef MAPPED_FILE_HAS_MMAP
+  if (mapped)
+    munmap((void *)data, size);
+#endif
+  if (!mapped)
+    free((void *)data);
+
+  data = NULL;
+  size = 0;
+  mapped = false;
+}
@@ -0,0 +1,30 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <string>
+
+using namespace std;
+
+/* A read-only view of a whole file. On POSIX systems the file is mapped, so
+ pages are only read once something touches them and several threads can
+ parse it at once without copies. Elsewhere it is read into memory.
+ */
+class MappedFile {
+public:
+  const unsigned char *data;
+  size_t size;
+
+  MappedFile();
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  bool open(const string &path);
+  void close();
+
+private:
+  bool mapped;
+};
+
+#endif
@@ -0,0 +1,340 @@
+#include "mesh_cache.h"
+
+#include "jobs/job_pool.h"
+#include "mesh/mesh_importer.h"
+#include "mesh/mesh_optimizer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+static const char meshCacheMagic[8] = {'M', 'E', 'S', 'H',
+                                       'C', 'A', 'C', 'H'};
+
+static uint64_t alignUp(uint64_t offset, uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Hashing
+
+namespace {
+
+const uint64_t hashPrime1 = 0x9E3779B97F4A7C15ull;
+const uint64_t hashPrime2 = 0xC2B2AE3D27D4EB4Full;
+
+inline uint64_t hashMix(uint64_t hash, uint64_t value) {
+  hash ^= value * hashPrime1;
+  hash = (hash << 31) | (hash >> 33);
+  return hash * hashPrime2;
+}
+
+uint64_t hashBlock(const unsigned char *data, size_t size, uint64_t seed) {
+  // Four independent lanes keep the multiplies from serializing
+  uint64_t lanes[4] = {seed, seed + hashPrime1, seed + hashPrime2,
+                       seed - hashPrime1};
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    for (int lane = 0; lane < 4; lane++) {
+      uint64_t value;
+      memcpy(&value, data + i + lane * 8, 8);
+      lanes[lane] = hashMix(lanes[lane], value);
+    }
+  }
+  uint64_t hash = hashMix(hashMix(lanes[0], lanes[1]),
+                          hashMix(lanes[2], lanes[3]));
+  for (; i < size; i++)
+    hash = hashMix(hash, data[i]);
+  return hashMix(hash, size);
+}
+
+} // namespace
+
+// Fixed-size blocks are hashed in parallel and their hashes hashed in order,
+// so the result doesn't depend on the number of workers
+uint64_t hashFileContents(const unsigned char *data, size_t size) {
+  const size_t blockBytes = 1 << 20;
+  size_t blockCount = (size + blockBytes - 1) / blockBytes;
+  vector<uint64_t> blockHashes(blockCount);
+  jobPool.parallelFor(blockCount, 1, [&](size_t begin, size_t end, unsigned) {
+    for (size_t b = begin; b < end; b++) {
+      size_t offset = b * blockBytes;
+      blockHashes[b] =
+          hashBlock(data + offset, min(blockBytes, size - offset), b);
+    }
+  });
+
+  uint64_t hash = hashMix(0, size);
+  for (uint64_t blockHash : blockHashes)
+    hash = hashMix(hash, blockHash);
+  return hash;
+}
+
+// Reading
+
+MeshCache::MeshCache() { header = NULL; }
+
+bool MeshCache::open(const string &path) {
+  close();
+  if (!file.open(path))
+    return false;
+
+  if (file.size < sizeof(MeshCacheHeader)) {
+    close();
+    return false;
+  }
+  const MeshCacheHeader *candidate = (const MeshCacheHeader *)file.data;
+
+  // Every section has to be where the header says and fit in the file
+  uint64_t size = file.size;
+  uint64_t vertexBytes =
+      (uint64_t)candidate->vertexCount * candidate->vertexStride;
+  uint64_t indexBytes = (uint64_t)candidate->indexCount * sizeof(uint32_t);
+  uint64_t lodBytes = (uint64_t)candidate->lodCount * sizeof(MeshLod);
+  bool valid =
+      memcmp(candidate->magic, meshCacheMagic, sizeof(meshCacheMagic)) == 0 &&
+      candidate->version == version &&
+      candidate->headerBytes == sizeof(MeshCacheHeader) &&
+      candidate->vertexDataOffset % cacheAlignment == 0 &&
+      candidate->indexDataOffset % cacheAlignment == 0 &&
+      candidate->lodTableOffset % cacheAlignment == 0 &&
+      candidate->vertexDataOffset <= size &&
+      vertexBytes <= size - candidate->vertexDataOffset &&
+      candidate->indexDataOffset <= size &&
+      indexBytes <= size - candidate->indexDataOffset &&
+      candidate->lodTableOffset <= size &&
+      lodBytes <= size - candidate->lodTableOffset && candidate->lodCount > 0;
+  if (!valid) {
+    close();
+    return false;
+  }
+
+  const MeshLod *table =
+      (const MeshLod *)(file.data + candidate->lodTableOffset);
+  for (uint32_t i = 0; i < candidate->lodCount; i++) {
+    if (table[i].indexOffset > candidate->indexCount ||
+        table[i].indexCount > candidate->indexCount - table[i].indexOffset) {
+      close();
+      return false;
+    }
+  }
+
+  header = candidate;
+  return true;
+}
+
+void MeshCache::close() {
+  file.close();
+  header = NULL;
+}
+
+const void *MeshCache::vertexData() const {
+  return file.data + header->vertexDataOffset;
+}
+
+size_t MeshCache::vertexBytes() const {
+  return (size_t)header->vertexCount * header->vertexStride;
+}
+
+const uint32_t *MeshCache::indexData() const {
+  return (const uint32_t *)(file.data + header->indexDataOffset);
+}
+
+size_t MeshCache::indexBytes() const {
+  return header->indexCount * sizeof(uint32_t);
+}
+
+const MeshLod *MeshCache::lods() const {
+  return (const MeshLod *)(file.data + header->lodTableOffset);
+}
+
+VertexFormat MeshCache::format() const {
+  return VertexFormat{(PositionFormat)header->positionFormat,
+                      (TexCoordFormat)header->texCoordFormat,
+                      (NormalFormat)header->normalFormat};
+}
+
+QuantizedVertices MeshCache::layout() const {
+  QuantizedVertices result;
+  result.format = format();
+  result.vertexCount = header->vertexCount;
+  result.stride = header->vertexStride;
+  result.positionOffset = header->positionOffset;
+  result.texCoordOffset = header->texCoordOffset;
+  result.normalOffset = header->normalOffset;
+  result.positionScale = glm::vec3(header->positionScale[0],
+                                   header->positionScale[1],
+                                   header->positionScale[2]);
+  result.positionBias = glm::vec3(header->positionBias[0],
+                                  header->positionBias[1],
+                                  header->positionBias[2]);
+  result.positionError = result.texCoordError = result.normalError = 0.0f;
+  return result;
+}
+
+MeshBounds computeMeshBounds(const float *vertices, size_t vertexCount,
+                             size_t strideFloats) {
+  MeshBounds bounds = {glm::vec3(0.0f), glm::vec3(0.0f), 0.0f};
+  for (size_t v = 0; v < vertexCount; v++) {
+    const float *p = vertices + v * strideFloats;
+    glm::vec3 position(p[0], p[1], p[2]);
+    bounds.min = v ? glm::min(bounds.min, position) : position;
+    bounds.max = v ? glm::max(bounds.max, position) : position;
+    bounds.radius = max(bounds.radius, glm::length(position));
+  }
+  return bounds;
+}
+
+// Writing
+
+bool writeMeshCache(const string &path, const QuantizedVertices &vertices,
+                    const vector<uint32_t> &indices,
+                    const vector<MeshLod> &lods, const MeshBounds &bounds,
+                    uint64_t sourceHash, uint64_t sourceSize) {
+  MeshCacheHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, meshCacheMagic, sizeof(meshCacheMagic));
+  header.version = MeshCache::version;
+  header.headerBytes = sizeof(MeshCacheHeader);
+  header.sourceHash = sourceHash;
+  header.sourceSize = sourceSize;
+
+  header.positionFormat = vertices.format.position;
+  header.texCoordFormat = vertices.format.texCoord;
+  header.normalFormat = vertices.format.normal;
+  header.vertexStride = (uint32_t)vertices.stride;
+  header.positionOffset = vertices.positionOffset;
+  header.texCoordOffset = vertices.texCoordOffset;
+  header.normalOffset = vertices.normalOffset;
+  header.vertexCount = (uint32_t)vertices.vertexCount;
+  header.indexCount = (uint32_t)indices.size();
+  header.lodCount = (uint32_t)lods.size();
+  for (int i = 0; i < 3; i++) {
+    header.positionScale[i] = vertices.positionScale[i];
+    header.positionBias[i] = vertices.positionBias[i];
+    header.boundsMin[i] = bounds.min[i];
+    header.boundsMax[i] = bounds.max[i];
+  }
+  header.radius = bounds.radius;
+
+  const size_t alignment = MeshCache::cacheAlignment;
+  header.vertexDataOffset = alignUp(sizeof(header), alignment);
+  header.indexDataOffset =
+      alignUp(header.vertexDataOffset + vertices.data.size(), alignment);
+  header.lodTableOffset = alignUp(
+      header.indexDataOffset + indices.size() * sizeof(uint32_t), alignment);
+
+  // Written next to the real path and renamed over it, so a reader never
+  // maps a half-written cache
+  string temporary = path + ".tmp";
+  {
+    ofstream out(temporary, ios::binary);
+    if (!out.is_open())
+      return false;
+
+    static const char zeros[alignment] = {};
+    uint64_t written = 0;
+    auto write = [&](const void *data, size_t bytes) {
+      out.write((const char *)data, bytes);
+      written += bytes;
+    };
+    auto padTo = [&](uint64_t offset) {
+      out.write(zeros, offset - written);
+      written = offset;
+    };
+
+    write(&header, sizeof(header));
+    padTo(header.vertexDataOffset);
+    write(vertices.data.data(), vertices.data.size());
+    padTo(header.indexDataOffset);
+    write(indices.data(), indices.size() * sizeof(uint32_t));
+    padTo(header.lodTableOffset);
+    write(lods.data(), lods.size() * sizeof(MeshLod));
+
+    if (!out.good()) {
+      out.close();
+      remove(temporary.c_str());
+      return false;
+    }
+  }
+  return rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+// Loading
+
+static bool upToDate(const MeshCache &cache, const VertexFormat &format,
+                     uint64_t sourceHash, uint64_t sourceSize) {
+  VertexFormat cached = cache.format();
+  return cache.header->sourceHash == sourceHash &&
+         cache.header->sourceSize == sourceSize &&
+         cached.position == format.position &&
+         cached.texCoord == format.texCoord && cached.normal == format.normal;
+}
+
+static bool buildMeshCache(const MappedFile &source, const string &sourcePath,
+                           const string &cachePath, const VertexFormat &format,
+                           uint64_t sourceHash) {
+  ImportedMesh mesh;
+  if (!importMesh(sourcePath, mesh))
+    return false;
+
+  FloatVertexLayout layout;
+  vector<float> interleaved = mesh.interleave(layout);
+  vector<unsigned char> vertices((unsigned char *)interleaved.data(),
+                                 (unsigned char *)(interleaved.data() +
+                                                   interleaved.size()));
+  vector<uint32_t> indices;
+  indices.swap(mesh.indices);
+  size_t vertexCount = mesh.positions.size();
+  mesh.clear();
+
+  size_t stride = layout.stride * sizeof(float);
+  vertexCount = optimizeMesh(vertices, indices, vertexCount, stride);
+
+  const float *floats = (const float *)vertices.data();
+  MeshBounds bounds = computeMeshBounds(floats, vertexCount, layout.stride);
+  vector<MeshLod> lods =
+      buildLods(indices, floats, vertexCount, layout.stride);
+  QuantizedVertices packed =
+      quantizeVertices(floats, vertexCount, layout, format);
+
+  if (!writeMeshCache(cachePath, packed, indices, lods, bounds, sourceHash,
+                      source.size)) {
+    cout << "ERROR::MESH::CACHE_NOT_WRITTEN " << cachePath << endl;
+    return false;
+  }
+  return true;
+}
+
+bool loadCachedMesh(const string &sourcePath, const VertexFormat &format,
+                    MeshCache &cache, bool *rebuilt) {
+  string cachePath = sourcePath + ".meshcache";
+  if (rebuilt)
+    *rebuilt = false;
+
+  // Without the source, whatever cache there is will have to do
+  MappedFile source;
+  if (!source.open(sourcePath))
+    return cache.open(cachePath);
+
+  uint64_t sourceHash = hashFileContents(source.data, source.size);
+  if (cache.open(cachePath) &&
+      upToDate(cache, format, sourceHash, source.size))
+    return true;
+  cache.close();
+
+  if (rebuilt)
+    *rebuilt = true;
+  return buildMeshCache(source, sourcePath, cachePath, format, sourceHash) &&
+         cache.open(cachePath);
+}
+
+// Upload
+
+void uploadStaticBuffer(GLenum target, const void *data, size_t bytes) {
+  if (GLAD_GL_ARB_buffer_storage && glad_glBufferStorage)
+    glBufferStorage(target, bytes, data, 0);
+  else
+    glBufferData(target, bytes, data, GL_STATIC_DRAW);
+}
@@ -0,0 +1,118 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include <glad/glad.h> // include glad to get all the required OpenGL headers
+
+#include "mesh/mapped_file.h"
+#include "mesh/mesh_simplifier.h"
+#include "mesh/vertex_format.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Imported meshes, stored exactly as the GPU takes them so that loading is a
+ mapping and two buffer uploads straight from it. All sections start on a
+ cacheAlignment boundary:
+
+   MeshCacheHeader
+   vertex data      vertexCount * vertexStride bytes, as quantizeVertices packs
+   index data       uint32_t, every LOD back to back
+   LOD table        lodCount MeshLods, finest first
+
+ The header records the hash and size of the source file, and the settings
+ the cache was built with. Any mismatch, or a different version, makes the
+ cache stale. Everything is in the byte order of the machine that wrote it.
+ */
+struct MeshCacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t headerBytes;
+
+  uint64_t sourceHash;
+  uint64_t sourceSize;
+
+  uint32_t positionFormat;
+  uint32_t texCoordFormat;
+  uint32_t normalFormat;
+  uint32_t vertexStride;
+  int32_t positionOffset;
+  int32_t texCoordOffset;
+  int32_t normalOffset;
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t lodCount;
+
+  float positionScale[3];
+  float positionBias[3];
+  float boundsMin[3];
+  float boundsMax[3];
+  // About the origin, which is what instances rotate around
+  float radius;
+  uint32_t padding;
+
+  uint64_t vertexDataOffset;
+  uint64_t indexDataOffset;
+  uint64_t lodTableOffset;
+};
+
+class MeshCache {
+public:
+  static constexpr uint32_t version = 3;
+  static constexpr size_t cacheAlignment = 256;
+
+  const MeshCacheHeader *header;
+
+  MeshCache();
+
+  // Maps and validates a cache file. Staleness is up to the caller.
+  bool open(const string &path);
+  void close();
+
+  const void *vertexData() const;
+  size_t vertexBytes() const;
+  const uint32_t *indexData() const;
+  size_t indexBytes() const;
+  const MeshLod *lods() const;
+
+  VertexFormat format() const;
+  // The packed layout, for QuantizedVertices::setAttributes; data is empty
+  QuantizedVertices layout() const;
+
+private:
+  MappedFile file;
+};
+
+struct MeshBounds {
+  glm::vec3 min;
+  glm::vec3 max;
+  float radius; // About the origin
+};
+
+// Of the first three floats of each vertex
+MeshBounds computeMeshBounds(const float *vertices, size_t vertexCount,
+                             size_t strideFloats);
+
+// Content hash of a whole file, computed in parallel by jobPool
+uint64_t hashFileContents(const unsigned char *data, size_t size);
+
+bool writeMeshCache(const string &path, const QuantizedVertices &vertices,
+                    const vector<uint32_t> &indices,
+                    const vector<MeshLod> &lods, const MeshBounds &bounds,
+                    uint64_t sourceHash, uint64_t sourceSize);
+
+/* Opens `<sourcePath>.meshcache` if it is up to date with the source file
+ and `format`. Otherwise the source is imported, optimized, simplified into
+ its levels of detail, packed and written out again first. Returns false if neither works.
+ */
+bool loadCachedMesh(const string &sourcePath, const VertexFormat &format,
+                    MeshCache &cache, bool *rebuilt = NULL);
+
+// Fills the bound buffer of `target` with data that never changes:
+// immutable storage where GL_ARB_buffer_storage is supported
+void uploadStaticBuffer(GLenum target, const void *data, size_t bytes);
+
+#endif
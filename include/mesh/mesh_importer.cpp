@@ -0,0 +1,830 @@
+#include "mesh_importer.h"
+
+#include "jobs/job_pool.h"
+#include "mesh/mapped_file.h"
+#include "mesh/mesh_optimizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <math.h>
+#include <string.h>
+
+void ImportedMesh::clear() {
+  positions.clear();
+  texCoords.clear();
+  normals.clear();
+  indices.clear();
+}
+
+vector<float> ImportedMesh::interleave(FloatVertexLayout &layout) const {
+  bool hasTexCoords = !texCoords.empty();
+  bool hasNormals = !normals.empty();
+  layout.position = 0;
+  layout.texCoord = hasTexCoords ? 3 : -1;
+  layout.normal = hasNormals ? (hasTexCoords ? 5 : 3) : -1;
+  layout.stride = 3 + (hasTexCoords ? 2 : 0) + (hasNormals ? 3 : 0);
+
+  vector<float> result(positions.size() * layout.stride);
+  for (size_t v = 0; v < positions.size(); v++) {
+    float *out = &result[v * layout.stride];
+    memcpy(out, &positions[v], sizeof(glm::vec3));
+    if (hasTexCoords)
+      memcpy(out + layout.texCoord, &texCoords[v], sizeof(glm::vec2));
+    if (hasNormals)
+      memcpy(out + layout.normal, &normals[v], sizeof(glm::vec3));
+  }
+  return result;
+}
+
+static bool endsWith(const string &text, const char *suffix) {
+  size_t length = strlen(suffix);
+  if (text.size() < length)
+    return false;
+  for (size_t i = 0; i < length; i++) {
+    if (tolower(text[text.size() - length + i]) != suffix[i])
+      return false;
+  }
+  return true;
+}
+
+bool importMesh(const string &path, ImportedMesh &mesh) {
+  mesh.clear();
+
+  MappedFile file;
+  if (!file.open(path)) {
+    cout << "ERROR::MESH::FILE_NOT_SUCCESFULLY_READ " << path << endl;
+    return false;
+  }
+
+  bool imported = false;
+  if (endsWith(path, ".ply"))
+    imported = importPly(file.data, file.size, mesh);
+  else
+    imported = importObj(file.data, file.size, mesh);
+
+  if (!imported) {
+    cout << "ERROR::MESH::IMPORT_FAILED " << path << endl;
+    mesh.clear();
+  }
+  return imported;
+}
+
+// Number parsing. strtof needs a terminated string and is locale dependent,
+// and iostreams are far slower still.
+
+namespace {
+
+inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+inline void skipSpaces(const char *&p, const char *end) {
+  while (p < end && isSpace(*p))
+    p++;
+}
+
+const double powersOf10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                             1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                             1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Decimal or scientific notation. The first 19 significant digits are kept
+// exactly, and scaling by an exact power of ten in double precision leaves
+// the float result correctly rounded in all but pathological cases.
+bool parseFloat(const char *&p, const char *end, float &value) {
+  skipSpaces(p, end);
+
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+
+  uint64_t mantissa = 0;
+  int digits = 0, exponent = 0;
+  bool any = false;
+  for (; p < end && isDigit(*p); p++) {
+    any = true;
+    if (digits < 19) {
+      mantissa = mantissa * 10 + (*p - '0');
+      digits += mantissa != 0;
+    } else
+      exponent++;
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && isDigit(*p); p++) {
+      any = true;
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (*p - '0');
+        digits += mantissa != 0;
+        exponent--;
+      }
+    }
+  }
+  if (!any)
+    return false;
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    p++;
+    bool negativeExponent = false;
+    if (p < end && (*p == '-' || *p == '+'))
+      negativeExponent = *p++ == '-';
+    int e = 0;
+    for (; p < end && isDigit(*p); p++)
+      e = min(e * 10 + (*p - '0'), 1000);
+    exponent += negativeExponent ? -e : e;
+  }
+
+  double result = (double)mantissa;
+  if (exponent < 0)
+    result = exponent >= -22 ? result / powersOf10[-exponent]
+                             : result * pow(10.0, exponent);
+  else if (exponent > 0)
+    result = exponent <= 22 ? result * powersOf10[exponent]
+                            : result * pow(10.0, exponent);
+  value = (float)(negative ? -result : result);
+  return true;
+}
+
+bool parseInt(const char *&p, const char *end, int64_t &value) {
+  bool negative = false;
+  if (p < end && (*p == '-' || *p == '+'))
+    negative = *p++ == '-';
+  if (p >= end || !isDigit(*p))
+    return false;
+
+  int64_t result = 0;
+  for (; p < end && isDigit(*p); p++)
+    result = min(result * 10 + (*p - '0'), (int64_t)1 << 40);
+  value = negative ? -result : result;
+  return true;
+}
+
+} // namespace
+
+// OBJ
+
+namespace {
+
+struct ObjCorner {
+  uint32_t position, texCoord, normal;
+};
+
+const uint32_t objMissing = 0xFFFFFFFF;
+
+/* Chunks are parsed twice. The first pass only counts v, vt and vn lines, so
+ the second knows where each chunk's attributes go in the merged arrays. It
+ then writes them there directly and can resolve relative (negative) face
+ indices as it goes.
+ */
+struct ObjChunk {
+  const char *begin, *end;
+  size_t positions, texCoords, normals, faces;
+  vector<ObjCorner> corners;
+  bool anyTexCoord, anyNormal;
+  // Every corner uses the same index for all its attributes
+  bool matching;
+  bool failed;
+};
+
+enum ObjLine { ObjPosition, ObjTexCoord, ObjNormal, ObjFace, ObjOther };
+
+inline ObjLine objLineType(const char *&p, const char *end) {
+  skipSpaces(p, end);
+  if (end - p < 2)
+    return ObjOther;
+  if (p[0] == 'v') {
+    if (isSpace(p[1])) {
+      p += 2;
+      return ObjPosition;
+    }
+    if (p[1] == 't' && end - p > 2 && isSpace(p[2])) {
+      p += 3;
+      return ObjTexCoord;
+    }
+    if (p[1] == 'n' && end - p > 2 && isSpace(p[2])) {
+      p += 3;
+      return ObjNormal;
+    }
+  } else if (p[0] == 'f' && isSpace(p[1])) {
+    p += 2;
+    return ObjFace;
+  }
+  return ObjOther;
+}
+
+inline const char *lineEnd(const char *p, const char *end) {
+  const char *newline = (const char *)memchr(p, '\n', end - p);
+  return newline ? newline : end;
+}
+
+void countObjChunk(ObjChunk &chunk) {
+  chunk.positions = chunk.texCoords = chunk.normals = chunk.faces = 0;
+  for (const char *line = chunk.begin; line < chunk.end;) {
+    const char *next = lineEnd(line, chunk.end);
+    switch (objLineType(line, next)) {
+    case ObjPosition:
+      chunk.positions++;
+      break;
+    case ObjTexCoord:
+      chunk.texCoords++;
+      break;
+    case ObjNormal:
+      chunk.normals++;
+      break;
+    case ObjFace:
+      chunk.faces++;
+      break;
+    default:
+      break;
+    }
+    line = next + 1;
+  }
+}
+
+// OBJ indices are 1-based, or relative to the end of what is defined so far
+inline uint32_t resolveObjIndex(int64_t index, size_t defined, size_t total) {
+  int64_t resolved = index > 0 ? index - 1 : (int64_t)defined + index;
+  if (index == 0 || resolved < 0 || resolved >= (int64_t)total)
+    return objMissing - 1;
+  return (uint32_t)resolved;
+}
+
+bool parseObjCorner(const char *&p, const char *end, const size_t *defined,
+                    const size_t *totals, ObjCorner &corner) {
+  int64_t index;
+  if (!parseInt(p, end, index))
+    return false;
+  corner.position = resolveObjIndex(index, defined[0], totals[0]);
+  corner.texCoord = corner.normal = objMissing;
+
+  if (p < end && *p == '/') {
+    p++;
+    if (p < end && *p != '/') {
+      if (!parseInt(p, end, index))
+        return false;
+      corner.texCoord = resolveObjIndex(index, defined[1], totals[1]);
+    }
+    if (p < end && *p == '/') {
+      p++;
+      if (!parseInt(p, end, index))
+        return false;
+      corner.normal = resolveObjIndex(index, defined[2], totals[2]);
+    }
+  }
+
+  // Out of range indices were marked as objMissing - 1
+  return corner.position != objMissing - 1 &&
+         corner.texCoord != objMissing - 1 && corner.normal != objMissing - 1;
+}
+
+void parseObjChunk(ObjChunk &chunk, ImportedMesh &mesh, const size_t *totals) {
+  size_t defined[3] = {chunk.positions, chunk.texCoords, chunk.normals};
+  chunk.anyTexCoord = chunk.anyNormal = false;
+  chunk.matching = true;
+  chunk.failed = false;
+  chunk.corners.reserve(chunk.faces * 3);
+
+  vector<ObjCorner> polygon;
+  for (const char *line = chunk.begin; line < chunk.end && !chunk.failed;) {
+    const char *next = lineEnd(line, chunk.end);
+    const char *p = line;
+    bool ok = true;
+
+    switch (objLineType(p, next)) {
+    case ObjPosition: {
+      glm::vec3 &position = mesh.positions[defined[0]++];
+      ok = parseFloat(p, next, position.x) && parseFloat(p, next, position.y) &&
+           parseFloat(p, next, position.z);
+      break;
+    }
+    case ObjTexCoord: {
+      glm::vec2 &texCoord = mesh.texCoords[defined[1]++];
+      ok = parseFloat(p, next, texCoord.x);
+      // The v coordinate is optional
+      const char *rest = p;
+      if (!parseFloat(p, next, texCoord.y)) {
+        p = rest;
+        texCoord.y = 0.0f;
+      }
+      break;
+    }
+    case ObjNormal: {
+      glm::vec3 &normal = mesh.normals[defined[2]++];
+      ok = parseFloat(p, next, normal.x) && parseFloat(p, next, normal.y) &&
+           parseFloat(p, next, normal.z);
+      break;
+    }
+    case ObjFace: {
+      polygon.clear();
+      for (;;) {
+        skipSpaces(p, next);
+        if (p >= next || *p == '#')
+          break;
+        ObjCorner corner;
+        if (!parseObjCorner(p, next, defined, totals, corner)) {
+          ok = false;
+          break;
+        }
+        chunk.anyTexCoord |= corner.texCoord != objMissing;
+        chunk.anyNormal |= corner.normal != objMissing;
+        chunk.matching &=
+            (corner.texCoord == objMissing ||
+             corner.texCoord == corner.position) &&
+            (corner.normal == objMissing || corner.normal == corner.position);
+        polygon.push_back(corner);
+      }
+      if (!ok || polygon.size() < 3) {
+        ok = false;
+        break;
+      }
+      for (size_t i = 2; i < polygon.size(); i++) {
+        chunk.corners.push_back(polygon[0]);
+        chunk.corners.push_back(polygon[i - 1]);
+        chunk.corners.push_back(polygon[i]);
+      }
+      break;
+    }
+    default:
+      break;
+    }
+
+    chunk.failed = !ok;
+    line = next + 1;
+  }
+}
+
+} // namespace
+
+bool importObj(const unsigned char *data, size_t size, ImportedMesh &mesh) {
+  mesh.clear();
+  const char *text = (const char *)data;
+  const char *textEnd = text + size;
+
+  // Line-aligned chunks, a few per worker so uneven ones even out
+  const size_t minChunkBytes = 1 << 20;
+  size_t chunkCount = min(max(size / minChunkBytes, (size_t)1),
+                          (size_t)jobPool.workerCount() * 4);
+  vector<ObjChunk> chunks(chunkCount);
+  const char *start = text;
+  for (size_t i = 0; i < chunkCount; i++) {
+    const char *end = max(text + size * (i + 1) / chunkCount, start);
+    if (end < textEnd) {
+      end = lineEnd(end, textEnd);
+      end += end < textEnd;
+    }
+    chunks[i].begin = start;
+    chunks[i].end = end;
+    start = end;
+  }
+
+  jobPool.parallelFor(chunkCount, 1, [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; i++)
+      countObjChunk(chunks[i]);
+  });
+
+  // Turn the counts into where each chunk's attributes start
+  size_t totals[3] = {0, 0, 0};
+  for (ObjChunk &chunk : chunks) {
+    size_t counts[3] = {chunk.positions, chunk.texCoords, chunk.normals};
+    chunk.positions = totals[0];
+    chunk.texCoords = totals[1];
+    chunk.normals = totals[2];
+    for (int i = 0; i < 3; i++)
+      totals[i] += counts[i];
+  }
+  if (totals[0] >= objMissing - 1)
+    return false;
+  mesh.positions.resize(totals[0]);
+  mesh.texCoords.resize(totals[1]);
+  mesh.normals.resize(totals[2]);
+
+  jobPool.parallelFor(chunkCount, 1, [&](size_t begin, size_t end, unsigned) {
+    for (size_t i = begin; i < end; i++)
+      parseObjChunk(chunks[i], mesh, totals);
+  });
+
+  size_t cornerCount = 0;
+  bool anyTexCoord = false, anyNormal = false, matching = true;
+  for (const ObjChunk &chunk : chunks) {
+    if (chunk.failed)
+      return false;
+    cornerCount += chunk.corners.size();
+    anyTexCoord |= chunk.anyTexCoord;
+    anyNormal |= chunk.anyNormal;
+    matching &= chunk.matching;
+  }
+  if (cornerCount == 0)
+    return false;
+
+  // Scan meshes and most exporters have no separate attribute indices, so
+  // the file's vertices are the mesh's
+  if (matching &&
+      (!anyTexCoord || mesh.texCoords.size() == mesh.positions.size()) &&
+      (!anyNormal || mesh.normals.size() == mesh.positions.size())) {
+    if (!anyTexCoord)
+      mesh.texCoords.clear();
+    if (!anyNormal)
+      mesh.normals.clear();
+    mesh.indices.resize(cornerCount);
+    size_t offset = 0;
+    for (const ObjChunk &chunk : chunks) {
+      for (size_t i = 0; i < chunk.corners.size(); i++)
+        mesh.indices[offset + i] = chunk.corners[i].position;
+      offset += chunk.corners.size();
+    }
+    return true;
+  }
+
+  // Every distinct position/texCoord/normal combination becomes a vertex
+  vector<ObjCorner> corners;
+  corners.reserve(cornerCount);
+  for (const ObjChunk &chunk : chunks)
+    corners.insert(corners.end(), chunk.corners.begin(), chunk.corners.end());
+
+  vector<uint32_t> remap;
+  size_t vertexCount = generateVertexRemap(
+      remap, NULL, 0, corners.data(), corners.size(), sizeof(ObjCorner));
+
+  vector<glm::vec3> positions(vertexCount), normals;
+  vector<glm::vec2> texCoords;
+  if (anyTexCoord)
+    texCoords.assign(vertexCount, glm::vec2(0.0f));
+  if (anyNormal)
+    normals.assign(vertexCount, glm::vec3(0.0f));
+  mesh.indices.resize(cornerCount);
+  for (size_t i = 0; i < cornerCount; i++) {
+    const ObjCorner &corner = corners[i];
+    uint32_t vertex = remap[i];
+    mesh.indices[i] = vertex;
+    positions[vertex] = mesh.positions[corner.position];
+    if (anyTexCoord && corner.texCoord != objMissing)
+      texCoords[vertex] = mesh.texCoords[corner.texCoord];
+    if (anyNormal && corner.normal != objMissing)
+      normals[vertex] = mesh.normals[corner.normal];
+  }
+  mesh.positions.swap(positions);
+  mesh.texCoords.swap(texCoords);
+  mesh.normals.swap(normals);
+  return true;
+}
+
+// PLY
+
+namespace {
+
+enum PlyType { PlyInt8, PlyUint8, PlyInt16, PlyUint16, PlyInt32, PlyUint32,
+               PlyFloat32, PlyFloat64, PlyInvalid };
+
+PlyType plyType(const string &name) {
+  if (name == "char" || name == "int8")
+    return PlyInt8;
+  if (name == "uchar" || name == "uint8")
+    return PlyUint8;
+  if (name == "short" || name == "int16")
+    return PlyInt16;
+  if (name == "ushort" || name == "uint16")
+    return PlyUint16;
+  if (name == "int" || name == "int32")
+    return PlyInt32;
+  if (name == "uint" || name == "uint32")
+    return PlyUint32;
+  if (name == "float" || name == "float32")
+    return PlyFloat32;
+  if (name == "double" || name == "float64")
+    return PlyFloat64;
+  return PlyInvalid;
+}
+
+const size_t plyTypeBytes[] = {1, 1, 2, 2, 4, 4, 4, 8, 0};
+
+template <typename T> inline T readPly(const unsigned char *p, bool swap) {
+  unsigned char bytes[sizeof(T)];
+  memcpy(bytes, p, sizeof(T));
+  if (swap)
+    reverse(bytes, bytes + sizeof(T));
+  T value;
+  memcpy(&value, bytes, sizeof(T));
+  return value;
+}
+
+inline double readPlyScalar(const unsigned char *p, PlyType type, bool swap) {
+  switch (type) {
+  case PlyInt8:
+    return (int8_t)*p;
+  case PlyUint8:
+    return *p;
+  case PlyInt16:
+    return readPly<int16_t>(p, swap);
+  case PlyUint16:
+    return readPly<uint16_t>(p, swap);
+  case PlyInt32:
+    return readPly<int32_t>(p, swap);
+  case PlyUint32:
+    return readPly<uint32_t>(p, swap);
+  case PlyFloat32:
+    return readPly<float>(p, swap);
+  case PlyFloat64:
+    return readPly<double>(p, swap);
+  default:
+    return 0.0;
+  }
+}
+
+struct PlyProperty {
+  string name;
+  PlyType type;
+  // Lists: type is the element type, countType the length's
+  bool list;
+  PlyType countType;
+  size_t offset; // Within the element, for fixed-size elements
+};
+
+struct PlyElement {
+  string name;
+  size_t count;
+  vector<PlyProperty> properties;
+  // 0 when the element has lists
+  size_t stride;
+};
+
+// Size of one property value starting at p, or 0 if it runs past the end
+size_t plyPropertyBytes(const PlyProperty &property, const unsigned char *p,
+                        const unsigned char *end, bool swap) {
+  size_t available = end - p;
+  if (!property.list)
+    return available >= plyTypeBytes[property.type]
+               ? plyTypeBytes[property.type]
+               : 0;
+
+  size_t countBytes = plyTypeBytes[property.countType];
+  if (available < countBytes)
+    return 0;
+  size_t length = (size_t)readPlyScalar(p, property.countType, swap);
+  if ((available - countBytes) / plyTypeBytes[property.type] < length)
+    return 0;
+  return countBytes + length * plyTypeBytes[property.type];
+}
+
+// Size of one element record starting at p, or 0 if it runs past the end
+size_t plyRecordBytes(const PlyElement &element, const unsigned char *p,
+                      const unsigned char *end, bool swap) {
+  if (element.stride)
+    return (size_t)(end - p) >= element.stride ? element.stride : 0;
+
+  const unsigned char *start = p;
+  for (const PlyProperty &property : element.properties) {
+    size_t bytes = plyPropertyBytes(property, p, end, swap);
+    if (!bytes)
+      return 0;
+    p += bytes;
+  }
+  return p - start;
+}
+
+int findPlyProperty(const PlyElement &element, const char *name) {
+  for (size_t i = 0; i < element.properties.size(); i++) {
+    if (element.properties[i].name == name && !element.properties[i].list)
+      return (int)i;
+  }
+  return -1;
+}
+
+bool readPlyVertices(const PlyElement &element, const unsigned char *data,
+                     bool swap, ImportedMesh &mesh) {
+  int x = findPlyProperty(element, "x"), y = findPlyProperty(element, "y"),
+      z = findPlyProperty(element, "z");
+  int nx = findPlyProperty(element, "nx"), ny = findPlyProperty(element, "ny"),
+      nz = findPlyProperty(element, "nz");
+  int u = findPlyProperty(element, "u"), v = findPlyProperty(element, "v");
+  if (u < 0 || v < 0) {
+    u = findPlyProperty(element, "s");
+    v = findPlyProperty(element, "t");
+  }
+  if (x < 0 || y < 0 || z < 0 || !element.stride)
+    return false;
+
+  bool hasNormals = nx >= 0 && ny >= 0 && nz >= 0;
+  bool hasTexCoords = u >= 0 && v >= 0;
+  mesh.positions.resize(element.count);
+  if (hasNormals)
+    mesh.normals.resize(element.count);
+  if (hasTexCoords)
+    mesh.texCoords.resize(element.count);
+
+  const vector<PlyProperty> &properties = element.properties;
+  auto read = [&](const unsigned char *record, int property) {
+    return (float)readPlyScalar(record + properties[property].offset,
+                                properties[property].type, swap);
+  };
+
+  jobPool.parallelFor(
+      element.count, 1 << 16, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+          const unsigned char *record = data + i * element.stride;
+          mesh.positions[i] =
+              glm::vec3(read(record, x), read(record, y), read(record, z));
+          if (hasNormals)
+            mesh.normals[i] =
+                glm::vec3(read(record, nx), read(record, ny), read(record, nz));
+          if (hasTexCoords)
+            mesh.texCoords[i] = glm::vec2(read(record, u), read(record, v));
+        }
+      });
+  return true;
+}
+
+bool readPlyFaces(const PlyElement &element, const unsigned char *data,
+                  const unsigned char *end, bool swap, size_t vertexCount,
+                  ImportedMesh &mesh) {
+  int list = -1;
+  for (size_t i = 0; i < element.properties.size(); i++) {
+    const string &name = element.properties[i].name;
+    if (element.properties[i].list &&
+        (name == "vertex_indices" || name == "vertex_index"))
+      list = (int)i;
+  }
+  if (list < 0)
+    return false;
+
+  const PlyProperty &indices = element.properties[list];
+  size_t countBytes = plyTypeBytes[indices.countType];
+  size_t indexBytes = plyTypeBytes[indices.type];
+
+  // Nearly every file is all triangles with nothing else per face, which
+  // makes faces fixed-size records that can be read in parallel
+  size_t triangleBytes = countBytes + 3 * indexBytes;
+  if (element.properties.size() == 1 &&
+      (size_t)(end - data) / triangleBytes >= element.count) {
+    mesh.indices.resize(element.count * 3);
+    atomic<bool> allTriangles(true);
+    atomic<bool> outOfRange(false);
+    jobPool.parallelFor(
+        element.count, 1 << 16, [&](size_t begin, size_t last, unsigned) {
+          for (size_t i = begin; i < last && allTriangles; i++) {
+            const unsigned char *record = data + i * triangleBytes;
+            if (readPlyScalar(record, indices.countType, swap) != 3.0) {
+              allTriangles = false;
+              break;
+            }
+            for (int c = 0; c < 3; c++) {
+              double index = readPlyScalar(record + countBytes + c * indexBytes,
+                                           indices.type, swap);
+              if (index < 0.0 || index >= vertexCount)
+                outOfRange = true;
+              mesh.indices[i * 3 + c] = (uint32_t)index;
+            }
+          }
+        });
+    if (allTriangles)
+      return !outOfRange;
+    // Records past the first polygon were read misaligned, so neither the
+    // indices nor the range check from this pass mean anything
+    mesh.indices.clear();
+  }
+
+  // Anything else is walked one face at a time, fanning polygons
+  const unsigned char *p = data;
+  for (size_t i = 0; i < element.count; i++) {
+    size_t recordBytes = plyRecordBytes(element, p, end, swap);
+    if (!recordBytes)
+      return false;
+
+    const unsigned char *field = p;
+    for (int k = 0; k < list; k++)
+      field += plyPropertyBytes(element.properties[k], field, end, swap);
+
+    size_t length = (size_t)readPlyScalar(field, indices.countType, swap);
+    field += countBytes;
+    for (size_t c = 2; c < length; c++) {
+      size_t corners[3] = {0, c - 1, c};
+      for (size_t corner : corners) {
+        double index =
+            readPlyScalar(field + corner * indexBytes, indices.type, swap);
+        if (index < 0.0 || index >= vertexCount)
+          return false;
+        mesh.indices.push_back((uint32_t)index);
+      }
+    }
+    p += recordBytes;
+  }
+  return true;
+}
+
+} // namespace
+
+bool importPly(const unsigned char *data, size_t size, ImportedMesh &mesh) {
+  mesh.clear();
+  const unsigned char *end = data + size;
+
+  // The header is text, one declaration per line, up to end_header
+  const char *text = (const char *)data;
+  const char *header = text;
+  vector<PlyElement> elements;
+  bool binary = false, swap = false;
+  const unsigned char *body = NULL;
+  bool first = true;
+  while (header < (const char *)end) {
+    const char *next = lineEnd(header, (const char *)end);
+    string line(header, next);
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    header = next + 1;
+
+    vector<string> words;
+    for (size_t i = 0; i < line.size();) {
+      size_t space = line.find(' ', i);
+      if (space == string::npos)
+        space = line.size();
+      if (space > i)
+        words.push_back(line.substr(i, space - i));
+      i = space + 1;
+    }
+
+    if (first) {
+      if (line != "ply")
+        return false;
+      first = false;
+    } else if (words.empty() || words[0] == "comment" ||
+               words[0] == "obj_info") {
+      continue;
+    } else if (words[0] == "format" && words.size() >= 2) {
+      binary = words[1] != "ascii";
+      bool bigEndian = words[1] == "binary_big_endian";
+      uint16_t probe = 1;
+      bool hostBigEndian = *(unsigned char *)&probe == 0;
+      swap = bigEndian != hostBigEndian;
+    } else if (words[0] == "element" && words.size() >= 3) {
+      elements.push_back(
+          PlyElement{words[1], (size_t)strtoull(words[2].c_str(), NULL, 10),
+                     {}, 0});
+    } else if (words[0] == "property" && !elements.empty()) {
+      PlyProperty property;
+      property.list = words.size() >= 5 && words[1] == "list";
+      if (property.list) {
+        property.countType = plyType(words[2]);
+        property.type = plyType(words[3]);
+        property.name = words[4];
+      } else if (words.size() >= 3) {
+        property.countType = PlyInvalid;
+        property.type = plyType(words[1]);
+        property.name = words[2];
+      } else
+        return false;
+      if (property.type == PlyInvalid ||
+          (property.list && property.countType == PlyInvalid))
+        return false;
+      elements.back().properties.push_back(property);
+    } else if (words[0] == "end_header") {
+      body = (const unsigned char *)header;
+      break;
+    }
+  }
+  if (!body || body > end) {
+    cout << "ERROR::MESH::PLY_HEADER_INCOMPLETE" << endl;
+    return false;
+  }
+  if (!binary) {
+    cout << "ERROR::MESH::PLY_ASCII_NOT_SUPPORTED" << endl;
+    return false;
+  }
+
+  for (PlyElement &element : elements) {
+    size_t offset = 0;
+    for (PlyProperty &property : element.properties) {
+      property.offset = offset;
+      offset += plyTypeBytes[property.type];
+    }
+    bool hasList = false;
+    for (const PlyProperty &property : element.properties)
+      hasList |= property.list;
+    element.stride = hasList ? 0 : offset;
+  }
+
+  size_t vertexCount = 0;
+  bool haveVertices = false, haveFaces = false;
+  const unsigned char *p = body;
+  for (const PlyElement &element : elements) {
+    if (element.name == "vertex" && !haveVertices) {
+      if ((size_t)(end - p) / max(element.stride, (size_t)1) < element.count ||
+          !readPlyVertices(element, p, swap, mesh))
+        return false;
+      vertexCount = element.count;
+      haveVertices = true;
+      p += element.count * element.stride;
+    } else if (element.name == "face" && !haveFaces) {
+      if (!haveVertices || !readPlyFaces(element, p, end, swap, vertexCount,
+                                         mesh))
+        return false;
+      // Nothing after the faces is needed
+      haveFaces = true;
+      break;
+    } else {
+      for (size_t i = 0; i < element.count; i++) {
+        size_t recordBytes = plyRecordBytes(element, p, end, swap);
+        if (!recordBytes)
+          return false;
+        p += recordBytes;
+      }
+    }
+  }
+
+  return haveVertices && haveFaces && !mesh.indices.empty();
+}
@@ -0,0 +1,43 @@
+#ifndef MESH_IMPORTER_H
+#define MESH_IMPORTER_H
+
+#include "mesh/vertex_format.h"
+
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// An indexed triangle mesh. texCoords and normals are either empty or have
+// one entry per position.
+struct ImportedMesh {
+  vector<glm::vec3> positions;
+  vector<glm::vec2> texCoords;
+  vector<glm::vec3> normals;
+  vector<uint32_t> indices;
+
+  void clear();
+
+  // Interleaved floats for the mesh optimizer and quantizeVertices, with the
+  // attributes the mesh has
+  vector<float> interleave(FloatVertexLayout &layout) const;
+};
+
+/* Wavefront OBJ (v, vt, vn and f; polygons are fanned into triangles) and
+ binary PLY (little or big endian; x/y/z, nx/ny/nz and u/v or s/t vertex
+ properties, and a vertex_indices list per face). Everything else in the
+ file is skipped.
+
+ The file is memory-mapped and split into line-aligned chunks that jobPool
+ parses in parallel, so import scales with the number of workers. Errors are
+ printed and leave the mesh empty.
+ */
+bool importMesh(const string &path, ImportedMesh &mesh);
+
+bool importObj(const unsigned char *data, size_t size, ImportedMesh &mesh);
+bool importPly(const unsigned char *data, size_t size, ImportedMesh &mesh);
+
+#endif
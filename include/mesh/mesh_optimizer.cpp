@@ -0,0 +1,387 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+static const uint32_t unused = 0xFFFFFFFF;
+
+// Deduplication
+
+static uint32_t hashBytes(const unsigned char *data, size_t size) {
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ data[i]) * 16777619u;
+  return hash;
+}
+
+size_t generateVertexRemap(vector<uint32_t> &remap, const uint32_t *indices,
+                           size_t indexCount, const void *vertices,
+                           size_t vertexCount, size_t stride) {
+  const unsigned char *bytes = (const unsigned char *)vertices;
+  remap.assign(vertexCount, unused);
+
+  // Open addressing, at most half full
+  size_t tableSize = 1;
+  while (tableSize < vertexCount * 2)
+    tableSize *= 2;
+  vector<uint32_t> table(tableSize, unused);
+
+  size_t uniqueCount = 0;
+  size_t visits = indices ? indexCount : vertexCount;
+  for (size_t i = 0; i < visits; i++) {
+    uint32_t vertex = indices ? indices[i] : (uint32_t)i;
+    if (remap[vertex] != unused)
+      continue;
+
+    const unsigned char *data = bytes + vertex * stride;
+    size_t slot = hashBytes(data, stride) & (tableSize - 1);
+    for (;;) {
+      uint32_t existing = table[slot];
+      if (existing == unused) {
+        table[slot] = vertex;
+        remap[vertex] = (uint32_t)uniqueCount++;
+        break;
+      }
+      if (memcmp(bytes + existing * stride, data, stride) == 0) {
+        remap[vertex] = remap[existing];
+        break;
+      }
+      slot = (slot + 1) & (tableSize - 1);
+    }
+  }
+  return uniqueCount;
+}
+
+vector<unsigned char> remapVertices(const vector<uint32_t> &remap,
+                                    size_t uniqueCount, const void *vertices,
+                                    size_t vertexCount, size_t stride) {
+  const unsigned char *bytes = (const unsigned char *)vertices;
+  vector<unsigned char> result(uniqueCount * stride);
+  for (size_t i = 0; i < vertexCount; i++) {
+    if (remap[i] != unused)
+      memcpy(&result[remap[i] * stride], bytes + i * stride, stride);
+  }
+  return result;
+}
+
+vector<uint32_t> remapIndices(const vector<uint32_t> &remap,
+                              const uint32_t *indices, size_t indexCount) {
+  vector<uint32_t> result(indexCount);
+  for (size_t i = 0; i < indexCount; i++)
+    result[i] = remap[indices ? indices[i] : i];
+  return result;
+}
+
+// Vertex cache optimization (Tom Forsyth, "Linear-speed vertex cache
+// optimisation", with his suggested constants)
+
+namespace {
+
+const int forsythCacheSize = 32;
+
+float vertexScore(int cachePosition, unsigned int remainingTriangles) {
+  if (remainingTriangles == 0)
+    return -1.0f;
+
+  float score = 0.0f;
+  if (cachePosition >= 0) {
+    // The last triangle's vertices get a fixed score, so it isn't just
+    // repeated with a different winding
+    if (cachePosition < 3)
+      score = 0.75f;
+    else
+      score = powf(1.0f - (float)(cachePosition - 3) / (forsythCacheSize - 3),
+                   1.5f);
+  }
+  // Finish off vertices with few triangles left, so they leave the cache
+  return score + 2.0f / sqrtf((float)remainingTriangles);
+}
+
+} // namespace
+
+vector<uint32_t> optimizeVertexCache(const vector<uint32_t> &indices,
+                                     size_t vertexCount) {
+  size_t triangleCount = indices.size() / 3;
+  vector<uint32_t> result;
+  result.reserve(triangleCount * 3);
+
+  // Triangles of each vertex, as ranges of one array. remaining[v] is how
+  // many of the range are not drawn yet; drawn ones are swapped to the end.
+  vector<uint32_t> remaining(vertexCount, 0);
+  for (uint32_t index : indices)
+    remaining[index]++;
+  vector<uint32_t> firstTriangle(vertexCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; v++)
+    firstTriangle[v + 1] = firstTriangle[v] + remaining[v];
+  vector<uint32_t> vertexTriangles(indices.size());
+  {
+    vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+      vertexTriangles[fill[indices[i]]++] = (uint32_t)(i / 3);
+  }
+
+  vector<int> cachePosition(vertexCount, -1);
+  vector<float> scores(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++)
+    scores[v] = vertexScore(-1, remaining[v]);
+
+  vector<float> triangleScores(triangleCount);
+  vector<bool> drawn(triangleCount, false);
+  for (size_t t = 0; t < triangleCount; t++)
+    triangleScores[t] = scores[indices[t * 3]] + scores[indices[t * 3 + 1]] +
+                        scores[indices[t * 3 + 2]];
+
+  uint32_t cache[forsythCacheSize + 3];
+  int cacheUsed = 0;
+
+  size_t cursor = 0; // For when nothing in the cache has triangles left
+  uint32_t best = unused;
+  for (size_t t = 0; t < triangleCount; t++) {
+    if (best == unused || triangleScores[t] > triangleScores[best])
+      best = (uint32_t)t;
+  }
+
+  while (best != unused) {
+    drawn[best] = true;
+    const uint32_t *corners = &indices[best * 3];
+    result.insert(result.end(), corners, corners + 3);
+
+    for (int c = 0; c < 3; c++) {
+      uint32_t v = corners[c];
+      uint32_t *list = &vertexTriangles[firstTriangle[v]];
+      uint32_t *position = find(list, list + remaining[v], best);
+      swap(*position, list[remaining[v] - 1]);
+      remaining[v]--;
+    }
+
+    // Move the triangle's vertices to the front of the LRU cache
+    uint32_t newCache[forsythCacheSize + 3];
+    int newUsed = 0;
+    for (int c = 0; c < 3; c++)
+      newCache[newUsed++] = corners[c];
+    for (int i = 0; i < cacheUsed; i++) {
+      uint32_t v = cache[i];
+      if (v != corners[0] && v != corners[1] && v != corners[2])
+        newCache[newUsed++] = v;
+    }
+
+    // Rescore everything that was or is in the cache; the ones that fell out
+    // are still in newCache past forsythCacheSize
+    for (int i = 0; i < newUsed; i++) {
+      uint32_t v = newCache[i];
+      cachePosition[v] = i < forsythCacheSize ? i : -1;
+      scores[v] = vertexScore(cachePosition[v], remaining[v]);
+    }
+
+    best = unused;
+    float bestScore = -1.0f;
+    for (int i = 0; i < newUsed; i++) {
+      uint32_t v = newCache[i];
+      const uint32_t *list = &vertexTriangles[firstTriangle[v]];
+      for (uint32_t k = 0; k < remaining[v]; k++) {
+        uint32_t t = list[k];
+        const uint32_t *tc = &indices[t * 3];
+        float score = scores[tc[0]] + scores[tc[1]] + scores[tc[2]];
+        triangleScores[t] = score;
+        if (score > bestScore) {
+          bestScore = score;
+          best = t;
+        }
+      }
+    }
+
+    cacheUsed = min(newUsed, forsythCacheSize);
+    memcpy(cache, newCache, cacheUsed * sizeof(uint32_t));
+
+    // Disconnected from everything in the cache: continue with the next
+    // triangle in input order
+    if (best == unused) {
+      while (cursor < triangleCount && drawn[cursor])
+        cursor++;
+      if (cursor < triangleCount)
+        best = (uint32_t)cursor;
+    }
+  }
+
+  return result;
+}
+
+// Overdraw
+
+namespace {
+
+struct FifoCache {
+  vector<uint32_t> timestamps;
+  uint32_t time;
+  unsigned int size;
+
+  FifoCache(size_t vertexCount, unsigned int cacheSize)
+      : timestamps(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+  // Whether the vertex had to be transformed
+  bool use(uint32_t v) {
+    if (time - timestamps[v] > size) {
+      timestamps[v] = time++;
+      return true;
+    }
+    return false;
+  }
+
+  void reset() { time += size + 1; }
+};
+
+const float *vertexPosition(const vector<unsigned char> &vertices, size_t v,
+                            size_t stride) {
+  return (const float *)&vertices[v * stride];
+}
+
+} // namespace
+
+vector<uint32_t> optimizeOverdraw(const vector<uint32_t> &indices,
+                                  const vector<unsigned char> &vertices,
+                                  size_t vertexCount, size_t stride,
+                                  float threshold) {
+  size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+    return indices;
+
+  float meshAcmr = analyzeVertexCache(indices, vertexCount).acmr;
+
+  // Cluster starts. A triangle that misses on all three corners starts one
+  // anyway; otherwise a cluster may end once its cold-start ACMR is low
+  // enough.
+  vector<size_t> clusterStarts(1, 0);
+  {
+    FifoCache global(vertexCount, 16), local(vertexCount, 16);
+    size_t clusterMisses = 0;
+    for (size_t t = 0; t < triangleCount; t++) {
+      int globalMisses = 0, localMisses = 0;
+      for (int c = 0; c < 3; c++) {
+        globalMisses += global.use(indices[t * 3 + c]);
+        localMisses += local.use(indices[t * 3 + c]);
+      }
+
+      size_t clusterTriangles = t + 1 - clusterStarts.back();
+      clusterMisses += localMisses;
+      bool last = t + 1 == triangleCount;
+      if (!last && (globalMisses == 3 ||
+                    clusterMisses <= threshold * meshAcmr * clusterTriangles)) {
+        clusterStarts.push_back(t + 1);
+        clusterMisses = 0;
+        local.reset();
+      }
+    }
+  }
+  clusterStarts.push_back(triangleCount);
+  size_t clusterCount = clusterStarts.size() - 1;
+
+  // Area weighted centroid and normal of each cluster, and of the mesh
+  struct Cluster {
+    float centroid[3], normal[3], area;
+  };
+  vector<Cluster> clusters(clusterCount);
+  float meshCentroid[3] = {0, 0, 0}, meshArea = 0.0f;
+  for (size_t k = 0; k < clusterCount; k++) {
+    Cluster &cluster = clusters[k];
+    memset(&cluster, 0, sizeof(cluster));
+    for (size_t t = clusterStarts[k]; t < clusterStarts[k + 1]; t++) {
+      const float *a = vertexPosition(vertices, indices[t * 3], stride);
+      const float *b = vertexPosition(vertices, indices[t * 3 + 1], stride);
+      const float *c = vertexPosition(vertices, indices[t * 3 + 2], stride);
+      float e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+      float e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+      float n[3] = {e1[1] * e2[2] - e1[2] * e2[1],
+                    e1[2] * e2[0] - e1[0] * e2[2],
+                    e1[0] * e2[1] - e1[1] * e2[0]};
+      float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+      for (int i = 0; i < 3; i++) {
+        cluster.centroid[i] += (a[i] + b[i] + c[i]) / 3.0f * area;
+        cluster.normal[i] += n[i];
+      }
+      cluster.area += area;
+    }
+    for (int i = 0; i < 3; i++)
+      meshCentroid[i] += cluster.centroid[i];
+    meshArea += cluster.area;
+    if (cluster.area > 0.0f)
+      for (int i = 0; i < 3; i++)
+        cluster.centroid[i] /= cluster.area;
+  }
+  if (meshArea > 0.0f)
+    for (int i = 0; i < 3; i++)
+      meshCentroid[i] /= meshArea;
+
+  // How far out a cluster faces: the larger, the earlier it is drawn
+  vector<float> facing(clusterCount);
+  for (size_t k = 0; k < clusterCount; k++) {
+    const Cluster &cluster = clusters[k];
+    float length = sqrtf(cluster.normal[0] * cluster.normal[0] +
+                         cluster.normal[1] * cluster.normal[1] +
+                         cluster.normal[2] * cluster.normal[2]);
+    float dot = 0.0f;
+    for (int i = 0; i < 3; i++)
+      dot += (cluster.centroid[i] - meshCentroid[i]) * cluster.normal[i];
+    facing[k] = length > 0.0f ? dot / length : 0.0f;
+  }
+
+  vector<size_t> order(clusterCount);
+  for (size_t k = 0; k < clusterCount; k++)
+    order[k] = k;
+  stable_sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return facing[a] > facing[b]; });
+
+  vector<uint32_t> result;
+  result.reserve(indices.size());
+  for (size_t k : order)
+    result.insert(result.end(), indices.begin() + clusterStarts[k] * 3,
+                  indices.begin() + clusterStarts[k + 1] * 3);
+  return result;
+}
+
+// Vertex fetch
+
+size_t optimizeVertexFetch(vector<unsigned char> &vertices,
+                           vector<uint32_t> &indices, size_t vertexCount,
+                           size_t stride) {
+  vector<uint32_t> remap(vertexCount, unused);
+  uint32_t next = 0;
+  for (uint32_t &index : indices) {
+    if (remap[index] == unused)
+      remap[index] = next++;
+    index = remap[index];
+  }
+
+  vector<unsigned char> result(next * stride);
+  for (size_t v = 0; v < vertexCount; v++) {
+    if (remap[v] != unused)
+      memcpy(&result[remap[v] * stride], &vertices[v * stride], stride);
+  }
+  vertices.swap(result);
+  return next;
+}
+
+size_t optimizeMesh(vector<unsigned char> &vertices, vector<uint32_t> &indices,
+                    size_t vertexCount, size_t stride) {
+  indices = optimizeVertexCache(indices, vertexCount);
+  indices = optimizeOverdraw(indices, vertices, vertexCount, stride);
+  return optimizeVertexFetch(vertices, indices, vertexCount, stride);
+}
+
+// Statistics
+
+VertexCacheStats analyzeVertexCache(const vector<uint32_t> &indices,
+                                    size_t vertexCount,
+                                    unsigned int cacheSize) {
+  FifoCache cache(vertexCount, cacheSize);
+  VertexCacheStats stats;
+  stats.transformed = 0;
+  for (uint32_t index : indices)
+    stats.transformed += cache.use(index);
+
+  size_t triangles = indices.size() / 3;
+  stats.acmr = triangles ? (float)stats.transformed / triangles : 0.0f;
+  stats.atvr = vertexCount ? (float)stats.transformed / vertexCount : 0.0f;
+  return stats;
+}
@@ -0,0 +1,77 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Index and vertex buffer processing, for meshes as they are loaded or
+ offline. Vertices are opaque blobs of `stride` bytes; only the overdraw pass
+ needs to know where positions are (three floats at the start of a vertex).
+ The usual order is:
+
+ vector<uint32_t> remap;
+ size_t unique = generateVertexRemap(remap, NULL, 0, vertices, count, stride);
+ indices = remapIndices(remap, NULL, count);            // or the old indices
+ vertices = remapVertices(remap, unique, vertices, count, stride);
+ indices = optimizeVertexCache(indices, unique);
+ indices = optimizeOverdraw(indices, vertices, unique, stride);
+ unique = optimizeVertexFetch(vertices, indices, unique, stride);
+ */
+
+// Drops exact duplicates: remap[i] is the new index of vertex i, the return
+// value the number of unique vertices. Without indices every vertex is used.
+size_t generateVertexRemap(vector<uint32_t> &remap, const uint32_t *indices,
+                           size_t indexCount, const void *vertices,
+                           size_t vertexCount, size_t stride);
+
+vector<unsigned char> remapVertices(const vector<uint32_t> &remap,
+                                    size_t uniqueCount, const void *vertices,
+                                    size_t vertexCount, size_t stride);
+
+// With indices NULL the mesh is taken as unindexed: 0, 1, 2, ...
+vector<uint32_t> remapIndices(const vector<uint32_t> &remap,
+                              const uint32_t *indices, size_t indexCount);
+
+// Forsyth's linear-speed vertex cache optimization: greedily picks the next
+// triangle by how recently its vertices were used and how many triangles
+// still need them
+vector<uint32_t> optimizeVertexCache(const vector<uint32_t> &indices,
+                                     size_t vertexCount);
+
+/* Splits the cache-optimized order into clusters and draws the clusters that
+ face away from the mesh centre first, so outer surfaces tend to occlude
+ inner ones. Clusters start where the cache order already starts over, and
+ also end early once their own ACMR, counted from a cold cache, is within
+ `threshold` of the whole mesh's, which bounds what the reordering costs.
+ */
+vector<uint32_t> optimizeOverdraw(const vector<uint32_t> &indices,
+                                  const vector<unsigned char> &vertices,
+                                  size_t vertexCount, size_t stride,
+                                  float threshold = 1.05f);
+
+// Renumbers vertices in order of first use and drops unused ones, so vertex
+// fetches walk memory forwards. Returns the new vertex count.
+size_t optimizeVertexFetch(vector<unsigned char> &vertices,
+                           vector<uint32_t> &indices, size_t vertexCount,
+                           size_t stride);
+
+// The three reordering passes above, in order, on an indexed mesh. Returns
+// the new vertex count.
+size_t optimizeMesh(vector<unsigned char> &vertices, vector<uint32_t> &indices,
+                    size_t vertexCount, size_t stride);
+
+// Post-transform cache behaviour, simulated with a FIFO of cacheSize entries
+struct VertexCacheStats {
+  size_t transformed; // Vertex shader invocations
+  float acmr;         // Per triangle: 0.5 is ideal, 3 is no reuse at all
+  float atvr;         // Per vertex: 1 is ideal
+};
+
+VertexCacheStats analyzeVertexCache(const vector<uint32_t> &indices,
+                                    size_t vertexCount,
+                                    unsigned int cacheSize = 16);
+
+#endif
@@ -0,0 +1,381 @@
+#include "mesh_simplifier.h"
+
+#include "jobs/job_pool.h"
+#include "mesh/mesh_optimizer.h"
+
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+// Symmetric 4x4 matrix of summed plane equations, and their total weight
+struct Quadric {
+  double a00, a11, a22, a01, a02, a12;
+  double b0, b1, b2;
+  double c;
+  double weight;
+
+  void addPlane(const glm::dvec3 &n, double d, double w) {
+    a00 += w * n.x * n.x;
+    a11 += w * n.y * n.y;
+    a22 += w * n.z * n.z;
+    a01 += w * n.x * n.y;
+    a02 += w * n.x * n.z;
+    a12 += w * n.y * n.z;
+    b0 += w * n.x * d;
+    b1 += w * n.y * d;
+    b2 += w * n.z * d;
+    c += w * d * d;
+    weight += w;
+  }
+
+  void add(const Quadric &other) {
+    double *self = &a00;
+    const double *them = &other.a00;
+    for (int i = 0; i < 11; i++)
+      self[i] += them[i];
+  }
+
+  // Root mean square distance of the point from the planes
+  float error(const glm::vec3 &p) const {
+    double x = p.x, y = p.y, z = p.z;
+    double sum = x * x * a00 + y * y * a11 + z * z * a22 +
+                 2.0 * (x * y * a01 + x * z * a02 + y * z * a12) +
+                 2.0 * (x * b0 + y * b1 + z * b2) + c;
+    return weight > 0.0 ? (float)sqrt(fabs(sum) / weight) : 0.0f;
+  }
+};
+
+// How far a vertex may move
+enum VertexKind { Manifold, Border, Locked };
+
+// Open edges are held in place by a plane through them, perpendicular to
+// their triangle, weighted well above the triangles themselves
+const double borderWeight = 10.0;
+
+struct Collapse {
+  uint32_t from, to;
+  float cost;
+};
+
+inline uint64_t edgeKey(uint32_t a, uint32_t b) {
+  return (uint64_t)a << 32 | b;
+}
+
+class Simplifier {
+public:
+  vector<uint32_t> indices;
+  float error;
+
+  Simplifier(const vector<uint32_t> &sourceIndices, const float *vertices,
+             size_t vertexCount, size_t strideFloats);
+  void run(size_t targetIndexCount, float targetError);
+
+private:
+  vector<glm::vec3> positions;
+  // Vertices with the same position share an id, which the quadrics and
+  // topology are kept by
+  vector<uint32_t> positionId;
+  vector<unsigned char> kind;
+  vector<Quadric> quadrics;
+  // Sorted keys of the open (position) edges
+  vector<uint64_t> openEdges;
+
+  bool isOpen(uint32_t a, uint32_t b) const;
+  bool collapseAllowed(uint32_t from, uint32_t to) const;
+  bool flips(uint32_t from, uint32_t to, const vector<uint32_t> &firstTriangle,
+             const vector<uint32_t> &vertexTriangles) const;
+  void removeDegenerate();
+};
+
+Simplifier::Simplifier(const vector<uint32_t> &sourceIndices,
+                       const float *vertices, size_t vertexCount,
+                       size_t strideFloats) {
+  indices = sourceIndices;
+  error = 0.0f;
+
+  positions.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++)
+    memcpy(&positions[v], vertices + v * strideFloats, sizeof(glm::vec3));
+
+  size_t positionCount = generateVertexRemap(
+      positionId, NULL, 0, positions.data(), vertexCount, sizeof(glm::vec3));
+
+  // Open edges have no twin going the other way
+  vector<uint64_t> edges;
+  edges.reserve(indices.size());
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    for (int e = 0; e < 3; e++) {
+      uint32_t a = positionId[indices[i + e]];
+      uint32_t b = positionId[indices[i + (e + 1) % 3]];
+      if (a != b)
+        edges.push_back(edgeKey(a, b));
+    }
+  }
+  sort(edges.begin(), edges.end());
+
+  vector<unsigned int> openOut(positionCount, 0), openIn(positionCount, 0);
+  for (uint64_t edge : edges) {
+    uint32_t a = (uint32_t)(edge >> 32), b = (uint32_t)edge;
+    if (!binary_search(edges.begin(), edges.end(), edgeKey(b, a))) {
+      openEdges.push_back(edge);
+      openOut[a]++;
+      openIn[b]++;
+    }
+  }
+
+  vector<unsigned int> wedges(positionCount, 0);
+  for (size_t v = 0; v < vertexCount; v++)
+    wedges[positionId[v]]++;
+
+  vector<unsigned char> positionKind(positionCount);
+  for (size_t p = 0; p < positionCount; p++) {
+    if (wedges[p] > 1)
+      positionKind[p] = Locked;
+    else if (openOut[p] == 0 && openIn[p] == 0)
+      positionKind[p] = Manifold;
+    else if (openOut[p] == 1 && openIn[p] == 1)
+      positionKind[p] = Border;
+    else
+      positionKind[p] = Locked;
+  }
+  kind.resize(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++)
+    kind[v] = positionKind[positionId[v]];
+
+  // Area weighted triangle planes, plus the border planes
+  quadrics.assign(positionCount, Quadric());
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    glm::dvec3 p[3];
+    for (int c = 0; c < 3; c++)
+      p[c] = glm::dvec3(positions[indices[i + c]]);
+    glm::dvec3 normal = glm::cross(p[1] - p[0], p[2] - p[0]);
+    double area = glm::length(normal);
+    if (area <= 0.0)
+      continue;
+    normal /= area;
+
+    for (int c = 0; c < 3; c++)
+      quadrics[positionId[indices[i + c]]].addPlane(
+          normal, -glm::dot(normal, p[0]), area * 0.5);
+
+    for (int e = 0; e < 3; e++) {
+      uint32_t a = positionId[indices[i + e]];
+      uint32_t b = positionId[indices[i + (e + 1) % 3]];
+      if (!isOpen(a, b))
+        continue;
+      glm::dvec3 edge = p[(e + 1) % 3] - p[e];
+      double length = glm::length(edge);
+      if (length <= 0.0)
+        continue;
+      glm::dvec3 side = glm::normalize(glm::cross(edge, normal));
+      double d = -glm::dot(side, p[e]);
+      quadrics[a].addPlane(side, d, borderWeight * length * length);
+      quadrics[b].addPlane(side, d, borderWeight * length * length);
+    }
+  }
+}
+
+bool Simplifier::isOpen(uint32_t a, uint32_t b) const {
+  return binary_search(openEdges.begin(), openEdges.end(), edgeKey(a, b));
+}
+
+bool Simplifier::collapseAllowed(uint32_t from, uint32_t to) const {
+  uint32_t a = positionId[from], b = positionId[to];
+  if (a == b)
+    return false;
+  switch (kind[from]) {
+  case Manifold:
+    return true;
+  case Border:
+    // Only along the border, so the outline keeps its vertices in order
+    return isOpen(a, b) || isOpen(b, a);
+  default:
+    return false;
+  }
+}
+
+// Whether moving `from` onto `to` turns any of from's other triangles over
+bool Simplifier::flips(uint32_t from, uint32_t to,
+                       const vector<uint32_t> &firstTriangle,
+                       const vector<uint32_t> &vertexTriangles) const {
+  const glm::vec3 &target = positions[to];
+  for (uint32_t k = firstTriangle[from]; k < firstTriangle[from + 1]; k++) {
+    const uint32_t *triangle = &indices[vertexTriangles[k] * 3];
+    glm::vec3 before[3], after[3];
+    bool hasTarget = false;
+    for (int c = 0; c < 3; c++) {
+      before[c] = positions[triangle[c]];
+      after[c] = triangle[c] == from ? target : before[c];
+      hasTarget |= positionId[triangle[c]] == positionId[to];
+    }
+    // Those go away
+    if (hasTarget)
+      continue;
+
+    glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+    glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+    if (glm::dot(n0, n1) <= 0.0f)
+      return true;
+  }
+  return false;
+}
+
+void Simplifier::removeDegenerate() {
+  size_t write = 0;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    uint32_t a = positionId[indices[i]], b = positionId[indices[i + 1]],
+             c = positionId[indices[i + 2]];
+    if (a == b || b == c || a == c)
+      continue;
+    memmove(&indices[write], &indices[i], 3 * sizeof(uint32_t));
+    write += 3;
+  }
+  indices.resize(write);
+}
+
+void Simplifier::run(size_t targetIndexCount, float targetError) {
+  size_t vertexCount = positions.size();
+  vector<uint32_t> firstTriangle(vertexCount + 1);
+  vector<uint32_t> vertexTriangles;
+  vector<Collapse> bestCollapse, collapses;
+  vector<uint32_t> collapseTarget(vertexCount);
+  vector<bool> touched(vertexCount);
+
+  while (indices.size() > targetIndexCount) {
+    // Triangles around each vertex
+    fill(firstTriangle.begin(), firstTriangle.end(), 0);
+    for (uint32_t index : indices)
+      firstTriangle[index + 1]++;
+    for (size_t v = 0; v < vertexCount; v++)
+      firstTriangle[v + 1] += firstTriangle[v];
+    vertexTriangles.resize(indices.size());
+    {
+      vector<uint32_t> fillPosition(firstTriangle.begin(),
+                                    firstTriangle.end() - 1);
+      for (size_t i = 0; i < indices.size(); i++)
+        vertexTriangles[fillPosition[indices[i]]++] = (uint32_t)(i / 3);
+    }
+
+    // The cheapest allowed collapse of every vertex, found in parallel
+    bestCollapse.resize(vertexCount);
+    jobPool.parallelFor(
+        vertexCount, 4096, [&](size_t begin, size_t end, unsigned int) {
+          for (size_t v = begin; v < end; v++) {
+            Collapse best = {(uint32_t)v, (uint32_t)v, FLT_MAX};
+            if (kind[v] != Locked) {
+              const Quadric &quadric = quadrics[positionId[v]];
+              for (uint32_t k = firstTriangle[v]; k < firstTriangle[v + 1];
+                   k++) {
+                const uint32_t *triangle = &indices[vertexTriangles[k] * 3];
+                for (int c = 0; c < 3; c++) {
+                  uint32_t to = triangle[c];
+                  if (to == v || !collapseAllowed((uint32_t)v, to))
+                    continue;
+                  float cost = quadric.error(positions[to]);
+                  if (cost < best.cost) {
+                    best.to = to;
+                    best.cost = cost;
+                  }
+                }
+              }
+            }
+            bestCollapse[v] = best;
+          }
+        });
+
+    collapses.clear();
+    for (const Collapse &collapse : bestCollapse) {
+      if (collapse.from != collapse.to && collapse.cost <= targetError)
+        collapses.push_back(collapse);
+    }
+    if (collapses.empty())
+      break;
+    sort(collapses.begin(), collapses.end(),
+         [](const Collapse &a, const Collapse &b) { return a.cost < b.cost; });
+
+    // Every collapse takes away one or two triangles
+    size_t trianglesToRemove = (indices.size() - targetIndexCount) / 3;
+    size_t removed = 0;
+    for (size_t v = 0; v < vertexCount; v++)
+      collapseTarget[v] = (uint32_t)v;
+    fill(touched.begin(), touched.end(), false);
+
+    for (const Collapse &collapse : collapses) {
+      if (removed >= trianglesToRemove)
+        break;
+      if (touched[collapse.from] || touched[collapse.to])
+        continue;
+      if (flips(collapse.from, collapse.to, firstTriangle, vertexTriangles))
+        continue;
+
+      // Nothing else in the neighbourhood moves this pass, so the flip test
+      // above stays valid
+      for (uint32_t k = firstTriangle[collapse.from];
+           k < firstTriangle[collapse.from + 1]; k++) {
+        const uint32_t *triangle = &indices[vertexTriangles[k] * 3];
+        bool hasTarget = false;
+        for (int c = 0; c < 3; c++) {
+          touched[triangle[c]] = true;
+          hasTarget |= positionId[triangle[c]] == positionId[collapse.to];
+        }
+        removed += hasTarget;
+      }
+      touched[collapse.to] = true;
+
+      collapseTarget[collapse.from] = collapse.to;
+      quadrics[positionId[collapse.to]].add(
+          quadrics[positionId[collapse.from]]);
+      error = max(error, collapse.cost);
+    }
+    if (removed == 0)
+      break;
+
+    for (uint32_t &index : indices)
+      index = collapseTarget[index];
+    removeDegenerate();
+  }
+}
+
+} // namespace
+
+vector<uint32_t> simplifyMesh(const vector<uint32_t> &indices,
+                              const float *vertices, size_t vertexCount,
+                              size_t strideFloats, size_t targetIndexCount,
+                              float targetError, float *resultError) {
+  Simplifier simplifier(indices, vertices, vertexCount, strideFloats);
+  simplifier.run(targetIndexCount, targetError);
+  if (resultError)
+    *resultError = simplifier.error;
+  return simplifier.indices;
+}
+
+vector<MeshLod> buildLods(vector<uint32_t> &indices, const float *vertices,
+                          size_t vertexCount, size_t strideFloats,
+                          unsigned int maxLevels, float ratio,
+                          float maxError) {
+  vector<MeshLod> lods(1, MeshLod{0, (uint32_t)indices.size(), 0.0f, 0});
+  Simplifier simplifier(indices, vertices, vertexCount, strideFloats);
+
+  while (lods.size() < maxLevels) {
+    size_t previous = lods.back().indexCount;
+    size_t target = (size_t)(previous / 3 * ratio) * 3;
+    simplifier.run(target, maxError);
+
+    // Not worth a level of its own. An empty level would make the mesh
+    // vanish at distance, and past it every level would be empty too.
+    size_t reached = simplifier.indices.size();
+    if (reached == 0 || reached >= previous ||
+        reached > previous * (1.0f + ratio) / 2.0f)
+      break;
+
+    vector<uint32_t> level =
+        optimizeVertexCache(simplifier.indices, vertexCount);
+    lods.push_back(MeshLod{(uint32_t)indices.size(), (uint32_t)level.size(),
+                           simplifier.error, 0});
+    indices.insert(indices.end(), level.begin(), level.end());
+  }
+  return lods;
+}
@@ -0,0 +1,56 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <float.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+// A level of detail: a range of the shared index buffer, drawn with the same
+// vertices as every other level. error is how far, in model units, its
+// surface may be from the full mesh.
+struct MeshLod {
+  uint32_t indexOffset;
+  uint32_t indexCount;
+  float error;
+  uint32_t padding;
+};
+
+/* Quadric error metric edge collapse (Garland and Heckbert). Vertices are
+ only ever collapsed onto one of their neighbours, so no new vertices are
+ made and every level can share the original vertex buffer. Positions are
+ the first three floats of each vertex.
+
+ - Open borders only move along themselves, and carry extra quadrics that
+   keep them in place.
+ - Attribute seams (one position, several vertices with different texture
+   coordinates or normals) are never moved, so attributes don't smear across
+   them.
+
+ Each pass finds the cheapest collapse of every vertex in parallel (with
+ jobPool), then makes the cheapest of those that don't flip a triangle, at
+ most one per neighbourhood.
+ */
+
+// Stops once the mesh has at most targetIndexCount indices, or once the next
+// collapse would cost more than targetError (model units)
+vector<uint32_t> simplifyMesh(const vector<uint32_t> &indices,
+                              const float *vertices, size_t vertexCount,
+                              size_t strideFloats, size_t targetIndexCount,
+                              float targetError = FLT_MAX,
+                              float *resultError = NULL);
+
+/* Appends coarser levels to `indices`, each with about `ratio` of the
+ triangles of the one before, simplifying the mesh once and keeping a copy of
+ it as it passes each target. Stops after maxLevels levels, when a level
+ would need more than maxError, or when simplification stalls or would leave
+ no triangles. Returns the levels, the full mesh first.
+ */
+vector<MeshLod> buildLods(vector<uint32_t> &indices, const float *vertices,
+                          size_t vertexCount, size_t strideFloats,
+                          unsigned int maxLevels = 6, float ratio = 0.5f,
+                          float maxError = FLT_MAX);
+
+#endif
@@ -0,0 +1,321 @@
+#include "vertex_format.h"
+
+#include <algorithm>
+#include <glm/gtc/packing.hpp>
+#include <glm/packing.hpp>
+#include <math.h>
+#include <string.h>
+
+VertexFormat VertexFormat::uncompressed() {
+  return VertexFormat{PositionFloat, TexCoordFloat, NormalFloat};
+}
+
+VertexFormat VertexFormat::compact() {
+  return VertexFormat{PositionSnorm16, TexCoordUnorm16, NormalOctahedral};
+}
+
+const char *positionFormatName(PositionFormat format) {
+  switch (format) {
+  case PositionSnorm16:
+    return "snorm16";
+  case PositionHalf:
+    return "half";
+  default:
+    return "float";
+  }
+}
+
+const char *normalFormatName(NormalFormat format) {
+  switch (format) {
+  case NormalOctahedral:
+    return "octahedral";
+  case Normal10_10_10_2:
+    return "10_10_10_2";
+  default:
+    return "float";
+  }
+}
+
+static size_t positionBytes(PositionFormat format) {
+  // The 16-bit formats carry an unused w, so every vertex stays 4-byte aligned
+  return format == PositionFloat ? 3 * sizeof(float) : 4 * sizeof(uint16_t);
+}
+
+static size_t texCoordBytes(TexCoordFormat format) {
+  return format == TexCoordFloat ? 2 * sizeof(float) : 2 * sizeof(uint16_t);
+}
+
+static size_t normalBytes(NormalFormat format) {
+  return format == NormalFloat ? 3 * sizeof(float) : sizeof(uint32_t);
+}
+
+// Octahedral normals
+
+static glm::vec3 octahedralDecode(glm::vec2 e) {
+  glm::vec3 n(e.x, e.y, 1.0f - fabsf(e.x) - fabsf(e.y));
+  if (n.z < 0.0f) {
+    float x = n.x;
+    n.x = (1.0f - fabsf(n.y)) * (x >= 0.0f ? 1.0f : -1.0f);
+    n.y = (1.0f - fabsf(x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+  }
+  return glm::normalize(n);
+}
+
+// Rounding each component to nearest is not the closest encoding once the
+// octahedron is unfolded, so all four roundings are tried.
+static uint32_t octahedralEncode(glm::vec3 n) {
+  n /= fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+  glm::vec2 e(n.x, n.y);
+  if (n.z < 0.0f) {
+    e.x = (1.0f - fabsf(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f);
+    e.y = (1.0f - fabsf(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f);
+  }
+
+  glm::vec3 unit = glm::normalize(n);
+  uint32_t best = 0;
+  float bestDot = -2.0f;
+  for (int i = 0; i < 4; i++) {
+    glm::vec2 q((i & 1) ? ceilf(e.x * 32767.0f) : floorf(e.x * 32767.0f),
+                (i & 2) ? ceilf(e.y * 32767.0f) : floorf(e.y * 32767.0f));
+    uint32_t packed = glm::packSnorm2x16(q / 32767.0f);
+    float d = glm::dot(unit, octahedralDecode(glm::unpackSnorm2x16(packed)));
+    if (d > bestDot) {
+      bestDot = d;
+      best = packed;
+    }
+  }
+  return best;
+}
+
+// atan2 rather than acos, which loses everything below about 0.03 degrees
+static float angleDegrees(glm::vec3 a, glm::vec3 b) {
+  return glm::degrees(
+      atan2f(glm::length(glm::cross(a, b)), glm::dot(a, b)));
+}
+
+// Quantization
+
+QuantizedVertices quantizeVertices(const float *vertices, size_t vertexCount,
+                                   const FloatVertexLayout &layout,
+                                   const VertexFormat &format) {
+  QuantizedVertices result;
+  result.format = format;
+  result.vertexCount = vertexCount;
+  result.positionScale = glm::vec3(1.0f);
+  result.positionBias = glm::vec3(0.0f);
+  result.positionError = 0.0f;
+  result.texCoordError = 0.0f;
+  result.normalError = 0.0f;
+
+  result.stride = 0;
+  result.positionOffset = -1;
+  result.texCoordOffset = -1;
+  result.normalOffset = -1;
+  if (layout.position >= 0) {
+    result.positionOffset = (int)result.stride;
+    result.stride += positionBytes(format.position);
+  }
+  if (layout.texCoord >= 0) {
+    result.texCoordOffset = (int)result.stride;
+    result.stride += texCoordBytes(format.texCoord);
+  }
+  if (layout.normal >= 0) {
+    result.normalOffset = (int)result.stride;
+    result.stride += normalBytes(format.normal);
+  }
+  result.data.assign(result.stride * vertexCount, 0);
+
+  // Snorm16 positions span the bounds, one scale per axis
+  glm::vec3 inverseScale(1.0f);
+  if (layout.position >= 0 && format.position == PositionSnorm16 &&
+      vertexCount > 0) {
+    const float *p = vertices + layout.position;
+    glm::vec3 low(p[0], p[1], p[2]), high = low;
+    for (size_t v = 1; v < vertexCount; v++) {
+      p = vertices + v * layout.stride + layout.position;
+      glm::vec3 position(p[0], p[1], p[2]);
+      low = glm::min(low, position);
+      high = glm::max(high, position);
+    }
+    result.positionBias = (low + high) * 0.5f;
+    result.positionScale = (high - low) * 0.5f;
+    for (int i = 0; i < 3; i++)
+      inverseScale[i] = result.positionScale[i] > 0.0f
+                            ? 1.0f / result.positionScale[i]
+                            : 0.0f;
+  }
+
+  for (size_t v = 0; v < vertexCount; v++) {
+    const float *source = vertices + v * layout.stride;
+    unsigned char *target = &result.data[v * result.stride];
+
+    if (layout.position >= 0) {
+      const float *p = source + layout.position;
+      glm::vec3 position(p[0], p[1], p[2]), decoded;
+      unsigned char *out = target + result.positionOffset;
+      if (format.position == PositionFloat) {
+        memcpy(out, p, 3 * sizeof(float));
+        decoded = position;
+      } else if (format.position == PositionSnorm16) {
+        glm::vec4 unit(
+            glm::clamp((position - result.positionBias) * inverseScale,
+                       -1.0f, 1.0f),
+            0.0f);
+        uint64_t packed = glm::packSnorm4x16(unit);
+        memcpy(out, &packed, sizeof(packed));
+        decoded = glm::vec3(glm::unpackSnorm4x16(packed)) *
+                      result.positionScale +
+                  result.positionBias;
+      } else {
+        uint64_t packed = glm::packHalf4x16(glm::vec4(position, 0.0f));
+        memcpy(out, &packed, sizeof(packed));
+        decoded = glm::vec3(glm::unpackHalf4x16(packed));
+      }
+      glm::vec3 error = glm::abs(decoded - position);
+      result.positionError =
+          max(result.positionError, max(error.x, max(error.y, error.z)));
+    }
+
+    if (layout.texCoord >= 0) {
+      const float *t = source + layout.texCoord;
+      glm::vec2 texCoord(t[0], t[1]), decoded;
+      unsigned char *out = target + result.texCoordOffset;
+      if (format.texCoord == TexCoordFloat) {
+        memcpy(out, t, 2 * sizeof(float));
+        decoded = texCoord;
+      } else {
+        uint32_t packed = glm::packUnorm2x16(texCoord);
+        memcpy(out, &packed, sizeof(packed));
+        decoded = glm::unpackUnorm2x16(packed);
+      }
+      glm::vec2 error = glm::abs(decoded - texCoord);
+      result.texCoordError =
+          max(result.texCoordError, max(error.x, error.y));
+    }
+
+    if (layout.normal >= 0) {
+      const float *n = source + layout.normal;
+      glm::vec3 normal(n[0], n[1], n[2]);
+      unsigned char *out = target + result.normalOffset;
+      if (format.normal == NormalFloat) {
+        memcpy(out, n, 3 * sizeof(float));
+      } else if (format.normal == NormalOctahedral) {
+        uint32_t packed = octahedralEncode(normal);
+        memcpy(out, &packed, sizeof(packed));
+      } else {
+        uint32_t packed =
+            glm::packSnorm3x10_1x2(glm::vec4(glm::normalize(normal), 0.0f));
+        memcpy(out, &packed, sizeof(packed));
+      }
+      result.normalError =
+          max(result.normalError,
+              angleDegrees(result.normal(result.data.data(), v), normal));
+    }
+  }
+
+  return result;
+}
+
+// Reading back
+
+glm::vec3 QuantizedVertices::position(const void *vertexData,
+                                      size_t vertex) const {
+  const unsigned char *p =
+      (const unsigned char *)vertexData + vertex * stride + positionOffset;
+  if (format.position == PositionFloat) {
+    glm::vec3 position;
+    memcpy(&position, p, sizeof(position));
+    return position;
+  }
+
+  uint64_t packed;
+  memcpy(&packed, p, sizeof(packed));
+  glm::vec4 unpacked = format.position == PositionSnorm16
+                           ? glm::unpackSnorm4x16(packed)
+                           : glm::unpackHalf4x16(packed);
+  return glm::vec3(unpacked) * positionScale + positionBias;
+}
+
+glm::vec2 QuantizedVertices::texCoord(const void *vertexData,
+                                      size_t vertex) const {
+  if (texCoordOffset < 0)
+    return glm::vec2(0.0f);
+  const unsigned char *p =
+      (const unsigned char *)vertexData + vertex * stride + texCoordOffset;
+  if (format.texCoord == TexCoordFloat) {
+    glm::vec2 texCoord;
+    memcpy(&texCoord, p, sizeof(texCoord));
+    return texCoord;
+  }
+
+  uint32_t packed;
+  memcpy(&packed, p, sizeof(packed));
+  return glm::unpackUnorm2x16(packed);
+}
+
+glm::vec3 QuantizedVertices::normal(const void *vertexData,
+                                    size_t vertex) const {
+  if (normalOffset < 0)
+    return glm::vec3(0.0f);
+  const unsigned char *p =
+      (const unsigned char *)vertexData + vertex * stride + normalOffset;
+  if (format.normal == NormalFloat) {
+    glm::vec3 normal;
+    memcpy(&normal, p, sizeof(normal));
+    return glm::normalize(normal);
+  }
+
+  uint32_t packed;
+  memcpy(&packed, p, sizeof(packed));
+  if (format.normal == NormalOctahedral)
+    return octahedralDecode(glm::unpackSnorm2x16(packed));
+  return glm::normalize(glm::vec3(glm::unpackSnorm3x10_1x2(packed)));
+}
+
+// Attribute setup
+
+void QuantizedVertices::setAttributes(GLuint positionLocation,
+                                      GLuint texCoordLocation,
+                                      GLuint normalLocation,
+                                      GLintptr offset) const {
+  GLsizei glStride = (GLsizei)stride;
+
+  if (positionOffset >= 0) {
+    const void *pointer = (const void *)(offset + positionOffset);
+    if (format.position == PositionFloat)
+      glVertexAttribPointer(positionLocation, 3, GL_FLOAT, GL_FALSE, glStride,
+                            pointer);
+    else if (format.position == PositionSnorm16)
+      glVertexAttribPointer(positionLocation, 3, GL_SHORT, GL_TRUE, glStride,
+                            pointer);
+    else
+      glVertexAttribPointer(positionLocation, 3, GL_HALF_FLOAT, GL_FALSE,
+                            glStride, pointer);
+    glEnableVertexAttribArray(positionLocation);
+  }
+
+  if (texCoordOffset >= 0) {
+    const void *pointer = (const void *)(offset + texCoordOffset);
+    if (format.texCoord == TexCoordFloat)
+      glVertexAttribPointer(texCoordLocation, 2, GL_FLOAT, GL_FALSE, glStride,
+                            pointer);
+    else
+      glVertexAttribPointer(texCoordLocation, 2, GL_UNSIGNED_SHORT, GL_TRUE,
+                            glStride, pointer);
+    glEnableVertexAttribArray(texCoordLocation);
+  }
+
+  if (normalOffset >= 0) {
+    const void *pointer = (const void *)(offset + normalOffset);
+    if (format.normal == NormalFloat)
+      glVertexAttribPointer(normalLocation, 3, GL_FLOAT, GL_FALSE, glStride,
+                            pointer);
+    else if (format.normal == NormalOctahedral)
+      glVertexAttribPointer(normalLocation, 2, GL_SHORT, GL_TRUE, glStride,
+                            pointer);
+    else
+      glVertexAttribPointer(normalLocation, 4, GL_INT_2_10_10_10_REV, GL_TRUE,
+                            glStride, pointer);
+    glEnableVertexAttribArray(normalLocation);
+  }
+}
@@ -0,0 +1,91 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <vector>
+
+using namespace std;
+
+/* Compressed vertex attributes. Meshes are built from interleaved floats, run
+ through the mesh optimizer, and then packed into the format chosen for that
+ mesh. Every packed attribute is read through a normalized (or half float)
+ vertex attribute, so the shader sees floats again:
+
+ - Snorm16 positions are relative to the mesh bounds. The vertex shader undoes
+   that with `aPos * positionScale + positionOffset`; both uniforms default
+   to the identity, so float and half positions need nothing.
+ - Unorm16 texture coordinates must lie in [0, 1]. Anything outside is clamped
+   and shows up in texCoordError.
+ - Octahedral normals arrive as a vec2 in [-1, 1] and are unfolded by
+   decodeNormal in the vertex shaders, driven by the normalFormat uniform.
+   10_10_10_2 normals are a plain vec3 (the 2-bit w is unused). normal()
+   below is the same decode, and normalError is measured through it.
+ */
+
+enum PositionFormat { PositionFloat, PositionSnorm16, PositionHalf };
+enum TexCoordFormat { TexCoordFloat, TexCoordUnorm16 };
+enum NormalFormat { NormalFloat, NormalOctahedral, Normal10_10_10_2 };
+
+struct VertexFormat {
+  PositionFormat position;
+  TexCoordFormat texCoord;
+  NormalFormat normal;
+
+  static VertexFormat uncompressed();
+  // Snorm16 positions, unorm16 texture coordinates, octahedral normals
+  static VertexFormat compact();
+};
+
+// Where the attributes of an interleaved float vertex are, in floats. Offsets
+// of -1 mark attributes the mesh does not have.
+struct FloatVertexLayout {
+  size_t stride;
+  int position;
+  int texCoord;
+  int normal;
+};
+
+struct QuantizedVertices {
+  VertexFormat format;
+  size_t vertexCount;
+
+  // Byte layout of one packed vertex; offsets are -1 for missing attributes
+  size_t stride;
+  int positionOffset;
+  int texCoordOffset;
+  int normalOffset;
+  vector<unsigned char> data;
+
+  // For the positionScale and positionOffset shader uniforms
+  glm::vec3 positionScale;
+  glm::vec3 positionBias;
+
+  // Largest difference between a source attribute and what the shader will
+  // read back: in model units, in texture coordinates, and in degrees
+  float positionError;
+  float texCoordError;
+  float normalError;
+
+  // Point the current vertex array's attributes at the packed data, which
+  // must be in the bound GL_ARRAY_BUFFER at `offset`
+  void setAttributes(GLuint positionLocation, GLuint texCoordLocation,
+                     GLuint normalLocation, GLintptr offset = 0) const;
+
+  // What the shader reads for a vertex of `vertexData`, which is laid out
+  // like this (data, or a mesh cache's vertexData())
+  glm::vec3 position(const void *vertexData, size_t vertex) const;
+  glm::vec2 texCoord(const void *vertexData, size_t vertex) const;
+  // Unit length; (0, 0, 0) when the mesh has no normals
+  glm::vec3 normal(const void *vertexData, size_t vertex) const;
+};
+
+QuantizedVertices quantizeVertices(const float *vertices, size_t vertexCount,
+                                   const FloatVertexLayout &layout,
+                                   const VertexFormat &format);
+
+const char *positionFormatName(PositionFormat format);
+const char *normalFormatName(NormalFormat format);
+
+#endif
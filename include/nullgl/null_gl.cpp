@@ -0,0 +1,1043 @@
+#include "null_gl.h"
+
+#include <algorithm>
+#include <ctype.h>
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// One per entry point, registered the first time it is called
+struct CallCounter {
+  const char *name;
+  uint64_t count;
+  CallCounter(const char *callName);
+};
+
+vector<CallCounter *> &callCounters() {
+  static vector<CallCounter *> counters;
+  return counters;
+}
+
+CallCounter::CallCounter(const char *callName) : name(callName), count(0) {
+  callCounters().push_back(this);
+}
+
+NullGLStats stats;
+
+#define RECORD(name)                                                           \
+  static CallCounter counter(name);                                            \
+  counter.count++;                                                             \
+  stats.calls++
+
+#define RECORD_STATE(name)                                                     \
+  RECORD(name);                                                                \
+  stats.stateChanges++
+
+struct Buffer {
+  vector<unsigned char> data;
+};
+
+struct Texture {
+  GLsizei width = 0, height = 0;
+  vector<unsigned char> data;
+};
+
+struct ShaderObject {
+  GLenum type;
+  string source;
+};
+
+// Values are kept as 16 words (a mat4) per array element
+struct UniformDecl {
+  string name;
+  GLenum type;
+  GLint size;
+  GLint location;
+  vector<uint32_t> value;
+};
+
+struct Program {
+  vector<GLuint> shaders;
+  vector<UniformDecl> uniforms;
+  vector<int> uniformAtLocation;
+  vector<string> blocks;
+};
+
+GLuint nextName = 1;
+unordered_map<GLuint, Buffer> buffers;
+unordered_map<GLuint, Texture> textures;
+unordered_map<GLuint, ShaderObject> shaderObjects;
+unordered_map<GLuint, Program> programs;
+
+unordered_map<GLenum, GLuint> boundBuffers;
+unordered_map<uint64_t, GLuint> boundTextures;
+GLenum activeUnit = GL_TEXTURE0;
+GLuint currentProgram = 0;
+
+GLuint newName() {
+  stats.objectsCreated++;
+  return nextName++;
+}
+
+uint64_t textureBinding(GLenum target) {
+  return ((uint64_t)activeUnit << 32) | target;
+}
+
+Buffer *boundBuffer(GLenum target) {
+  auto binding = boundBuffers.find(target);
+  if (binding == boundBuffers.end())
+    return NULL;
+  auto buffer = buffers.find(binding->second);
+  return buffer == buffers.end() ? NULL : &buffer->second;
+}
+
+// GLSL uniform types, and how many 32-bit words one element holds
+struct GLSLType {
+  const char *name;
+  GLenum type;
+  int words;
+};
+
+const GLSLType glslTypes[] = {
+    {"float", GL_FLOAT, 1},
+    {"vec2", GL_FLOAT_VEC2, 2},
+    {"vec3", GL_FLOAT_VEC3, 3},
+    {"vec4", GL_FLOAT_VEC4, 4},
+    {"int", GL_INT, 1},
+    {"ivec2", GL_INT_VEC2, 2},
+    {"ivec3", GL_INT_VEC3, 3},
+    {"ivec4", GL_INT_VEC4, 4},
+    {"uint", GL_UNSIGNED_INT, 1},
+    {"uvec2", GL_UNSIGNED_INT_VEC2, 2},
+    {"uvec3", GL_UNSIGNED_INT_VEC3, 3},
+    {"uvec4", GL_UNSIGNED_INT_VEC4, 4},
+    {"bool", GL_BOOL, 1},
+    {"bvec2", GL_BOOL_VEC2, 2},
+    {"bvec3", GL_BOOL_VEC3, 3},
+    {"bvec4", GL_BOOL_VEC4, 4},
+    {"mat2", GL_FLOAT_MAT2, 4},
+    {"mat3", GL_FLOAT_MAT3, 9},
+    {"mat4", GL_FLOAT_MAT4, 16},
+    {"sampler1D", GL_SAMPLER_1D, 1},
+    {"sampler2D", GL_SAMPLER_2D, 1},
+    {"sampler3D", GL_SAMPLER_3D, 1},
+    {"samplerCube", GL_SAMPLER_CUBE, 1},
+    {"sampler2DArray", GL_SAMPLER_2D_ARRAY, 1},
+};
+
+const GLSLType *findType(const string &name) {
+  for (const GLSLType &type : glslTypes) {
+    if (name == type.name)
+      return &type;
+  }
+  return NULL;
+}
+
+const GLSLType *findType(GLenum glType) {
+  for (const GLSLType &type : glslTypes) {
+    if (glType == type.type)
+      return &type;
+  }
+  return NULL;
+}
+
+vector<string> tokenize(const string &source) {
+  vector<string> tokens;
+  size_t i = 0, n = source.size();
+  while (i < n) {
+    char c = source[i];
+    if (c == '/' && i + 1 < n && source[i + 1] == '/') {
+      while (i < n && source[i] != '\n')
+        i++;
+    } else if (c == '/' && i + 1 < n && source[i + 1] == '*') {
+      size_t end = source.find("*/", i + 2);
+      i = end == string::npos ? n : end + 2;
+    } else if (c == '#') {
+      // Preprocessor lines (#version, #define) never declare uniforms
+      while (i < n && source[i] != '\n')
+        i++;
+    } else if (isalnum((unsigned char)c) || c == '_') {
+      size_t start = i;
+      while (i < n && (isalnum((unsigned char)source[i]) || source[i] == '_'))
+        i++;
+      tokens.push_back(source.substr(start, i - start));
+    } else if (isspace((unsigned char)c)) {
+      i++;
+    } else {
+      tokens.push_back(string(1, c));
+      i++;
+    }
+  }
+  return tokens;
+}
+
+// Every declared uniform is treated as active, since nothing is optimized out
+void parseUniforms(const string &source, Program &program) {
+  vector<string> tokens = tokenize(source);
+  size_t n = tokens.size();
+
+  for (size_t i = 0; i < n; i++) {
+    if (tokens[i] != "uniform")
+      continue;
+
+    size_t j = i + 1;
+    while (j < n && (tokens[j] == "lowp" || tokens[j] == "mediump" ||
+                     tokens[j] == "highp"))
+      j++;
+    if (j + 1 >= n)
+      break;
+
+    // Uniform block: only its name matters, its members live in a buffer
+    if (tokens[j + 1] == "{") {
+      if (find(program.blocks.begin(), program.blocks.end(), tokens[j]) ==
+          program.blocks.end())
+        program.blocks.push_back(tokens[j]);
+      while (j < n && tokens[j] != "}")
+        j++;
+      i = j;
+      continue;
+    }
+
+    const GLSLType *type = findType(tokens[j]);
+    j++;
+    while (type && j < n) {
+      UniformDecl decl;
+      decl.name = tokens[j++];
+      decl.type = type->type;
+      decl.size = 1;
+      decl.location = -1;
+
+      if (j + 2 < n && tokens[j] == "[") {
+        decl.size = max(1, atoi(tokens[j + 1].c_str()));
+        j += 3;
+      }
+
+      // Skip initializers
+      int depth = 0;
+      while (j < n && !(depth == 0 && (tokens[j] == "," || tokens[j] == ";"))) {
+        if (tokens[j] == "(")
+          depth++;
+        else if (tokens[j] == ")")
+          depth--;
+        j++;
+      }
+
+      bool known = false;
+      for (const UniformDecl &existing : program.uniforms)
+        known = known || existing.name == decl.name;
+      if (!known)
+        program.uniforms.push_back(decl);
+
+      if (j >= n || tokens[j] == ";")
+        break;
+      j++;
+    }
+    i = j;
+  }
+}
+
+UniformDecl *uniformAt(GLint location, int *element) {
+  auto program = programs.find(currentProgram);
+  if (location < 0 || program == programs.end() ||
+      location >= (GLint)program->second.uniformAtLocation.size())
+    return NULL;
+
+  UniformDecl &decl =
+      program->second.uniforms[program->second.uniformAtLocation[location]];
+  *element = location - decl.location;
+  return &decl;
+}
+
+void setUniform(GLint location, GLsizei count, const void *data, int words) {
+  int element;
+  UniformDecl *decl = uniformAt(location, &element);
+  if (!decl)
+    return;
+
+  const uint32_t *source = (const uint32_t *)data;
+  for (GLsizei i = 0; i < count && element + i < decl->size; i++)
+    memcpy(&decl->value[(element + i) * 16], source + i * words, words * 4);
+}
+
+void getUniform(GLuint programName, GLint location, void *params) {
+  auto program = programs.find(programName);
+  if (location < 0 || program == programs.end() ||
+      location >= (GLint)program->second.uniformAtLocation.size())
+    return;
+
+  const UniformDecl &decl =
+      program->second.uniforms[program->second.uniformAtLocation[location]];
+  const GLSLType *type = findType(decl.type);
+  memcpy(params, &decl.value[(location - decl.location) * 16],
+         type->words * 4);
+}
+
+size_t pixelBytes(GLenum format, GLenum type) {
+  size_t channels = 4;
+  switch (format) {
+  case GL_RED:
+  case GL_DEPTH_COMPONENT:
+    channels = 1;
+    break;
+  case GL_RG:
+    channels = 2;
+    break;
+  case GL_RGB:
+  case GL_BGR:
+    channels = 3;
+    break;
+  }
+
+  switch (type) {
+  case GL_UNSIGNED_SHORT:
+  case GL_SHORT:
+  case GL_HALF_FLOAT:
+    return channels * 2;
+  case GL_UNSIGNED_INT:
+  case GL_INT:
+  case GL_FLOAT:
+    return channels * 4;
+  default:
+    return channels;
+  }
+}
+
+// Entry points
+
+const GLubyte *APIENTRY nullGetString(GLenum name) {
+  RECORD("glGetString");
+  switch (name) {
+  case GL_VENDOR:
+    return (const GLubyte *)"OpenGL-Tests";
+  case GL_RENDERER:
+    return (const GLubyte *)"Null recording backend";
+  case GL_VERSION:
+    return (const GLubyte *)"3.3 Null";
+  case GL_SHADING_LANGUAGE_VERSION:
+    return (const GLubyte *)"3.30";
+  default:
+    return (const GLubyte *)"";
+  }
+}
+
+void APIENTRY nullGetIntegerv(GLenum pname, GLint *data) {
+  RECORD("glGetIntegerv");
+  switch (pname) {
+  case GL_MAJOR_VERSION:
+  case GL_MINOR_VERSION:
+    *data = 3;
+    break;
+  case GL_MAX_TEXTURE_IMAGE_UNITS:
+  case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+    *data = 32;
+    break;
+  case GL_MAX_UNIFORM_BUFFER_BINDINGS:
+    *data = 36;
+    break;
+  case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+    *data = 256;
+    break;
+  case GL_CURRENT_PROGRAM:
+    *data = currentProgram;
+    break;
+  default:
+    *data = 0;
+  }
+}
+
+GLenum APIENTRY nullGetError(void) {
+  RECORD("glGetError");
+  return GL_NO_ERROR;
+}
+
+void APIENTRY nullFlush(void) { RECORD("glFlush"); }
+void APIENTRY nullFinish(void) { RECORD("glFinish"); }
+
+void APIENTRY nullViewport(GLint, GLint, GLsizei, GLsizei) {
+  RECORD_STATE("glViewport");
+}
+void APIENTRY nullScissor(GLint, GLint, GLsizei, GLsizei) {
+  RECORD_STATE("glScissor");
+}
+void APIENTRY nullEnable(GLenum) { RECORD_STATE("glEnable"); }
+void APIENTRY nullDisable(GLenum) { RECORD_STATE("glDisable"); }
+void APIENTRY nullBlendFunc(GLenum, GLenum) { RECORD_STATE("glBlendFunc"); }
+void APIENTRY nullDepthFunc(GLenum) { RECORD_STATE("glDepthFunc"); }
+void APIENTRY nullDepthMask(GLboolean) { RECORD_STATE("glDepthMask"); }
+void APIENTRY nullCullFace(GLenum) { RECORD_STATE("glCullFace"); }
+void APIENTRY nullFrontFace(GLenum) { RECORD_STATE("glFrontFace"); }
+void APIENTRY nullPolygonMode(GLenum, GLenum) { RECORD_STATE("glPolygonMode"); }
+void APIENTRY nullPixelStorei(GLenum, GLint) { RECORD_STATE("glPixelStorei"); }
+void APIENTRY nullClearColor(GLfloat, GLfloat, GLfloat, GLfloat) {
+  RECORD_STATE("glClearColor");
+}
+void APIENTRY nullClear(GLbitfield) { RECORD("glClear"); }
+
+// Buffers
+
+void APIENTRY nullGenBuffers(GLsizei n, GLuint *names) {
+  RECORD("glGenBuffers");
+  for (GLsizei i = 0; i < n; i++) {
+    names[i] = newName();
+    buffers[names[i]];
+  }
+}
+
+void APIENTRY nullDeleteBuffers(GLsizei n, const GLuint *names) {
+  RECORD("glDeleteBuffers");
+  for (GLsizei i = 0; i < n; i++) {
+    buffers.erase(names[i]);
+    for (auto &binding : boundBuffers) {
+      if (binding.second == names[i])
+        binding.second = 0;
+    }
+  }
+}
+
+void APIENTRY nullBindBuffer(GLenum target, GLuint buffer) {
+  RECORD_STATE("glBindBuffer");
+  boundBuffers[target] = buffer;
+}
+
+void APIENTRY nullBindBufferBase(GLenum target, GLuint, GLuint buffer) {
+  RECORD_STATE("glBindBufferBase");
+  boundBuffers[target] = buffer;
+}
+
+void APIENTRY nullBindBufferRange(GLenum target, GLuint, GLuint buffer,
+                                  GLintptr, GLsizeiptr) {
+  RECORD_STATE("glBindBufferRange");
+  boundBuffers[target] = buffer;
+}
+
+void APIENTRY nullBufferData(GLenum target, GLsizeiptr size, const void *data,
+                             GLenum) {
+  RECORD("glBufferData");
+  Buffer *buffer = boundBuffer(target);
+  if (!buffer)
+    return;
+
+  buffer->data.assign(size, 0);
+  if (data) {
+    memcpy(buffer->data.data(), data, size);
+    stats.bytesUploaded += size;
+  }
+}
+
+void APIENTRY nullBufferStorage(GLenum target, GLsizeiptr size,
+                                const void *data, GLbitfield) {
+  RECORD("glBufferStorage");
+  Buffer *buffer = boundBuffer(target);
+  if (!buffer)
+    return;
+
+  buffer->data.assign(size, 0);
+  if (data) {
+    memcpy(buffer->data.data(), data, size);
+    stats.bytesUploaded += size;
+  }
+}
+
+void APIENTRY nullBufferSubData(GLenum target, GLintptr offset,
+                                GLsizeiptr size, const void *data) {
+  RECORD("glBufferSubData");
+  Buffer *buffer = boundBuffer(target);
+  if (!buffer || offset + size > (GLintptr)buffer->data.size())
+    return;
+
+  memcpy(buffer->data.data() + offset, data, size);
+  stats.bytesUploaded += size;
+}
+
+void *APIENTRY nullMapBufferRange(GLenum target, GLintptr offset,
+                                  GLsizeiptr length, GLbitfield) {
+  RECORD("glMapBufferRange");
+  Buffer *buffer = boundBuffer(target);
+  if (!buffer || offset + length > (GLintptr)buffer->data.size())
+    return NULL;
+
+  // Whatever is written through the mapping counts as uploaded. Writes to a
+  // persistent mapping after this can't be seen, so they don't count.
+  stats.bytesUploaded += length;
+  return buffer->data.data() + offset;
+}
+
+GLboolean APIENTRY nullUnmapBuffer(GLenum) {
+  RECORD("glUnmapBuffer");
+  return GL_TRUE;
+}
+
+void APIENTRY nullFlushMappedBufferRange(GLenum, GLintptr, GLsizeiptr) {
+  RECORD("glFlushMappedBufferRange");
+}
+
+// Vertex arrays
+
+void APIENTRY nullGenVertexArrays(GLsizei n, GLuint *names) {
+  RECORD("glGenVertexArrays");
+  for (GLsizei i = 0; i < n; i++)
+    names[i] = newName();
+}
+
+void APIENTRY nullDeleteVertexArrays(GLsizei, const GLuint *) {
+  RECORD("glDeleteVertexArrays");
+}
+
+void APIENTRY nullBindVertexArray(GLuint) { RECORD_STATE("glBindVertexArray"); }
+
+void APIENTRY nullVertexAttribPointer(GLuint, GLint, GLenum, GLboolean,
+                                      GLsizei, const void *) {
+  RECORD_STATE("glVertexAttribPointer");
+}
+
+void APIENTRY nullVertexAttribIPointer(GLuint, GLint, GLenum, GLsizei,
+                                       const void *) {
+  RECORD_STATE("glVertexAttribIPointer");
+}
+
+void APIENTRY nullEnableVertexAttribArray(GLuint) {
+  RECORD_STATE("glEnableVertexAttribArray");
+}
+
+void APIENTRY nullDisableVertexAttribArray(GLuint) {
+  RECORD_STATE("glDisableVertexAttribArray");
+}
+
+void APIENTRY nullVertexAttribDivisor(GLuint, GLuint) {
+  RECORD_STATE("glVertexAttribDivisor");
+}
+
+// Textures
+
+void APIENTRY nullGenTextures(GLsizei n, GLuint *names) {
+  RECORD("glGenTextures");
+  for (GLsizei i = 0; i < n; i++) {
+    names[i] = newName();
+    textures[names[i]];
+  }
+}
+
+void APIENTRY nullDeleteTextures(GLsizei n, const GLuint *names) {
+  RECORD("glDeleteTextures");
+  for (GLsizei i = 0; i < n; i++)
+    textures.erase(names[i]);
+}
+
+void APIENTRY nullActiveTexture(GLenum unit) {
+  RECORD_STATE("glActiveTexture");
+  activeUnit = unit;
+}
+
+void APIENTRY nullBindTexture(GLenum target, GLuint texture) {
+  RECORD_STATE("glBindTexture");
+  boundTextures[textureBinding(target)] = texture;
+}
+
+void APIENTRY nullTexParameteri(GLenum, GLenum, GLint) {
+  RECORD_STATE("glTexParameteri");
+}
+
+void APIENTRY nullTexImage2D(GLenum target, GLint level, GLint, GLsizei width,
+                             GLsizei height, GLint, GLenum format, GLenum type,
+                             const void *pixels) {
+  RECORD("glTexImage2D");
+  size_t bytes = (size_t)width * height * pixelBytes(format, type);
+  if (pixels)
+    stats.bytesUploaded += bytes;
+
+  // Only level 0 is kept
+  auto texture = textures.find(boundTextures[textureBinding(target)]);
+  if (level != 0 || texture == textures.end())
+    return;
+
+  texture->second.width = width;
+  texture->second.height = height;
+  texture->second.data.assign(bytes, 0);
+  if (pixels)
+    memcpy(texture->second.data.data(), pixels, bytes);
+}
+
+void APIENTRY nullTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei width,
+                                GLsizei height, GLenum format, GLenum type,
+                                const void *) {
+  RECORD("glTexSubImage2D");
+  stats.bytesUploaded += (size_t)width * height * pixelBytes(format, type);
+}
+
+void APIENTRY nullGenerateMipmap(GLenum) { RECORD("glGenerateMipmap"); }
+
+// Shaders and programs
+
+GLuint APIENTRY nullCreateShader(GLenum type) {
+  RECORD("glCreateShader");
+  GLuint name = newName();
+  shaderObjects[name].type = type;
+  return name;
+}
+
+void APIENTRY nullDeleteShader(GLuint shader) {
+  RECORD("glDeleteShader");
+  shaderObjects.erase(shader);
+}
+
+void APIENTRY nullShaderSource(GLuint shader, GLsizei count,
+                               const GLchar *const *strings,
+                               const GLint *lengths) {
+  RECORD("glShaderSource");
+  string &source = shaderObjects[shader].source;
+  source.clear();
+  for (GLsizei i = 0; i < count; i++) {
+    if (lengths && lengths[i] >= 0)
+      source.append(strings[i], lengths[i]);
+    else
+      source.append(strings[i]);
+  }
+}
+
+void APIENTRY nullCompileShader(GLuint) { RECORD("glCompileShader"); }
+
+void APIENTRY nullGetShaderiv(GLuint, GLenum pname, GLint *params) {
+  RECORD("glGetShaderiv");
+  *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+void APIENTRY nullGetShaderInfoLog(GLuint, GLsizei bufSize, GLsizei *length,
+                                   GLchar *infoLog) {
+  RECORD("glGetShaderInfoLog");
+  if (length)
+    *length = 0;
+  if (bufSize > 0)
+    infoLog[0] = '\0';
+}
+
+GLuint APIENTRY nullCreateProgram(void) {
+  RECORD("glCreateProgram");
+  GLuint name = newName();
+  programs[name];
+  return name;
+}
+
+void APIENTRY nullDeleteProgram(GLuint program) {
+  RECORD("glDeleteProgram");
+  programs.erase(program);
+}
+
+void APIENTRY nullAttachShader(GLuint program, GLuint shader) {
+  RECORD("glAttachShader");
+  programs[program].shaders.push_back(shader);
+}
+
+void APIENTRY nullDetachShader(GLuint program, GLuint shader) {
+  RECORD("glDetachShader");
+  vector<GLuint> &attached = programs[program].shaders;
+  attached.erase(remove(attached.begin(), attached.end(), shader),
+                 attached.end());
+}
+
+void APIENTRY nullLinkProgram(GLuint name) {
+  RECORD("glLinkProgram");
+  Program &program = programs[name];
+  program.uniforms.clear();
+  program.uniformAtLocation.clear();
+  program.blocks.clear();
+
+  for (GLuint shader : program.shaders)
+    parseUniforms(shaderObjects[shader].source, program);
+
+  for (size_t i = 0; i < program.uniforms.size(); i++) {
+    UniformDecl &decl = program.uniforms[i];
+    decl.location = (GLint)program.uniformAtLocation.size();
+    decl.value.assign(decl.size * 16, 0);
+    program.uniformAtLocation.insert(program.uniformAtLocation.end(),
+                                     decl.size, (int)i);
+  }
+}
+
+void APIENTRY nullGetProgramiv(GLuint name, GLenum pname, GLint *params) {
+  RECORD("glGetProgramiv");
+  const Program &program = programs[name];
+  switch (pname) {
+  case GL_LINK_STATUS:
+  case GL_VALIDATE_STATUS:
+    *params = GL_TRUE;
+    break;
+  case GL_ACTIVE_UNIFORMS:
+    *params = (GLint)program.uniforms.size();
+    break;
+  case GL_ACTIVE_UNIFORM_MAX_LENGTH: {
+    size_t longest = 0;
+    for (const UniformDecl &decl : program.uniforms)
+      longest = max(longest, decl.name.size() + 4);
+    *params = (GLint)longest;
+    break;
+  }
+  case GL_ACTIVE_UNIFORM_BLOCKS:
+    *params = (GLint)program.blocks.size();
+    break;
+  case GL_ATTACHED_SHADERS:
+    *params = (GLint)program.shaders.size();
+    break;
+  default:
+    *params = 0;
+  }
+}
+
+void APIENTRY nullGetProgramInfoLog(GLuint, GLsizei bufSize, GLsizei *length,
+                                    GLchar *infoLog) {
+  RECORD("glGetProgramInfoLog");
+  if (length)
+    *length = 0;
+  if (bufSize > 0)
+    infoLog[0] = '\0';
+}
+
+void APIENTRY nullUseProgram(GLuint program) {
+  RECORD_STATE("glUseProgram");
+  currentProgram = program;
+}
+
+void APIENTRY nullGetActiveUniform(GLuint name, GLuint index, GLsizei bufSize,
+                                   GLsizei *length, GLint *size, GLenum *type,
+                                   GLchar *uniformName) {
+  RECORD("glGetActiveUniform");
+  const Program &program = programs[name];
+  if (index >= program.uniforms.size() || bufSize <= 0)
+    return;
+
+  const UniformDecl &decl = program.uniforms[index];
+  string reported = decl.size > 1 ? decl.name + "[0]" : decl.name;
+  GLsizei written = min((GLsizei)reported.size(), bufSize - 1);
+  memcpy(uniformName, reported.c_str(), written);
+  uniformName[written] = '\0';
+
+  if (length)
+    *length = written;
+  *size = decl.size;
+  *type = decl.type;
+}
+
+GLint APIENTRY nullGetUniformLocation(GLuint name, const GLchar *uniformName) {
+  RECORD("glGetUniformLocation");
+  string lookup = uniformName;
+  int element = 0;
+
+  size_t bracket = lookup.find('[');
+  if (bracket != string::npos) {
+    element = atoi(lookup.c_str() + bracket + 1);
+    lookup.resize(bracket);
+  }
+
+  for (const UniformDecl &decl : programs[name].uniforms) {
+    if (decl.name == lookup)
+      return element < decl.size ? decl.location + element : -1;
+  }
+  return -1;
+}
+
+GLuint APIENTRY nullGetUniformBlockIndex(GLuint name, const GLchar *blockName) {
+  RECORD("glGetUniformBlockIndex");
+  const vector<string> &blocks = programs[name].blocks;
+  for (size_t i = 0; i < blocks.size(); i++) {
+    if (blocks[i] == blockName)
+      return (GLuint)i;
+  }
+  return 0xFFFFFFFFu;
+}
+
+void APIENTRY nullUniformBlockBinding(GLuint, GLuint, GLuint) {
+  RECORD_STATE("glUniformBlockBinding");
+}
+
+void APIENTRY nullGetUniformfv(GLuint program, GLint location,
+                               GLfloat *params) {
+  RECORD("glGetUniformfv");
+  getUniform(program, location, params);
+}
+
+void APIENTRY nullGetUniformiv(GLuint program, GLint location, GLint *params) {
+  RECORD("glGetUniformiv");
+  getUniform(program, location, params);
+}
+
+void APIENTRY nullGetUniformuiv(GLuint program, GLint location,
+                                GLuint *params) {
+  RECORD("glGetUniformuiv");
+  getUniform(program, location, params);
+}
+
+#define NULL_UNIFORM_V(suffix, Type, words)                                    \
+  void APIENTRY nullUniform##suffix(GLint location, GLsizei count,             \
+                                    const Type *value) {                       \
+    RECORD_STATE("glUniform" #suffix);                                         \
+    setUniform(location, count, value, words);                                 \
+  }
+
+#define NULL_UNIFORM_MATRIX(suffix, words)                                     \
+  void APIENTRY nullUniformMatrix##suffix(GLint location, GLsizei count,       \
+                                          GLboolean, const GLfloat *value) {   \
+    RECORD_STATE("glUniformMatrix" #suffix);                                   \
+    setUniform(location, count, value, words);                                 \
+  }
+
+NULL_UNIFORM_V(1fv, GLfloat, 1)
+NULL_UNIFORM_V(2fv, GLfloat, 2)
+NULL_UNIFORM_V(3fv, GLfloat, 3)
+NULL_UNIFORM_V(4fv, GLfloat, 4)
+NULL_UNIFORM_V(1iv, GLint, 1)
+NULL_UNIFORM_V(2iv, GLint, 2)
+NULL_UNIFORM_V(3iv, GLint, 3)
+NULL_UNIFORM_V(4iv, GLint, 4)
+NULL_UNIFORM_V(1uiv, GLuint, 1)
+NULL_UNIFORM_V(2uiv, GLuint, 2)
+NULL_UNIFORM_V(3uiv, GLuint, 3)
+NULL_UNIFORM_V(4uiv, GLuint, 4)
+NULL_UNIFORM_MATRIX(2fv, 4)
+NULL_UNIFORM_MATRIX(3fv, 9)
+NULL_UNIFORM_MATRIX(4fv, 16)
+
+void APIENTRY nullUniform1f(GLint location, GLfloat v0) {
+  RECORD_STATE("glUniform1f");
+  setUniform(location, 1, &v0, 1);
+}
+
+void APIENTRY nullUniform3f(GLint location, GLfloat v0, GLfloat v1,
+                            GLfloat v2) {
+  RECORD_STATE("glUniform3f");
+  GLfloat value[3] = {v0, v1, v2};
+  setUniform(location, 1, value, 3);
+}
+
+void APIENTRY nullUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2,
+                            GLfloat v3) {
+  RECORD_STATE("glUniform4f");
+  GLfloat value[4] = {v0, v1, v2, v3};
+  setUniform(location, 1, value, 4);
+}
+
+void APIENTRY nullUniform1i(GLint location, GLint v0) {
+  RECORD_STATE("glUniform1i");
+  setUniform(location, 1, &v0, 1);
+}
+
+// Draws
+
+void APIENTRY nullDrawArrays(GLenum, GLint, GLsizei count) {
+  RECORD("glDrawArrays");
+  stats.drawCalls++;
+  stats.instances++;
+  stats.vertices += count;
+}
+
+void APIENTRY nullDrawElements(GLenum, GLsizei count, GLenum, const void *) {
+  RECORD("glDrawElements");
+  stats.drawCalls++;
+  stats.instances++;
+  stats.vertices += count;
+}
+
+void APIENTRY nullDrawArraysInstanced(GLenum, GLint, GLsizei count,
+                                      GLsizei instancecount) {
+  RECORD("glDrawArraysInstanced");
+  stats.drawCalls++;
+  stats.instances += instancecount;
+  stats.vertices += (uint64_t)count * instancecount;
+}
+
+void APIENTRY nullDrawElementsInstanced(GLenum, GLsizei count, GLenum,
+                                        const void *, GLsizei instancecount) {
+  RECORD("glDrawElementsInstanced");
+  stats.drawCalls++;
+  stats.instances += instancecount;
+  stats.vertices += (uint64_t)count * instancecount;
+}
+
+// Synchronization: the null GPU is always done
+
+GLsync APIENTRY nullFenceSync(GLenum, GLbitfield) {
+  RECORD("glFenceSync");
+  return (GLsync)(uintptr_t)newName();
+}
+
+void APIENTRY nullDeleteSync(GLsync) { RECORD("glDeleteSync"); }
+
+GLenum APIENTRY nullClientWaitSync(GLsync, GLbitfield, GLuint64) {
+  RECORD("glClientWaitSync");
+  return GL_ALREADY_SIGNALED;
+}
+
+void APIENTRY nullWaitSync(GLsync, GLbitfield, GLuint64) {
+  RECORD("glWaitSync");
+}
+
+} // namespace
+
+int gladLoadGLNull(void) {
+  GLVersion.major = 3;
+  GLVersion.minor = 3;
+  GLAD_GL_VERSION_1_0 = GLAD_GL_VERSION_1_1 = GLAD_GL_VERSION_1_2 = 1;
+  GLAD_GL_VERSION_1_3 = GLAD_GL_VERSION_1_4 = GLAD_GL_VERSION_1_5 = 1;
+  GLAD_GL_VERSION_2_0 = GLAD_GL_VERSION_2_1 = 1;
+  GLAD_GL_VERSION_3_0 = GLAD_GL_VERSION_3_1 = GLAD_GL_VERSION_3_2 = 1;
+  GLAD_GL_VERSION_3_3 = 1;
+  GLAD_GL_VERSION_4_0 = 0;
+  GLAD_GL_ARB_buffer_storage = 1;
+
+  glad_glGetString = nullGetString;
+  glad_glGetIntegerv = nullGetIntegerv;
+  glad_glGetError = nullGetError;
+  glad_glFlush = nullFlush;
+  glad_glFinish = nullFinish;
+
+  glad_glViewport = nullViewport;
+  glad_glScissor = nullScissor;
+  glad_glEnable = nullEnable;
+  glad_glDisable = nullDisable;
+  glad_glBlendFunc = nullBlendFunc;
+  glad_glDepthFunc = nullDepthFunc;
+  glad_glDepthMask = nullDepthMask;
+  glad_glCullFace = nullCullFace;
+  glad_glFrontFace = nullFrontFace;
+  glad_glPolygonMode = nullPolygonMode;
+  glad_glPixelStorei = nullPixelStorei;
+  glad_glClearColor = nullClearColor;
+  glad_glClear = nullClear;
+
+  glad_glGenBuffers = nullGenBuffers;
+  glad_glDeleteBuffers = nullDeleteBuffers;
+  glad_glBindBuffer = nullBindBuffer;
+  glad_glBindBufferBase = nullBindBufferBase;
+  glad_glBindBufferRange = nullBindBufferRange;
+  glad_glBufferData = nullBufferData;
+  glad_glBufferSubData = nullBufferSubData;
+  glad_glBufferStorage = nullBufferStorage;
+  glad_glMapBufferRange = nullMapBufferRange;
+  glad_glUnmapBuffer = nullUnmapBuffer;
+  glad_glFlushMappedBufferRange = nullFlushMappedBufferRange;
+
+  glad_glGenVertexArrays = nullGenVertexArrays;
+  glad_glDeleteVertexArrays = nullDeleteVertexArrays;
+  glad_glBindVertexArray = nullBindVertexArray;
+  glad_glVertexAttribPointer = nullVertexAttribPointer;
+  glad_glVertexAttribIPointer = nullVertexAttribIPointer;
+  glad_glEnableVertexAttribArray = nullEnableVertexAttribArray;
+  glad_glDisableVertexAttribArray = nullDisableVertexAttribArray;
+  glad_glVertexAttribDivisor = nullVertexAttribDivisor;
+
+  glad_glGenTextures = nullGenTextures;
+  glad_glDeleteTextures = nullDeleteTextures;
+  glad_glActiveTexture = nullActiveTexture;
+  glad_glBindTexture = nullBindTexture;
+  glad_glTexParameteri = nullTexParameteri;
+  glad_glTexImage2D = nullTexImage2D;
+  glad_glTexSubImage2D = nullTexSubImage2D;
+  glad_glGenerateMipmap = nullGenerateMipmap;
+
+  glad_glCreateShader = nullCreateShader;
+  glad_glDeleteShader = nullDeleteShader;
+  glad_glShaderSource = nullShaderSource;
+  glad_glCompileShader = nullCompileShader;
+  glad_glGetShaderiv = nullGetShaderiv;
+  glad_glGetShaderInfoLog = nullGetShaderInfoLog;
+  glad_glCreateProgram = nullCreateProgram;
+  glad_glDeleteProgram = nullDeleteProgram;
+  glad_glAttachShader = nullAttachShader;
+  glad_glDetachShader = nullDetachShader;
+  glad_glLinkProgram = nullLinkProgram;
+  glad_glGetProgramiv = nullGetProgramiv;
+  glad_glGetProgramInfoLog = nullGetProgramInfoLog;
+  glad_glUseProgram = nullUseProgram;
+  glad_glGetActiveUniform = nullGetActiveUniform;
+  glad_glGetUniformLocation = nullGetUniformLocation;
+  glad_glGetUniformBlockIndex = nullGetUniformBlockIndex;
+  glad_glUniformBlockBinding = nullUniformBlockBinding;
+  glad_glGetUniformfv = nullGetUniformfv;
+  glad_glGetUniformiv = nullGetUniformiv;
+  glad_glGetUniformuiv = nullGetUniformuiv;
+
+  glad_glUniform1fv = nullUniform1fv;
+  glad_glUniform2fv = nullUniform2fv;
+  glad_glUniform3fv = nullUniform3fv;
+  glad_glUniform4fv = nullUniform4fv;
+  glad_glUniform1iv = nullUniform1iv;
+  glad_glUniform2iv = nullUniform2iv;
+  glad_glUniform3iv = nullUniform3iv;
+  glad_glUniform4iv = nullUniform4iv;
+  glad_glUniform1uiv = nullUniform1uiv;
+  glad_glUniform2uiv = nullUniform2uiv;
+  glad_glUniform3uiv = nullUniform3uiv;
+  glad_glUniform4uiv = nullUniform4uiv;
+  glad_glUniformMatrix2fv = nullUniformMatrix2fv;
+  glad_glUniformMatrix3fv = nullUniformMatrix3fv;
+  glad_glUniformMatrix4fv = nullUniformMatrix4fv;
+  glad_glUniform1f = nullUniform1f;
+  glad_glUniform3f = nullUniform3f;
+  glad_glUniform4f = nullUniform4f;
+  glad_glUniform1i = nullUniform1i;
+
+  glad_glDrawArrays = nullDrawArrays;
+  glad_glDrawElements = nullDrawElements;
+  glad_glDrawArraysInstanced = nullDrawArraysInstanced;
+  glad_glDrawElementsInstanced = nullDrawElementsInstanced;
+
+  glad_glFenceSync = nullFenceSync;
+  glad_glDeleteSync = nullDeleteSync;
+  glad_glClientWaitSync = nullClientWaitSync;
+  glad_glWaitSync = nullWaitSync;
+
+  return 1;
+}
+
+const NullGLStats &nullGLStats() { return stats; }
+
+void nullGLResetStats() {
+  memset(&stats, 0, sizeof(stats));
+  for (CallCounter *counter : callCounters())
+    counter->count = 0;
+}
+
+void nullGLPrintStats() {
+  cout << "Null GL: " << stats.calls << " calls, " << stats.drawCalls
+       << " draws, " << stats.instances << " instances, " << stats.vertices
+       << " vertices, " << stats.bytesUploaded << " bytes uploaded, "
+       << stats.stateChanges << " state changes, " << stats.objectsCreated
+       << " objects created" << endl;
+
+  vector<CallCounter *> counters = callCounters();
+  sort(counters.begin(), counters.end(),
+       [](const CallCounter *a, const CallCounter *b) {
+         return a->count > b->count;
+       });
+  for (const CallCounter *counter : counters) {
+    if (counter->count > 0)
+      cout << "  " << counter->name << ": " << counter->count << endl;
+  }
+}
+
+const void *nullGLBufferData(GLuint buffer, GLsizeiptr *size) {
+  auto found = buffers.find(buffer);
+  if (found == buffers.end()) {
+    *size = 0;
+    return NULL;
+  }
+  *size = (GLsizeiptr)found->second.data.size();
+  return found->second.data.data();
+}
+
+const void *nullGLTextureData(GLuint texture, GLsizei *width,
+                              GLsizei *height) {
+  auto found = textures.find(texture);
+  if (found == textures.end()) {
+    *width = *height = 0;
+    return NULL;
+  }
+  *width = found->second.width;
+  *height = found->second.height;
+  return found->second.data.data();
+}
@@ -0,0 +1,38 @@
+#ifndef NULL_GL_H
+#define NULL_GL_H
+
+#include <glad/glad.h> // include glad to get all the required OpenGL headers
+
+#include <stdint.h>
+
+/* A GL 3.3 "driver" that draws nothing. gladLoadGLNull() fills the same
+ glad_gl* pointers gladLoadGLLoader() would, with functions that hand out
+ object names, keep buffer and texture contents in RAM, parse the uniforms
+ out of the shader sources, and count what the app asks for. Render loops
+ run unchanged on machines without a GPU, so their CPU cost can be measured.
+ */
+struct NullGLStats {
+  uint64_t calls;
+  uint64_t drawCalls;
+  uint64_t instances;
+  uint64_t vertices;
+  uint64_t bytesUploaded;
+  uint64_t stateChanges;
+  uint64_t objectsCreated;
+};
+
+// Returns 1 on success, like gladLoadGLLoader
+int gladLoadGLNull(void);
+
+const NullGLStats &nullGLStats();
+void nullGLResetStats();
+
+// Totals, then the per-entry-point call counts, most called first
+void nullGLPrintStats();
+
+// Contents of a buffer or of level 0 of a texture, for inspection
+const void *nullGLBufferData(GLuint buffer, GLsizeiptr *size);
+const void *nullGLTextureData(GLuint texture, GLsizei *width,
+                              GLsizei *height);
+
+#endif
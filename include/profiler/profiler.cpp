@@ -0,0 +1,336 @@
+#include "profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_HAS_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PROFILER_HAS_TSC
+#endif
+
+using namespace std;
+
+Profiler profiler;
+
+// Clock
+
+namespace {
+
+struct ClockOrigin {
+  uint64_t ticks;
+  chrono::steady_clock::time_point time;
+  double ticksPerMicrosecond;
+};
+
+ClockOrigin &clockOrigin() {
+  static ClockOrigin origin = {profilerTicks(), chrono::steady_clock::now(),
+                               0.0};
+  return origin;
+}
+
+// The TSC rate is measured against the steady clock over the whole run so
+// far, and frozen once that is long enough to be accurate.
+double ticksPerMicrosecond() {
+#ifdef PROFILER_HAS_TSC
+  ClockOrigin &origin = clockOrigin();
+  if (origin.ticksPerMicrosecond > 0.0)
+    return origin.ticksPerMicrosecond;
+
+  double elapsed = chrono::duration<double, micro>(chrono::steady_clock::now() -
+                                                   origin.time)
+                       .count();
+  if (elapsed <= 0.0)
+    return 1000.0;
+
+  double rate = (profilerTicks() - origin.ticks) / elapsed;
+  if (elapsed > 200000.0)
+    origin.ticksPerMicrosecond = rate;
+  return rate;
+#else
+  return 1000.0;
+#endif
+}
+
+mutex ringsMutex;
+vector<unique_ptr<ProfileRing>> &rings() {
+  static vector<unique_ptr<ProfileRing>> allRings;
+  return allRings;
+}
+
+} // namespace
+
+uint64_t profilerTicks() {
+#ifdef PROFILER_HAS_TSC
+  return __rdtsc();
+#else
+  return chrono::duration_cast<chrono::nanoseconds>(
+             chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+double profilerTicksToMicroseconds(uint64_t ticks) {
+  return ticks / ticksPerMicrosecond();
+}
+
+// Per-thread rings
+
+ProfileRing::ProfileRing(uint32_t threadId)
+    : thread(threadId), depth(0), dropped(0), head(0), tail(0) {}
+
+void ProfileRing::push(const ProfileEvent &event) {
+  uint32_t h = head.load(memory_order_relaxed);
+  if (h - tail.load(memory_order_acquire) >= capacity) {
+    dropped.fetch_add(1, memory_order_relaxed);
+    return;
+  }
+  events[h & (capacity - 1)] = event;
+  head.store(h + 1, memory_order_release);
+}
+
+ProfileRing &Profiler::threadRing() {
+  thread_local ProfileRing *ring = NULL;
+  if (!ring) {
+    lock_guard<mutex> lock(ringsMutex);
+    rings().push_back(unique_ptr<ProfileRing>(
+        new ProfileRing((uint32_t)rings().size())));
+    ring = rings().back().get();
+  }
+  return *ring;
+}
+
+ProfileZone::ProfileZone(const char *zoneName) {
+  name = zoneName;
+  ring = &Profiler::threadRing();
+  ring->depth++;
+  start = profilerTicks();
+}
+
+ProfileZone::~ProfileZone() {
+  uint64_t end = profilerTicks();
+  ring->depth--;
+  ring->push(ProfileEvent{name, start, end, ring->depth, ring->thread});
+}
+
+// Profiler
+
+Profiler::Profiler() {
+  clockOrigin();
+  frame = 0;
+  frameStart = 0;
+  summaryInterval = 0;
+  tracing = false;
+  maxTraceEvents = 0;
+  gpuAvailable = false;
+  gpuZoneOpen = false;
+  gpuDropped = 0;
+  memset(gpuFrames, 0, sizeof(gpuFrames));
+}
+
+void Profiler::initGpu() {
+  // Core since 3.3 (ARB_timer_query), but a loader may still leave them out
+  gpuAvailable = GLAD_GL_VERSION_3_3 && glad_glGenQueries &&
+                 glad_glDeleteQueries && glad_glBeginQuery &&
+                 glad_glEndQuery && glad_glGetQueryObjectiv &&
+                 glad_glGetQueryObjectui64v;
+  if (!gpuAvailable)
+    return;
+
+  for (GpuFrame &gpuFrame : gpuFrames)
+    glGenQueries(maxGpuZonesPerFrame, gpuFrame.queries);
+}
+
+bool Profiler::gpuTimingAvailable() const { return gpuAvailable; }
+
+void Profiler::cleanupGpu() {
+  if (!gpuAvailable)
+    return;
+
+  for (GpuFrame &gpuFrame : gpuFrames)
+    glDeleteQueries(maxGpuZonesPerFrame, gpuFrame.queries);
+  gpuAvailable = false;
+}
+
+void Profiler::beginFrame() {
+  frameStart = profilerTicks();
+
+  GpuFrame &gpuFrame = gpuFrames[frame % gpuLatency];
+  if (gpuFrame.pending) {
+    collectGpu(gpuFrame);
+    if (gpuFrame.pending) {
+      // Still not done after gpuLatency frames: reuse the queries anyway
+      gpuDropped += gpuFrame.count;
+      gpuFrame.pending = false;
+    }
+  }
+  gpuFrame.count = 0;
+  gpuFrame.frameStart = frameStart;
+}
+
+void Profiler::endFrame() {
+  if (gpuZoneOpen)
+    endGpuZone();
+
+  ProfileRing &ring = threadRing();
+  ring.push(ProfileEvent{"Frame", frameStart, profilerTicks(), ring.depth,
+                         ring.thread});
+
+  {
+    lock_guard<mutex> lock(ringsMutex);
+    for (auto &threadRing : rings())
+      threadRing->drain(
+          [this](const ProfileEvent &event) { record(event, false); });
+  }
+
+  gpuFrames[frame % gpuLatency].pending =
+      gpuFrames[frame % gpuLatency].count > 0;
+  for (unsigned int i = 1; i < gpuLatency; i++) {
+    GpuFrame &older = gpuFrames[(frame + i) % gpuLatency];
+    if (older.pending)
+      collectGpu(older);
+  }
+
+  // Exponential moving average over roughly the last 32 frames
+  for (ZoneAverage &zone : averages) {
+    if (!zone.gpu || zone.frameMicroseconds > 0.0) {
+      zone.average += (zone.frameMicroseconds - zone.average) / 32.0;
+      zone.frameMicroseconds = 0.0;
+    }
+  }
+
+  frame++;
+  if (summaryInterval && frame % summaryInterval == 0)
+    printSummary();
+}
+
+void Profiler::beginGpuZone(const char *name) {
+  GpuFrame &gpuFrame = gpuFrames[frame % gpuLatency];
+  if (!gpuAvailable || gpuZoneOpen || gpuFrame.count >= maxGpuZonesPerFrame)
+    return;
+
+  gpuFrame.names[gpuFrame.count] = name;
+  glBeginQuery(GL_TIME_ELAPSED, gpuFrame.queries[gpuFrame.count]);
+  gpuZoneOpen = true;
+}
+
+void Profiler::endGpuZone() {
+  if (!gpuZoneOpen)
+    return;
+
+  glEndQuery(GL_TIME_ELAPSED);
+  gpuFrames[frame % gpuLatency].count++;
+  gpuZoneOpen = false;
+}
+
+// Queries of a frame finish in order, so the last one being available means
+// all of them are.
+void Profiler::collectGpu(GpuFrame &gpuFrame) {
+  if (!gpuFrame.pending || gpuFrame.count == 0)
+    return;
+
+  GLint available = GL_FALSE;
+  glGetQueryObjectiv(gpuFrame.queries[gpuFrame.count - 1],
+                     GL_QUERY_RESULT_AVAILABLE, &available);
+  if (!available)
+    return;
+
+  // Durations only: lay the zones out back to back from the frame start
+  uint64_t start = gpuFrame.frameStart;
+  double rate = ticksPerMicrosecond();
+  for (unsigned int i = 0; i < gpuFrame.count; i++) {
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(gpuFrame.queries[i], GL_QUERY_RESULT, &nanoseconds);
+
+    uint64_t end = start + (uint64_t)(nanoseconds / 1000.0 * rate);
+    record(ProfileEvent{gpuFrame.names[i], start, end, 0, profilerGpuThread},
+           true);
+    start = end;
+  }
+  gpuFrame.pending = false;
+}
+
+void Profiler::record(const ProfileEvent &event, bool gpu) {
+  accumulate(event.name, gpu,
+             profilerTicksToMicroseconds(event.end - event.start));
+  if (tracing && trace.size() < maxTraceEvents)
+    trace.push_back(event);
+}
+
+void Profiler::accumulate(const char *name, bool gpu, double microseconds) {
+  for (ZoneAverage &zone : averages) {
+    if (zone.gpu == gpu &&
+        (zone.name == name || strcmp(zone.name, name) == 0)) {
+      zone.frameMicroseconds += microseconds;
+      return;
+    }
+  }
+  averages.push_back(ZoneAverage{name, gpu, microseconds, microseconds});
+}
+
+void Profiler::captureTrace(bool enabled, size_t maxEvents) {
+  tracing = enabled;
+  maxTraceEvents = maxEvents;
+  if (enabled)
+    trace.reserve(min(maxEvents, (size_t)1 << 16));
+}
+
+void Profiler::setSummaryInterval(unsigned int frames) {
+  summaryInterval = frames;
+}
+
+void Profiler::printSummary() const {
+  cout << "Profile after " << frame << " frames (average ms per frame)";
+  if (!gpuAvailable)
+    cout << ", no GPU timer queries";
+  cout << endl;
+
+  for (const ZoneAverage &zone : averages)
+    cout << "  " << (zone.gpu ? "GPU " : "CPU ") << zone.name << ": "
+         << zone.average / 1000.0 << endl;
+
+  uint64_t dropped = gpuDropped;
+  for (auto &ring : rings())
+    dropped += ring->dropped.load(memory_order_relaxed);
+  if (dropped)
+    cout << "  " << dropped << " events dropped" << endl;
+}
+
+static void writeJsonString(ofstream &out, const char *text) {
+  out << '"';
+  for (; *text; text++) {
+    if (*text == '"' || *text == '\\')
+      out << '\\';
+    out << *text;
+  }
+  out << '"';
+}
+
+// Chrome's trace event format: load the file in chrome://tracing or Perfetto
+bool Profiler::writeChromeTrace(const string &path) const {
+  ofstream out(path);
+  if (!out.is_open())
+    return false;
+
+  uint64_t origin = clockOrigin().ticks;
+  out << "{\"traceEvents\":[\n";
+  out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+      << profilerGpuThread << ",\"args\":{\"name\":\"GPU\"}}";
+
+  for (const ProfileEvent &event : trace) {
+    out << ",\n{\"name\":";
+    writeJsonString(out, event.name);
+    out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+        << ",\"ts\":" << profilerTicksToMicroseconds(event.start - origin)
+        << ",\"dur\":" << profilerTicksToMicroseconds(event.end - event.start)
+        << "}";
+  }
+  out << "\n]}\n";
+  return out.good();
+}
@@ -0,0 +1,147 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glad/glad.h> // include glad to get all the required OpenGL headers
+
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Cheap timestamp: the TSC on x86, the steady clock elsewhere
+uint64_t profilerTicks();
+double profilerTicksToMicroseconds(uint64_t ticks);
+
+struct ProfileEvent {
+  const char *name;
+  uint64_t start, end;
+  uint32_t depth;
+  uint32_t thread;
+};
+
+/* Events of one thread. Only that thread writes and only the profiler reads,
+ so a single-producer single-consumer ring needs no locks. When it is full,
+ new events are dropped rather than blocking the thread being measured.
+ */
+class ProfileRing {
+public:
+  static const uint32_t capacity = 1 << 14;
+
+  ProfileRing(uint32_t thread);
+
+  uint32_t thread;
+  uint32_t depth;
+  atomic<uint64_t> dropped;
+
+  void push(const ProfileEvent &event);
+  template <typename F> void drain(F &&consume);
+
+private:
+  ProfileEvent events[capacity];
+  atomic<uint32_t> head, tail;
+};
+
+template <typename F> void ProfileRing::drain(F &&consume) {
+  uint32_t last = head.load(memory_order_acquire);
+  uint32_t first = tail.load(memory_order_relaxed);
+  for (uint32_t i = first; i != last; i++)
+    consume(events[i & (capacity - 1)]);
+  tail.store(last, memory_order_release);
+}
+
+// Times a scope on the calling thread
+class ProfileZone {
+public:
+  ProfileZone(const char *name);
+  ~ProfileZone();
+
+private:
+  const char *name;
+  uint64_t start;
+  ProfileRing *ring;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+/* Collects the zones of every thread once per frame, keeps a rolling average
+ per zone, and optionally a full trace for chrome://tracing. GPU zones are
+ measured with GL_TIME_ELAPSED queries that are read back a few frames later,
+ and only once their results are available, so the CPU never waits on them.
+ Zone names must be string literals (or otherwise outlive the profiler).
+ */
+class Profiler {
+public:
+  // Frames a GPU query may stay in flight before its result is given up on
+  static const unsigned int gpuLatency = 4;
+  static const unsigned int maxGpuZonesPerFrame = 16;
+
+  Profiler();
+
+  // Needs a GL context; without timer queries GPU zones are ignored
+  void initGpu();
+  bool gpuTimingAvailable() const;
+
+  void beginFrame();
+  void endFrame();
+
+  // GL_TIME_ELAPSED queries cannot nest, so neither can GPU zones
+  void beginGpuZone(const char *name);
+  void endGpuZone();
+
+  // Keep every event for writeChromeTrace(), up to maxEvents
+  void captureTrace(bool enabled, size_t maxEvents = 1 << 20);
+  bool writeChromeTrace(const string &path) const;
+
+  // Print the rolling averages every `frames` frames (0 disables)
+  void setSummaryInterval(unsigned int frames);
+  void printSummary() const;
+
+  void cleanupGpu();
+
+  static ProfileRing &threadRing();
+
+private:
+  struct ZoneAverage {
+    const char *name;
+    bool gpu;
+    double frameMicroseconds;
+    double average;
+  };
+
+  struct GpuFrame {
+    GLuint queries[maxGpuZonesPerFrame];
+    const char *names[maxGpuZonesPerFrame];
+    unsigned int count;
+    uint64_t frameStart;
+    bool pending;
+  };
+
+  uint64_t frame;
+  uint64_t frameStart;
+  unsigned int summaryInterval;
+
+  bool tracing;
+  size_t maxTraceEvents;
+  vector<ProfileEvent> trace;
+  vector<ZoneAverage> averages;
+
+  bool gpuAvailable;
+  bool gpuZoneOpen;
+  GpuFrame gpuFrames[gpuLatency];
+  uint64_t gpuDropped;
+
+  void collectGpu(GpuFrame &gpuFrame);
+  void accumulate(const char *name, bool gpu, double microseconds);
+  void record(const ProfileEvent &event, bool gpu);
+};
+
+// Thread id used for the GPU track in traces
+static const uint32_t profilerGpuThread = 0xFFFFu;
+
+extern Profiler profiler;
+
+#endif
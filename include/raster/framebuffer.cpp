@@ -0,0 +1,58 @@
+#include "framebuffer.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+Framebuffer::Framebuffer() {
+  width = 0;
+  height = 0;
+}
+
+void Framebuffer::resize(int newWidth, int newHeight) {
+  width = newWidth;
+  height = newHeight;
+  color.assign((size_t)width * height, 0);
+  depth.assign((size_t)width * height, 1.0f);
+}
+
+void Framebuffer::clear(const glm::vec4 &clearColor, float clearDepth) {
+  fill(color.begin(), color.end(), packColor(clearColor));
+  fill(depth.begin(), depth.end(), clearDepth);
+}
+
+bool Framebuffer::writePPM(const string &path) const {
+  FILE *file = fopen(path.c_str(), "wb");
+  if (!file)
+    return false;
+  fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+  vector<unsigned char> row(width * 3);
+  for (int y = height - 1; y >= 0; y--) {
+    for (int x = 0; x < width; x++) {
+      uint32_t pixel = color[(size_t)y * width + x];
+      row[x * 3] = pixel & 0xFF;
+      row[x * 3 + 1] = (pixel >> 8) & 0xFF;
+      row[x * 3 + 2] = (pixel >> 16) & 0xFF;
+    }
+    fwrite(row.data(), 1, row.size(), file);
+  }
+  bool written = !ferror(file);
+  fclose(file);
+  return written;
+}
+
+uint64_t Framebuffer::colorHash() const {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  const unsigned char *bytes = (const unsigned char *)color.data();
+  for (size_t i = 0; i < color.size() * sizeof(uint32_t); i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+uint32_t packColor(const glm::vec4 &color) {
+  glm::vec4 scaled = glm::clamp(color, 0.0f, 1.0f) * 255.0f + 0.5f;
+  return (uint32_t)scaled.r | (uint32_t)scaled.g << 8 |
+         (uint32_t)scaled.b << 16 | (uint32_t)scaled.a << 24;
+}
@@ -0,0 +1,36 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/* Colour and depth in memory, for the software renderer. Rows go bottom up
+ as in GL, colours are RGBA8 (red in the low byte) and depth is window depth,
+ 0 near to 1 far.
+ */
+class Framebuffer {
+public:
+  int width, height;
+  vector<uint32_t> color;
+  vector<float> depth;
+
+  Framebuffer();
+
+  void resize(int newWidth, int newHeight);
+  // Like glClear of both buffers
+  void clear(const glm::vec4 &clearColor, float clearDepth = 1.0f);
+
+  // Binary PPM, top row first
+  bool writePPM(const string &path) const;
+  // FNV-1a of the colour buffer, to compare frames
+  uint64_t colorHash() const;
+};
+
+// Rounds to nearest, like a UNORM8 colour attachment
+uint32_t packColor(const glm::vec4 &color);
+
+#endif
@@ -0,0 +1,428 @@
+#include "software_renderer.h"
+#include "jobs/job_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <glm/simd/batch.h>
+#include <glm/simd/bits.h>
+#include <math.h>
+
+// The AVX span kernel is built whatever the compiler targets and picked at
+// runtime, through the CPU detection of glm's batched kernels
+#ifdef GLM_BATCH_DISPATCH
+#define SOFTWARE_RASTER_AVX
+#endif
+
+namespace {
+
+// Sub-pixel precision of the corners
+const int subpixelBits = 4;
+const int subpixels = 1 << subpixelBits;
+
+// How far past the viewport, in pixels, triangles may reach before they are
+// clipped. Keeps the fixed point corners and the edge functions well inside
+// what int32 and double hold exactly.
+const float guardBandPixels = 2048.0f;
+
+// Clip planes. The first six are clipped against; the last four, the
+// viewport itself, only reject.
+enum { NearPlane, FarPlane, GuardPlanes, ClipPlaneCount = GuardPlanes + 4 };
+const int viewportPlanes = ClipPlaneCount;
+const int planeCount = ClipPlaneCount + 4;
+
+const size_t maxClippedVertices = 3 + ClipPlaneCount;
+
+} // namespace
+
+SoftwareRenderer::SoftwareRenderer() {
+  stats = SoftwareRenderStats{0, 0, 0, 0, 0.0};
+  target = NULL;
+  uniforms = Uniforms{glm::mat4(1.0f), NULL, NULL, 0.0f};
+  pieceCount = triangleCount = 0;
+  tilesX = tilesY = 0;
+}
+
+void SoftwareRenderer::begin(Framebuffer &newTarget,
+                             const Uniforms &frameUniforms) {
+  target = &newTarget;
+  uniforms = frameUniforms;
+  draws.clear();
+  pieceCount = triangleCount = 0;
+  tilesX = (target->width + tileSize - 1) / tileSize;
+  tilesY = (target->height + tileSize - 1) / tileSize;
+
+  float guardX = guardBandPixels * 2.0f / target->width + 1.0f;
+  float guardY = guardBandPixels * 2.0f / target->height + 1.0f;
+  const glm::vec4 planes[planeCount] = {
+      glm::vec4(0.0f, 0.0f, 1.0f, 1.0f),   glm::vec4(0.0f, 0.0f, -1.0f, 1.0f),
+      glm::vec4(1.0f, 0.0f, 0.0f, guardX), glm::vec4(-1.0f, 0.0f, 0.0f, guardX),
+      glm::vec4(0.0f, 1.0f, 0.0f, guardY), glm::vec4(0.0f, -1.0f, 0.0f, guardY),
+      glm::vec4(1.0f, 0.0f, 0.0f, 1.0f),   glm::vec4(-1.0f, 0.0f, 0.0f, 1.0f),
+      glm::vec4(0.0f, 1.0f, 0.0f, 1.0f),   glm::vec4(0.0f, -1.0f, 0.0f, 1.0f)};
+  copy(planes, planes + planeCount, clipPlanes);
+}
+
+void SoftwareRenderer::draw(const SoftwareMesh &mesh, uint32_t indexOffset,
+                            uint32_t indexCount, const glm::mat4 *models,
+                            size_t count) {
+  if (count == 0 || indexCount < 3)
+    return;
+  uint32_t triangles = indexCount / 3;
+  uint32_t pieces = (triangles + pieceTriangles - 1) / pieceTriangles;
+  draws.push_back(
+      Draw{&mesh, indexOffset, indexCount, models, pieceCount, pieces});
+  pieceCount += count * pieces;
+  triangleCount += count * triangles;
+  stats.triangles += count * triangles;
+}
+
+// Geometry
+
+void SoftwareRenderer::processPiece(const Draw &draw, size_t piece,
+                                    Batch &batch) const {
+  size_t instance = piece / draw.piecesPerInstance;
+  uint32_t first = (uint32_t)(piece % draw.piecesPerInstance) * pieceTriangles;
+  uint32_t last = min(first + pieceTriangles, draw.indexCount / 3);
+  glm::mat4 transform = uniforms.viewProjection * draw.models[instance];
+  const SoftwareMesh &mesh = *draw.mesh;
+  const uint32_t *indices = &mesh.indices[draw.indexOffset];
+
+  for (uint32_t i = first * 3; i < last * 3; i += 3) {
+    ClipVertex corners[3];
+    for (int c = 0; c < 3; c++) {
+      uint32_t index = indices[i + c];
+      corners[c].position =
+          transform * glm::vec4(mesh.positions[index], 1.0f);
+      corners[c].texCoord = mesh.texCoords[index];
+    }
+    clipTriangle(corners, batch);
+  }
+}
+
+void SoftwareRenderer::clipTriangle(const ClipVertex corners[3],
+                                    Batch &batch) const {
+  unsigned int outside[3] = {0, 0, 0};
+  for (int c = 0; c < 3; c++)
+    for (int p = 0; p < planeCount; p++)
+      if (glm::dot(clipPlanes[p], corners[c].position) < 0.0f)
+        outside[c] |= 1u << p;
+  if (outside[0] & outside[1] & outside[2])
+    return;
+
+  unsigned int clip =
+      (outside[0] | outside[1] | outside[2]) & ((1u << viewportPlanes) - 1);
+  if (!clip) {
+    const ClipVertex *triangle[3] = {&corners[0], &corners[1], &corners[2]};
+    setupTriangle(triangle, batch);
+    return;
+  }
+
+  // Sutherland-Hodgman, one plane at a time
+  ClipVertex buffers[2][maxClippedVertices];
+  ClipVertex *polygon = buffers[0], *clipped = buffers[1];
+  size_t count = 3;
+  copy(corners, corners + 3, polygon);
+  for (int p = 0; p < ClipPlaneCount && count >= 3; p++) {
+    if (!(clip & (1u << p)))
+      continue;
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+      const ClipVertex &a = polygon[i], &b = polygon[(i + 1) % count];
+      float da = glm::dot(clipPlanes[p], a.position);
+      float db = glm::dot(clipPlanes[p], b.position);
+      if (da >= 0.0f)
+        clipped[kept++] = a;
+      if ((da >= 0.0f) != (db >= 0.0f)) {
+        float t = da / (da - db);
+        clipped[kept].position = glm::mix(a.position, b.position, t);
+        clipped[kept].texCoord = glm::mix(a.texCoord, b.texCoord, t);
+        kept++;
+      }
+    }
+    swap(polygon, clipped);
+    count = kept;
+  }
+
+  for (size_t i = 1; i + 1 < count; i++) {
+    const ClipVertex *triangle[3] = {&polygon[0], &polygon[i],
+                                     &polygon[i + 1]};
+    setupTriangle(triangle, batch);
+  }
+}
+
+void SoftwareRenderer::setupTriangle(const ClipVertex *corners[3],
+                                     Batch &batch) const {
+  Triangle triangle;
+  float scaleX = target->width * 0.5f * subpixels;
+  float scaleY = target->height * 0.5f * subpixels;
+  for (int c = 0; c < 3; c++) {
+    const glm::vec4 &position = corners[c]->position;
+    float inverseW = 1.0f / position.w;
+    triangle.x[c] = (int32_t)lrintf((position.x * inverseW + 1.0f) * scaleX);
+    triangle.y[c] = (int32_t)lrintf((position.y * inverseW + 1.0f) * scaleY);
+    triangle.depth[c] = position.z * inverseW * 0.5f + 0.5f;
+    triangle.inverseW[c] = inverseW;
+    triangle.u[c] = corners[c]->texCoord.x * inverseW;
+    triangle.v[c] = corners[c]->texCoord.y * inverseW;
+  }
+
+  int64_t area = (int64_t)(triangle.x[1] - triangle.x[0]) *
+                     (triangle.y[2] - triangle.y[0]) -
+                 (int64_t)(triangle.x[2] - triangle.x[0]) *
+                     (triangle.y[1] - triangle.y[0]);
+  if (area == 0)
+    return;
+  // Both faces are drawn; turn clockwise ones around
+  if (area < 0) {
+    swap(triangle.x[1], triangle.x[2]);
+    swap(triangle.y[1], triangle.y[2]);
+    swap(triangle.depth[1], triangle.depth[2]);
+    swap(triangle.inverseW[1], triangle.inverseW[2]);
+    swap(triangle.u[1], triangle.u[2]);
+    swap(triangle.v[1], triangle.v[2]);
+    area = -area;
+  }
+
+  // Pixels whose centres (x * 16 + 8) are inside the bounds
+  int32_t lowX = min(triangle.x[0], min(triangle.x[1], triangle.x[2]));
+  int32_t highX = max(triangle.x[0], max(triangle.x[1], triangle.x[2]));
+  int32_t lowY = min(triangle.y[0], min(triangle.y[1], triangle.y[2]));
+  int32_t highY = max(triangle.y[0], max(triangle.y[1], triangle.y[2]));
+  const int half = subpixels / 2;
+  triangle.minX = max(0, (lowX - half + subpixels - 1) >> subpixelBits);
+  triangle.minY = max(0, (lowY - half + subpixels - 1) >> subpixelBits);
+  triangle.maxX = min(target->width - 1, (highX - half) >> subpixelBits);
+  triangle.maxY = min(target->height - 1, (highY - half) >> subpixelBits);
+  if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+    return;
+
+  for (int e = 0; e < 3; e++) {
+    int a = e, b = (e + 1) % 3;
+    triangle.edgeX[e] = triangle.y[a] - triangle.y[b];
+    triangle.edgeY[e] = triangle.x[b] - triangle.x[a];
+    // Top-left rule: with y up and the inside on the left, left edges go
+    // down and top edges go left
+    bool topLeft = triangle.edgeX[e] > 0 ||
+                   (triangle.edgeX[e] == 0 && triangle.edgeY[e] < 0);
+    triangle.bias[e] = topLeft ? 1 : 0;
+  }
+  triangle.inverseArea = 1.0 / (double)area;
+
+  uint32_t index = (uint32_t)batch.triangles.size();
+  batch.triangles.push_back(triangle);
+  for (int tileY = triangle.minY / tileSize; tileY <= triangle.maxY / tileSize;
+       tileY++)
+    for (int tileX = triangle.minX / tileSize;
+         tileX <= triangle.maxX / tileSize; tileX++)
+      batch.tiles[tileY * tilesX + tileX].push_back(index);
+}
+
+// Rasterization
+
+// litMixValue.fs, with the barycentric weights of the corners opposite each
+// edge. Texture coordinates are interpolated over w and divided back.
+uint32_t SoftwareRenderer::shade(const Triangle &t, double e0, double e1,
+                                 double e2) const {
+  float b0 = (float)(e1 * t.inverseArea);
+  float b1 = (float)(e2 * t.inverseArea);
+  float b2 = (float)(e0 * t.inverseArea);
+  float w = b0 * t.inverseW[0] + b1 * t.inverseW[1] + b2 * t.inverseW[2];
+  glm::vec2 texCoord(b0 * t.u[0] + b1 * t.u[1] + b2 * t.u[2],
+                     b0 * t.v[0] + b1 * t.v[1] + b2 * t.v[2]);
+  texCoord /= w;
+
+  glm::vec4 first = uniforms.texture1->sample(texCoord);
+  glm::vec4 second = uniforms.texture2->sample(
+      glm::vec2(1.0f - texCoord.s * 2.0f, texCoord.t * 2.0f));
+  return packColor(glm::mix(first, second, uniforms.mixValue));
+}
+
+// Rounds towards minus infinity, for b > 0
+static inline int64_t floorDivide(int64_t a, int64_t b) {
+  int64_t quotient = a / b;
+  return quotient * b > a ? quotient - 1 : quotient;
+}
+
+#if defined(SOFTWARE_RASTER_AVX)
+// Shades the row four pixels at a time from x while a whole group fits before
+// high, and returns where the scalar loop picks up. AVX2 is what is checked
+// for at runtime; the kernel itself only needs AVX.
+GLM_BATCH_TARGET("avx")
+int SoftwareRenderer::rasterizeSpanAVX(const Triangle &t,
+                                       const int64_t stepX[3],
+                                       const int64_t rowEdge[3],
+                                       float *depthRow, uint32_t *colorRow,
+                                       int x, int high,
+                                       uint64_t &fragments) const {
+  __m256d lanes = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+  __m256d inverseArea = _mm256_set1_pd(t.inverseArea);
+  __m256d weightStep[3];
+  for (int e = 0; e < 3; e++)
+    weightStep[e] = _mm256_mul_pd(lanes, _mm256_set1_pd(stepX[e]));
+  for (; x + 3 <= high; x += 4) {
+    // Edge values are exact in doubles; the weight of a corner is the
+    // edge opposite it
+    __m256d edges[3];
+    for (int e = 0; e < 3; e++)
+      edges[e] = _mm256_add_pd(
+          _mm256_set1_pd((double)(stepX[e] * x + rowEdge[e])), weightStep[e]);
+    __m256d z = _mm256_setzero_pd();
+    for (int c = 0; c < 3; c++)
+      z = _mm256_add_pd(
+          z, _mm256_mul_pd(_mm256_mul_pd(edges[(c + 1) % 3], inverseArea),
+                           _mm256_set1_pd(t.depth[c])));
+    __m256d stored = _mm256_cvtps_pd(_mm_loadu_ps(depthRow + x));
+    int passed = _mm256_movemask_pd(_mm256_cmp_pd(z, stored, _CMP_LT_OQ));
+    if (!passed)
+      continue;
+
+    double depths[4], values[3][4];
+    _mm256_storeu_pd(depths, z);
+    for (int e = 0; e < 3; e++)
+      _mm256_storeu_pd(values[e], edges[e]);
+    for (; passed; passed &= passed - 1) {
+      int lane = glm_lowest_bit((unsigned int)passed);
+      depthRow[x + lane] = (float)depths[lane];
+      colorRow[x + lane] =
+          shade(t, values[0][lane], values[1][lane], values[2][lane]);
+      fragments++;
+    }
+  }
+  return x;
+}
+#endif
+
+uint64_t SoftwareRenderer::rasterizeTile(int tile) {
+  int tileX = tile % tilesX * tileSize, tileY = tile / tilesX * tileSize;
+  int width = target->width;
+  uint32_t *color = target->color.data();
+  float *depthBuffer = target->depth.data();
+  uint64_t fragments = 0;
+#if defined(SOFTWARE_RASTER_AVX)
+  bool useAVX = glm_batch_get_isa() >= GLM_BATCH_AVX2;
+#endif
+
+  for (const Batch &batch : batches) {
+    for (uint32_t index : batch.tiles[tile]) {
+      const Triangle &t = batch.triangles[index];
+      int x0 = max(t.minX, tileX), x1 = min(t.maxX, tileX + tileSize - 1);
+      int y0 = max(t.minY, tileY), y1 = min(t.maxY, tileY + tileSize - 1);
+      int64_t stepX[3];
+      for (int e = 0; e < 3; e++)
+        stepX[e] = (int64_t)t.edgeX[e] * subpixels;
+
+      for (int y = y0; y <= y1; y++) {
+        // Edge e at the centre of pixel x is stepX * x + rowEdge. The covered
+        // pixels of the row follow from each edge exactly, so only those are
+        // visited.
+        int64_t py = (int64_t)y * subpixels + subpixels / 2;
+        int64_t rowEdge[3];
+        int low = x0, high = x1;
+        for (int e = 0; e < 3; e++) {
+          rowEdge[e] = (int64_t)t.edgeX[e] * (subpixels / 2 - t.x[e]) +
+                       (int64_t)t.edgeY[e] * (py - t.y[e]);
+          // Inside when stepX * x + rowEdge + bias > 0
+          int64_t constant = rowEdge[e] + t.bias[e];
+          if (stepX[e] > 0)
+            low = (int)max((int64_t)low,
+                           floorDivide(-constant, stepX[e]) + 1);
+          else if (stepX[e] < 0)
+            high = (int)min((int64_t)high,
+                            floorDivide(constant - 1, -stepX[e]));
+          else if (constant <= 0)
+            high = low - 1;
+        }
+        if (low > high)
+          continue;
+
+        float *depthRow = depthBuffer + (size_t)y * width;
+        uint32_t *colorRow = color + (size_t)y * width;
+        int x = low;
+#if defined(SOFTWARE_RASTER_AVX)
+        if (useAVX)
+          x = rasterizeSpanAVX(t, stepX, rowEdge, depthRow, colorRow, x, high,
+                               fragments);
+#endif
+        for (; x <= high; x++) {
+          double edges[3];
+          for (int e = 0; e < 3; e++)
+            edges[e] = (double)(stepX[e] * x + rowEdge[e]);
+          double z = 0.0;
+          for (int c = 0; c < 3; c++)
+            z += edges[(c + 1) % 3] * t.inverseArea * (double)t.depth[c];
+          if (!(z < (double)depthRow[x]))
+            continue;
+          depthRow[x] = (float)z;
+          colorRow[x] = shade(t, edges[0], edges[1], edges[2]);
+          fragments++;
+        }
+      }
+    }
+  }
+  return fragments;
+}
+
+void SoftwareRenderer::finish() {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+  // Batches depend only on what was drawn, never on the worker count
+  size_t perPiece = pieceCount ? max((size_t)1, triangleCount / pieceCount) : 1;
+  size_t grain = min((size_t)1024, max((size_t)1, pieceTriangles / perPiece));
+
+  size_t tileCount = (size_t)tilesX * tilesY;
+  tileFragments.assign(tileCount, 0);
+
+  size_t roundPieces = grain * batchesPerRound;
+  for (size_t first = 0; first < pieceCount; first += roundPieces) {
+    size_t count = min(roundPieces, pieceCount - first);
+    batches.resize((count + grain - 1) / grain);
+    for (Batch &batch : batches) {
+      batch.triangles.clear();
+      batch.tiles.resize(tileCount);
+      for (vector<uint32_t> &bin : batch.tiles)
+        bin.clear();
+    }
+
+    jobPool.parallelFor(count, grain, [&](size_t begin, size_t end,
+                                          unsigned int) {
+      Batch &batch = batches[begin / grain];
+      begin += first;
+      end += first;
+      size_t d = upper_bound(draws.begin(), draws.end(), begin,
+                             [](size_t piece, const Draw &draw) {
+                               return piece < draw.firstPiece;
+                             }) -
+                 draws.begin() - 1;
+      for (size_t piece = begin; piece < end; piece++) {
+        while (d + 1 < draws.size() && draws[d + 1].firstPiece <= piece)
+          d++;
+        processPiece(draws[d], piece - draws[d].firstPiece, batch);
+      }
+    });
+
+    // Tiles are taken by whichever worker is free next
+    jobPool.parallelFor(tileCount, 1,
+                        [&](size_t begin, size_t end, unsigned int) {
+                          for (size_t tile = begin; tile < end; tile++)
+                            tileFragments[tile] += rasterizeTile((int)tile);
+                        });
+
+    for (const Batch &batch : batches)
+      stats.trianglesSetUp += batch.triangles.size();
+  }
+
+  for (uint64_t fragments : tileFragments)
+    stats.fragments += fragments;
+  stats.frames++;
+  stats.seconds += chrono::duration<double>(chrono::steady_clock::now() -
+                                            start)
+                       .count();
+}
+
+const char *softwareRasterKernelName() {
+#if defined(SOFTWARE_RASTER_AVX)
+  if (glm_batch_get_isa() >= GLM_BATCH_AVX2)
+    return "AVX";
+#endif
+  return "scalar";
+}
@@ -0,0 +1,146 @@
+#ifndef SOFTWARE_RENDERER_H
+#define SOFTWARE_RENDERER_H
+
+#include "raster/framebuffer.h"
+#include "raster/texture.h"
+
+#include <glm/glm.hpp>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+// A mesh as the vertex shader reads it, already dequantized
+struct SoftwareMesh {
+  vector<glm::vec3> positions;
+  vector<glm::vec2> texCoords;
+  vector<uint32_t> indices;
+};
+
+struct SoftwareRenderStats {
+  uint64_t frames;
+  // Instances times their triangles, as submitted
+  uint64_t triangles;
+  // Left after clipping that cover at least one pixel centre
+  uint64_t trianglesSetUp;
+  // Passed the depth test and were shaded
+  uint64_t fragments;
+  double seconds;
+};
+
+/* Renders the app's pipeline on the CPU into a Framebuffer:
+ instancedShader.vs (viewProjection * model * position) and litMixValue.fs
+ (two textures mixed by mixValue; the cube has no normals, so no lighting),
+ with GL_LESS depth testing and no face culling, as the app sets GL up.
+
+ finish() works in two parallel passes on jobPool:
+
+ 1. Geometry. Instances, cut into pieces of at most pieceTriangles
+    triangles, are split into fixed batches of about as many triangles,
+    whatever the number of workers. Each batch transforms and clips its
+    triangles (near and far planes, and a guard band around the viewport),
+    sets them up in 1/16 pixel fixed point and bins them into tileSize tiles.
+ 2. Tiles. Each tile walks its bins batch by batch, so triangles arrive in
+    submission order, and rasterizes 4 pixels at a time. Edge functions are
+    exact integers (held in doubles), with GL's top-left rule, so shared
+    edges are neither missed nor drawn twice.
+
+ The two passes take turns every batchesPerRound batches, which bounds the
+ memory the binned triangles take however much is drawn.
+
+ Every pixel is only ever touched by the tile that owns it and always sees
+ the same triangles in the same order, so frames come out the same, bit for
+ bit, however many threads draw them.
+ */
+class SoftwareRenderer {
+public:
+  static constexpr int tileSize = 64;
+  static constexpr uint32_t pieceTriangles = 16384;
+  static constexpr size_t batchesPerRound = 32;
+
+  // The uniforms of the two shaders
+  struct Uniforms {
+    glm::mat4 viewProjection;
+    const Texture *texture1;
+    const Texture *texture2;
+    float mixValue;
+  };
+
+  // Added up over every finish()
+  SoftwareRenderStats stats;
+
+  SoftwareRenderer();
+
+  void begin(Framebuffer &target, const Uniforms &frameUniforms);
+
+  // Like glDrawElementsInstanced of indexCount indices from indexOffset, once
+  // per model matrix. The mesh and the matrices are read by finish(), and
+  // have to stay alive until then.
+  void draw(const SoftwareMesh &mesh, uint32_t indexOffset,
+            uint32_t indexCount, const glm::mat4 *models,
+            size_t instanceCount);
+
+  void finish();
+
+private:
+  struct Draw {
+    const SoftwareMesh *mesh;
+    uint32_t indexOffset, indexCount;
+    const glm::mat4 *models;
+    // Pieces of the draws before this one, and how many each instance is
+    // cut into
+    size_t firstPiece;
+    uint32_t piecesPerInstance;
+  };
+
+  struct ClipVertex {
+    glm::vec4 position;
+    glm::vec2 texCoord;
+  };
+
+  struct Triangle {
+    // Corners in 1/16 pixels, counter-clockwise
+    int32_t x[3], y[3];
+    // Edge e runs from corner e to corner e + 1 and is
+    // edgeX * (px - x[e]) + edgeY * (py - y[e]), inside when above -bias
+    int32_t edgeX[3], edgeY[3], bias[3];
+    int minX, minY, maxX, maxY;
+    double inverseArea;
+    // Per corner: window depth, 1 / w, and texture coordinates over w
+    float depth[3], inverseW[3], u[3], v[3];
+  };
+
+  // What one geometry batch produced
+  struct Batch {
+    vector<Triangle> triangles;
+    vector<vector<uint32_t>> tiles;
+  };
+
+  Framebuffer *target;
+  Uniforms uniforms;
+  // Inside where dot(plane, clip position) >= 0: near, far, the guard band,
+  // then the viewport itself
+  glm::vec4 clipPlanes[10];
+  vector<Draw> draws;
+  size_t pieceCount, triangleCount;
+  int tilesX, tilesY;
+  vector<Batch> batches;
+  vector<uint64_t> tileFragments;
+
+  void processPiece(const Draw &draw, size_t piece, Batch &batch) const;
+  void clipTriangle(const ClipVertex corners[3], Batch &batch) const;
+  void setupTriangle(const ClipVertex *corners[3], Batch &batch) const;
+  uint64_t rasterizeTile(int tile);
+  int rasterizeSpanAVX(const Triangle &t, const int64_t stepX[3],
+                       const int64_t rowEdge[3], float *depthRow,
+                       uint32_t *colorRow, int x, int high,
+                       uint64_t &fragments) const;
+  uint32_t shade(const Triangle &triangle, double e0, double e1,
+                 double e2) const;
+};
+
+// Which edge function kernel runs on this CPU: "AVX" or "scalar"
+const char *softwareRasterKernelName();
+
+#endif
@@ -0,0 +1,52 @@
+#include "texture.h"
+
+#include <math.h>
+
+Texture::Texture() {
+  width = 0;
+  height = 0;
+}
+
+void Texture::setImage(const unsigned char *pixels, int newWidth,
+                       int newHeight, int channels, bool alpha) {
+  width = newWidth;
+  height = newHeight;
+  texels.resize((size_t)width * height);
+  for (size_t i = 0; i < texels.size(); i++) {
+    const unsigned char *p = pixels + i * channels;
+    uint32_t r = p[0];
+    uint32_t g = channels > 1 ? p[1] : 0;
+    uint32_t b = channels > 2 ? p[2] : 0;
+    uint32_t a = alpha && channels > 3 ? p[3] : 255;
+    texels[i] = r | g << 8 | b << 16 | a << 24;
+  }
+}
+
+static inline glm::vec4 unpackTexel(uint32_t texel) {
+  return glm::vec4((float)(texel & 0xFF), (float)((texel >> 8) & 0xFF),
+                   (float)((texel >> 16) & 0xFF), (float)(texel >> 24)) *
+         (1.0f / 255.0f);
+}
+
+static inline int wrap(int i, int size) {
+  i %= size;
+  return i < 0 ? i + size : i;
+}
+
+glm::vec4 Texture::sample(glm::vec2 texCoord) const {
+  if (width == 0 || height == 0)
+    return glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+  // Texel centres are at half integers
+  float u = texCoord.x * width - 0.5f, v = texCoord.y * height - 0.5f;
+  float u0 = floorf(u), v0 = floorf(v);
+  float fu = u - u0, fv = v - v0;
+  int x0 = wrap((int)u0, width), x1 = wrap((int)u0 + 1, width);
+  int y0 = wrap((int)v0, height), y1 = wrap((int)v0 + 1, height);
+
+  glm::vec4 bottom = glm::mix(unpackTexel(texels[(size_t)y0 * width + x0]),
+                              unpackTexel(texels[(size_t)y0 * width + x1]), fu);
+  glm::vec4 top = glm::mix(unpackTexel(texels[(size_t)y1 * width + x0]),
+                           unpackTexel(texels[(size_t)y1 * width + x1]), fu);
+  return glm::mix(bottom, top, fv);
+}
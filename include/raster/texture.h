@@ -0,0 +1,30 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+
+#include <glm/glm.hpp>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* A 2D texture for the software renderer, sampled like a GL texture with
+ GL_REPEAT wrapping and GL_LINEAR filtering of level 0. Rows go bottom up, as
+ glTexImage2D takes them.
+ */
+class Texture {
+public:
+  int width, height;
+  // RGBA8, red in the low byte
+  vector<uint32_t> texels;
+
+  Texture();
+
+  // `channels` is what the pixels have (1 to 4). Without `alpha` the texture
+  // is GL_RGB and alpha reads as 1, whatever the pixels say.
+  void setImage(const unsigned char *pixels, int newWidth, int newHeight,
+                int channels, bool alpha);
+
+  glm::vec4 sample(glm::vec2 texCoord) const;
+};
+
+#endif
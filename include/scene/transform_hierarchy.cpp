@@ -0,0 +1,226 @@
+#include "transform_hierarchy.h"
+#include "jobs/job_pool.h"
+
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/simd/batch.h>
+
+// Levels smaller than this are not worth waking the workers for
+static const size_t parallelGrain = 2048;
+
+TransformHierarchy::TransformHierarchy() {
+  orderValid = true;
+  updated = 0;
+  levels.push_back(0);
+}
+
+TransformHierarchy::Node TransformHierarchy::create(Node parent,
+                                                    const glm::vec3 &position,
+                                                    const glm::quat &rotation,
+                                                    const glm::vec3 &scale) {
+  Node node = (Node)nodeAt.size();
+  uint32_t slot = (uint32_t)positions.size();
+
+  positions.push_back(position);
+  rotations.push_back(rotation);
+  scales.push_back(scale);
+  parents.push_back(parent == none ? none : slotOf[parent]);
+  dirty.push_back(1);
+  changed.push_back(0);
+  worlds.push_back(glm::mat4(1.0f));
+
+  slotOf.push_back(slot);
+  nodeAt.push_back(node);
+  parentHandles.push_back(parent);
+
+  // Appending keeps parents first, but may split a level: sort on update
+  orderValid = false;
+  return node;
+}
+
+void TransformHierarchy::clear() {
+  positions.clear();
+  rotations.clear();
+  scales.clear();
+  parents.clear();
+  dirty.clear();
+  changed.clear();
+  worlds.clear();
+  slotOf.clear();
+  nodeAt.clear();
+  parentHandles.clear();
+  levels.assign(1, 0);
+  orderValid = true;
+}
+
+size_t TransformHierarchy::size() const { return positions.size(); }
+
+void TransformHierarchy::setPosition(Node node, const glm::vec3 &position) {
+  uint32_t slot = slotOf[node];
+  positions[slot] = position;
+  dirty[slot] = 1;
+}
+
+void TransformHierarchy::setRotation(Node node, const glm::quat &rotation) {
+  uint32_t slot = slotOf[node];
+  rotations[slot] = rotation;
+  dirty[slot] = 1;
+}
+
+void TransformHierarchy::setScale(Node node, const glm::vec3 &scale) {
+  uint32_t slot = slotOf[node];
+  scales[slot] = scale;
+  dirty[slot] = 1;
+}
+
+const glm::vec3 &TransformHierarchy::position(Node node) const {
+  return positions[slotOf[node]];
+}
+
+const glm::quat &TransformHierarchy::rotation(Node node) const {
+  return rotations[slotOf[node]];
+}
+
+const glm::vec3 &TransformHierarchy::scale(Node node) const {
+  return scales[slotOf[node]];
+}
+
+const glm::mat4 &TransformHierarchy::world(Node node) const {
+  return worlds[slotOf[node]];
+}
+
+bool TransformHierarchy::worldChanged(Node node) const {
+  return changed[slotOf[node]] != 0;
+}
+
+size_t TransformHierarchy::updatedCount() const { return updated; }
+
+// Breadth first from the roots, with the children of a node next to each
+// other, and every slot array permuted to match
+void TransformHierarchy::reorder() {
+  size_t count = nodeAt.size();
+
+  // Children of each handle, as ranges of one array (counting sort)
+  vector<uint32_t> childStart(count + 1, 0);
+  for (Node node = 0; node < count; node++) {
+    if (parentHandles[node] != none)
+      childStart[parentHandles[node] + 1]++;
+  }
+  for (size_t i = 0; i < count; i++)
+    childStart[i + 1] += childStart[i];
+  vector<Node> children(childStart[count]);
+  vector<uint32_t> fill(childStart.begin(), childStart.end() - 1);
+  for (Node node = 0; node < count; node++) {
+    if (parentHandles[node] != none)
+      children[fill[parentHandles[node]]++] = node;
+  }
+
+  vector<Node> order;
+  order.reserve(count);
+  levels.assign(1, 0);
+  for (Node node = 0; node < count; node++) {
+    if (parentHandles[node] == none)
+      order.push_back(node);
+  }
+  size_t levelBegin = 0;
+  while (levelBegin < order.size()) {
+    size_t levelEnd = order.size();
+    levels.push_back((uint32_t)levelEnd);
+    for (size_t i = levelBegin; i < levelEnd; i++) {
+      Node node = order[i];
+      for (uint32_t c = childStart[node]; c < childStart[node + 1]; c++)
+        order.push_back(children[c]);
+    }
+    levelBegin = levelEnd;
+  }
+
+  vector<glm::vec3> newPositions(count), newScales(count);
+  vector<glm::quat> newRotations(count);
+  vector<uint8_t> newDirty(count), newChanged(count, 0);
+  vector<glm::mat4> newWorlds(count);
+  for (uint32_t slot = 0; slot < count; slot++) {
+    uint32_t old = slotOf[order[slot]];
+    newPositions[slot] = positions[old];
+    newRotations[slot] = rotations[old];
+    newScales[slot] = scales[old];
+    newDirty[slot] = dirty[old];
+    newWorlds[slot] = worlds[old];
+  }
+  positions.swap(newPositions);
+  rotations.swap(newRotations);
+  scales.swap(newScales);
+  dirty.swap(newDirty);
+  changed.swap(newChanged);
+  worlds.swap(newWorlds);
+
+  nodeAt = order;
+  for (uint32_t slot = 0; slot < count; slot++)
+    slotOf[order[slot]] = slot;
+  for (uint32_t slot = 0; slot < count; slot++) {
+    Node parent = parentHandles[order[slot]];
+    parents[slot] = parent == none ? none : slotOf[parent];
+  }
+
+  orderValid = true;
+}
+
+void TransformHierarchy::updateRange(size_t begin, size_t end) {
+  // Slots rebuilt one after the other under the same parent, whose locals
+  // wait in worlds[] to be multiplied by the parent's world as one batch
+  size_t runBegin = begin;
+  uint32_t runParent = none;
+
+  for (size_t slot = begin; slot < end; slot++) {
+    uint32_t parent = parents[slot];
+    bool parentChanged = parent != none && changed[parent];
+    bool rebuild = dirty[slot] || parentChanged;
+
+    if (!rebuild || parent != runParent) {
+      if (runParent != none)
+        glm_batch_mat4_mul(glm::value_ptr(worlds[runParent]),
+                           glm::value_ptr(worlds[runBegin]),
+                           glm::value_ptr(worlds[runBegin]), slot - runBegin);
+      runBegin = slot;
+      runParent = rebuild ? parent : none;
+    }
+    if (!rebuild) {
+      changed[slot] = 0;
+      continue;
+    }
+
+    // T * R * S, built straight from the rotation matrix's columns
+    glm::mat3 rotation = glm::mat3_cast(rotations[slot]);
+    const glm::vec3 &scale = scales[slot];
+    worlds[slot] = glm::mat4(glm::vec4(rotation[0] * scale.x, 0.0f),
+                             glm::vec4(rotation[1] * scale.y, 0.0f),
+                             glm::vec4(rotation[2] * scale.z, 0.0f),
+                             glm::vec4(positions[slot], 1.0f));
+    dirty[slot] = 0;
+    changed[slot] = 1;
+  }
+  if (runParent != none)
+    glm_batch_mat4_mul(glm::value_ptr(worlds[runParent]),
+                       glm::value_ptr(worlds[runBegin]),
+                       glm::value_ptr(worlds[runBegin]), end - runBegin);
+}
+
+void TransformHierarchy::update(bool parallel) {
+  if (!orderValid)
+    reorder();
+
+  // A level only reads the one before it, so each level can be split freely
+  for (size_t level = 0; level + 1 < levels.size(); level++) {
+    size_t begin = levels[level], end = levels[level + 1];
+    if (parallel && end - begin >= 2 * parallelGrain) {
+      jobPool.parallelFor(end - begin, parallelGrain,
+                          [&](size_t first, size_t last, unsigned int) {
+                            updateRange(begin + first, begin + last);
+                          });
+    } else {
+      updateRange(begin, end);
+    }
+  }
+
+  updated = 0;
+  for (uint8_t c : changed)
+    updated += c;
+}
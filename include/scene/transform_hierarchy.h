@@ -0,0 +1,76 @@
+#ifndef TRANSFORM_HIERARCHY_H
+#define TRANSFORM_HIERARCHY_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Parent/child transforms for many objects. Local position, rotation and
+ scale are kept in one array each, in breadth-first order, so every parent
+ comes before its children and a level of the tree is one contiguous range.
+ update() then walks the levels in order and only rebuilds world matrices of
+ nodes that changed or whose parent did. Levels large enough are split over
+ the job pool.
+
+ Nodes are referred to by handles, which stay valid when the order changes.
+ Setters may be called from several threads at once for different nodes.
+ */
+class TransformHierarchy {
+public:
+  typedef uint32_t Node;
+  static constexpr Node none = 0xFFFFFFFF;
+
+  TransformHierarchy();
+
+  Node create(Node parent = none,
+              const glm::vec3 &position = glm::vec3(0.0f),
+              const glm::quat &rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+              const glm::vec3 &scale = glm::vec3(1.0f));
+  void clear();
+  size_t size() const;
+
+  void setPosition(Node node, const glm::vec3 &position);
+  void setRotation(Node node, const glm::quat &rotation);
+  void setScale(Node node, const glm::vec3 &scale);
+
+  const glm::vec3 &position(Node node) const;
+  const glm::quat &rotation(Node node) const;
+  const glm::vec3 &scale(Node node) const;
+
+  // Valid after update()
+  const glm::mat4 &world(Node node) const;
+  // Whether the last update() rebuilt this node's world matrix
+  bool worldChanged(Node node) const;
+
+  void update(bool parallel = true);
+
+  // World matrices rebuilt by the last update()
+  size_t updatedCount() const;
+
+private:
+  // Breadth-first order, indexed by slot
+  vector<glm::vec3> positions;
+  vector<glm::quat> rotations;
+  vector<glm::vec3> scales;
+  vector<uint32_t> parents; // Slot of the parent, or none
+  vector<uint8_t> dirty;    // Local transform changed since the last update
+  vector<uint8_t> changed;  // World matrix rebuilt by the last update
+  vector<glm::mat4> worlds;
+  vector<uint32_t> levels; // First slot of each level, plus the end
+
+  vector<uint32_t> slotOf;     // Handle to slot
+  vector<Node> nodeAt;         // Slot to handle
+  vector<Node> parentHandles;  // Indexed by handle, for reordering
+  bool orderValid;
+
+  size_t updated;
+
+  void reorder();
+  void updateRange(size_t begin, size_t end);
+};
+
+#endif
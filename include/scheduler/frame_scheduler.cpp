@@ -0,0 +1,137 @@
+#include "frame_scheduler.h"
+
+#include <algorithm>
+#include <thread>
+
+FrameScheduler::FrameScheduler(double tickRate) {
+  mode = Uncapped;
+  fixedStep = false;
+  tickSeconds = 1.0 / tickRate;
+  frameSeconds = 1.0 / 60.0;
+  previousTime = Clock::now();
+  nextFrame = previousTime;
+  accumulator = 0.0;
+  redrawRequested = true;
+  renderThisFrame = true;
+  sleepOvershoot = 0.001;
+  rendered = skipped = 0;
+}
+
+void FrameScheduler::setMode(Mode newMode) {
+  mode = newMode;
+  // Headless runs have no context to set a swap interval on
+  if (glfwGetCurrentContext())
+    glfwSwapInterval(mode == VSync ? 1 : 0);
+
+  // Start counting from here rather than from whenever we were constructed
+  previousTime = Clock::now();
+  nextFrame = previousTime;
+  accumulator = 0.0;
+  redrawRequested = true;
+}
+
+FrameScheduler::Mode FrameScheduler::getMode() const { return mode; }
+
+void FrameScheduler::setFrameCap(double framesPerSecond) {
+  frameSeconds = 1.0 / framesPerSecond;
+}
+
+void FrameScheduler::setFixedStep(bool enabled) { fixedStep = enabled; }
+
+unsigned int FrameScheduler::beginFrame() {
+  Clock::time_point now = Clock::now();
+  accumulator += chrono::duration<double>(now - previousTime).count();
+  previousTime = now;
+
+  unsigned int ticks = (unsigned int)(accumulator / tickSeconds);
+  if (fixedStep) {
+    ticks = 1;
+    accumulator = 0.0;
+  } else if (ticks > maxTicksPerFrame) {
+    // Fell too far behind (or slept while idle): drop the backlog
+    ticks = maxTicksPerFrame;
+    accumulator = 0.0;
+  } else {
+    accumulator -= ticks * tickSeconds;
+  }
+
+  // Whether this frame renders is settled here, so requestRedraw() during the
+  // ticks of this frame still counts for it
+  renderThisFrame = mode != OnDemand || redrawRequested;
+  return ticks;
+}
+
+double FrameScheduler::tickDelta() const { return tickSeconds; }
+
+float FrameScheduler::alpha() const {
+  if (fixedStep)
+    return 1.0f;
+  return (float)min(accumulator / tickSeconds, 1.0);
+}
+
+bool FrameScheduler::shouldRender() const {
+  return renderThisFrame || redrawRequested;
+}
+
+void FrameScheduler::requestRedraw() { redrawRequested = true; }
+
+void FrameScheduler::endFrame() {
+  if (shouldRender())
+    rendered++;
+  else
+    skipped++;
+
+  bool idle = mode == OnDemand && !redrawRequested;
+  redrawRequested = false;
+
+  switch (mode) {
+  case Uncapped:
+  case VSync:
+    glfwPollEvents();
+    break;
+
+  case Capped:
+  case OnDemand:
+    if (idle) {
+      // Nothing to animate: sleep until the user does something
+      glfwWaitEvents();
+      previousTime = Clock::now();
+      nextFrame = previousTime;
+      accumulator = 0.0;
+      redrawRequested = true;
+      break;
+    }
+
+    nextFrame += chrono::duration_cast<Clock::duration>(
+        chrono::duration<double>(frameSeconds));
+    // Missed the deadline by a whole frame: don't try to catch up
+    if (nextFrame < Clock::now())
+      nextFrame = Clock::now();
+    waitUntil(nextFrame);
+    glfwPollEvents();
+    break;
+  }
+}
+
+// OS sleeps are coarse, so sleep until shortly before the deadline and spin
+// the rest. The margin tracks how late sleeps have actually been waking up.
+void FrameScheduler::waitUntil(Clock::time_point deadline) {
+  double remaining = chrono::duration<double>(deadline - Clock::now()).count();
+  if (remaining > sleepOvershoot) {
+    double requested = remaining - sleepOvershoot;
+    Clock::time_point before = Clock::now();
+    this_thread::sleep_for(chrono::duration<double>(requested));
+
+    double overshoot =
+        chrono::duration<double>(Clock::now() - before).count() - requested;
+    sleepOvershoot += (max(overshoot, 0.0) * 1.25 - sleepOvershoot) * 0.1;
+    sleepOvershoot = min(max(sleepOvershoot, 0.0002), 0.004);
+  }
+
+  while (Clock::now() < deadline)
+    this_thread::yield();
+}
+
+unsigned long long FrameScheduler::renderedFrames() const { return rendered; }
+
+unsigned long long FrameScheduler::skippedFrames() const { return skipped; }
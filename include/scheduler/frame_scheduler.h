@@ -0,0 +1,79 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <GLFW/glfw3.h>
+#include <chrono>
+
+using namespace std;
+
+/* Decouples simulation from rendering. The simulation advances in fixed ticks
+ (tickDelta() seconds each), and rendering interpolates between the last two
+ ticks with alpha(). How often frames are produced depends on the mode:
+
+ Uncapped  render as fast as possible (benchmarks)
+ Capped    sleep, then spin, until the next frame is due at the frame cap
+ VSync     let glfwSwapBuffers block on the display (glfwSwapInterval(1))
+ OnDemand  like Capped while something changes; once idle, block in
+           glfwWaitEvents until input or requestRedraw() wakes it up
+
+ Typical loop:
+
+ unsigned int ticks = scheduler.beginFrame();
+ for (unsigned int i = 0; i < ticks; i++)
+   simulate(scheduler.tickDelta());   // call requestRedraw() on changes
+ if (scheduler.shouldRender())
+   render(scheduler.alpha());         // then glfwSwapBuffers
+ scheduler.endFrame();                // paces, and polls or waits for events
+ */
+class FrameScheduler {
+public:
+  enum Mode { Uncapped, Capped, VSync, OnDemand };
+
+  // Never run more ticks than this in one frame, to avoid a spiral of death
+  static const unsigned int maxTicksPerFrame = 8;
+
+  FrameScheduler(double tickRate = 60.0);
+
+  // Also sets the swap interval of the current context
+  void setMode(Mode newMode);
+  Mode getMode() const;
+  void setFrameCap(double framesPerSecond);
+  // Run exactly one tick per frame and draw it as is, whatever the clock says,
+  // so the same number of frames always simulates the same thing
+  void setFixedStep(bool enabled);
+
+  unsigned int beginFrame();
+  double tickDelta() const;
+  float alpha() const;
+
+  bool shouldRender() const;
+  void requestRedraw();
+  void endFrame();
+
+  unsigned long long renderedFrames() const;
+  unsigned long long skippedFrames() const;
+
+private:
+  typedef chrono::steady_clock Clock;
+
+  Mode mode;
+  bool fixedStep;
+  double tickSeconds;
+  double frameSeconds;
+
+  Clock::time_point previousTime;
+  Clock::time_point nextFrame;
+  double accumulator;
+
+  bool redrawRequested;
+  bool renderThisFrame;
+
+  // How late sleep_for tends to wake up; the rest of the wait is spun
+  double sleepOvershoot;
+
+  unsigned long long rendered, skipped;
+
+  void waitUntil(Clock::time_point deadline);
+};
+
+#endif
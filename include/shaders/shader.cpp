@@ -1,10 +1,12 @@
 #include "shader.h"
+#include <algorithm>
+#include <string.h>
 
 using namespace std; 
 
 Shader::Shader() 
 {
-
+    ID = 0;
 }
 
 Shader::Shader(string vertexPath, string fragmentPath) 
@@ -79,34 +81,338 @@ Shader::Shader(string vertexPath, string fragmentPath)
 
     glLinkProgram(ID);
 
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+
+    if(!success) {
+        glGetProgramInfoLog(ID, 512, NULL, infoLog);
+        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        return;
+    }
+
+    reflectUniforms();
+    bindUniformBlocks();
+}
+
+// Registered blocks, shared by every Shader
+static vector<pair<string, GLuint>> &uniformBlocks()
+{
+    static vector<pair<string, GLuint>> blocks;
+    return blocks;
+}
+
+void Shader::registerUniformBlock(const string &name, GLuint binding)
+{
+    for (auto &block : uniformBlocks()) {
+        if (block.first == name) {
+            block.second = binding;
+            return;
+        }
+    }
+    uniformBlocks().push_back(make_pair(name, binding));
+}
+
+void Shader::bindUniformBlocks()
+{
+    for (const auto &block : uniformBlocks()) {
+        GLuint index = glGetUniformBlockIndex(ID, block.first.c_str());
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, block.second);
+    }
+}
+
+// Size in bytes of one element of a uniform of the given type
+static uint32_t uniformTypeBytes(GLenum type)
+{
+    switch (type) {
+    case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2:
+        return 8;
+    case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3:
+        return 12;
+    case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4:
+    case GL_FLOAT_MAT2:
+        return 16;
+    case GL_FLOAT_MAT3:
+        return 36;
+    case GL_FLOAT_MAT4:
+        return 64;
+    default:
+        // float, int, uint, bool and the sampler types
+        return 4;
+    }
+}
+
+static bool isFloatType(GLenum type)
+{
+    return type == GL_FLOAT || type == GL_FLOAT_VEC2 || type == GL_FLOAT_VEC3 ||
+           type == GL_FLOAT_VEC4 || type == GL_FLOAT_MAT2 || type == GL_FLOAT_MAT3 ||
+           type == GL_FLOAT_MAT4;
+}
+
+static bool isUnsignedType(GLenum type)
+{
+    return type == GL_UNSIGNED_INT || type == GL_UNSIGNED_INT_VEC2 ||
+           type == GL_UNSIGNED_INT_VEC3 || type == GL_UNSIGNED_INT_VEC4;
+}
+
+// Enumerate the active uniforms once, so that no setter ever has to ask the
+// driver for a location again. Their current values (GLSL initializers, or 0)
+// are read into the CPU-side copy here, and never again. Active uniforms whose
+// names hash the same are marked ambiguous, as hashed lookups can't tell them
+// apart.
+void Shader::reflectUniforms()
+{
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    uniforms.clear();
+    uniforms.reserve(count);
+    values.clear();
+    dirtyUniforms.clear();
+    vector<char> name(maxLength + 1);
+
+    for (GLint i = 0; i < count; i++) {
+        UniformInfo info;
+        GLsizei length = 0;
+        glGetActiveUniform(ID, i, (GLsizei)name.size(), &length, &info.size, &info.type, name.data());
+
+        // Arrays are reported as "name[0]", but are looked up as "name"
+        if (length > 3 && strcmp(name.data() + length - 3, "[0]") == 0)
+            name[length - 3] = '\0';
+
+        // Members of uniform blocks have no location of their own
+        info.location = glGetUniformLocation(ID, name.data());
+        if (info.location < 0)
+            continue;
+
+        uint32_t elementBytes = uniformTypeBytes(info.type);
+        info.hash = uniformHash(name.data());
+        info.name = name.data();
+        info.ambiguous = false;
+        info.offset = (uint32_t)values.size();
+        info.bytes = elementBytes * info.size;
+        info.dirty = false;
+        values.resize(values.size() + info.bytes);
+
+        for (GLint element = 0; element < info.size; element++) {
+            GLint location = info.location;
+            if (info.size > 1)
+                location = glGetUniformLocation(ID, (string(name.data()) + "[" + to_string(element) + "]").c_str());
+
+            void *value = &values[info.offset + element * elementBytes];
+            if (isFloatType(info.type))
+                glGetUniformfv(ID, location, (GLfloat *)value);
+            else if (isUnsignedType(info.type))
+                glGetUniformuiv(ID, location, (GLuint *)value);
+            else
+                glGetUniformiv(ID, location, (GLint *)value);
+        }
+
+        uniforms.push_back(info);
+    }
+
+    sort(uniforms.begin(), uniforms.end(),
+         [](const UniformInfo &a, const UniformInfo &b) { return a.hash < b.hash; });
+
+    for (size_t i = 1; i < uniforms.size(); i++) {
+        if (uniforms[i].hash == uniforms[i - 1].hash) {
+            std::cout << "WARNING::SHADER::PROGRAM::UNIFORM_HASH_COLLISION\n"
+                      << uniforms[i - 1].name << " and " << uniforms[i].name
+                      << " can only be looked up by name" << std::endl;
+            uniforms[i - 1].ambiguous = uniforms[i].ambiguous = true;
+        }
+    }
 }
 
 void Shader::use() 
 {
-    glUseProgram(ID);
+    glState.useProgram(ID);
 }
 
-void Shader::setBool(const std::string &name, bool value) const
+Shader::Uniform Shader::uniform(uint32_t nameHash) const
+{
+    auto it = lower_bound(uniforms.begin(), uniforms.end(), nameHash,
+                          [](const UniformInfo &info, uint32_t hash) { return info.hash < hash; });
+
+    if (it == uniforms.end() || it->hash != nameHash || it->ambiguous)
+        return Uniform{-1, -1};
+    return Uniform{it->location, (int)(it - uniforms.begin())};
+}
+
+Shader::Uniform Shader::uniform(const char *name) const
+{
+    uint32_t nameHash = uniformHash(name);
+    auto it = lower_bound(uniforms.begin(), uniforms.end(), nameHash,
+                          [](const UniformInfo &info, uint32_t hash) { return info.hash < hash; });
+
+    // Usually a single entry; several only when their hashes collided
+    for (; it != uniforms.end() && it->hash == nameHash; ++it) {
+        if (it->name == name)
+            return Uniform{it->location, (int)(it - uniforms.begin())};
+    }
+    return Uniform{-1, -1};
+}
+
+const vector<Shader::UniformInfo> &Shader::activeUniforms() const
+{
+    return uniforms;
+}
+
+// One element of the uniform, of a type its glUniform* call can take: ints
+// also set bools and samplers
+bool Shader::matches(Uniform u, GLenum type, size_t bytes) const
+{
+    const UniformInfo &info = uniforms[u.index];
+    if (bytes != info.bytes / info.size)
+        return false;
+    if (type == info.type)
+        return true;
+    return type == GL_INT && !isFloatType(info.type) && !isUnsignedType(info.type) &&
+           uniformTypeBytes(info.type) == 4;
+}
+
+void Shader::write(Uniform u, GLenum type, const void *data, size_t bytes)
+{
+    if (u.index < 0)
+        return;
+    if (!matches(u, type, bytes)) {
+        std::cout << "ERROR::SHADER::UNIFORM::TYPE_MISMATCH\n" << uniforms[u.index].name << std::endl;
+        return;
+    }
+
+    UniformInfo &info = uniforms[u.index];
+    unsigned char *value = &values[info.offset];
+    if (memcmp(value, data, bytes) == 0)
+        return;
+
+    memcpy(value, data, bytes);
+    if (!info.dirty) {
+        info.dirty = true;
+        dirtyUniforms.push_back(u.index);
+    }
+}
+
+void Shader::read(Uniform u, GLenum type, void *data, size_t bytes) const
+{
+    if (u.index < 0 || !matches(u, type, bytes)) {
+        memset(data, 0, bytes);
+        return;
+    }
+    memcpy(data, &values[uniforms[u.index].offset], bytes);
+}
+
+void Shader::setBool(const std::string &name, bool value)
 {         
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+    setBool(uniform(name.c_str()), value); 
 }
-void Shader::setInt(const std::string &name, int value) const
+void Shader::setInt(const std::string &name, int value)
 { 
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+    setInt(uniform(name.c_str()), value); 
 }
-void Shader::setFloat(const std::string &name, float value) const
+void Shader::setFloat(const std::string &name, float value)
 { 
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+    setFloat(uniform(name.c_str()), value); 
 } 
 
-void Shader::setUniform3f(const string &name, float v1, float v2, float v3) const
+void Shader::setUniform3f(const string &name, float v1, float v2, float v3)
 {
-    glUniform3f(glGetUniformLocation(ID, name.c_str()), v1, v2, v3); 
+    setUniform3f(uniform(name.c_str()), v1, v2, v3); 
 }
 
-void Shader::setMat4(const string &name, glm::mat4 mat4) const
+void Shader::setMat4(const string &name, glm::mat4 mat4)
 {   
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, glm::value_ptr(mat4));
+    setMat4(uniform(name.c_str()), mat4);
+}
+
+void Shader::setBool(Uniform u, bool value)
+{
+    setInt(u, (int)value);
+}
+
+void Shader::setInt(Uniform u, int value)
+{
+    write(u, GL_INT, &value, sizeof(value));
+}
+
+void Shader::setFloat(Uniform u, float value)
+{
+    write(u, GL_FLOAT, &value, sizeof(value));
+}
+
+void Shader::setUniform3f(Uniform u, float v1, float v2, float v3)
+{
+    glm::vec3 value(v1, v2, v3);
+    write(u, GL_FLOAT_VEC3, glm::value_ptr(value), sizeof(value));
+}
+
+void Shader::setMat4(Uniform u, const glm::mat4 &mat4)
+{
+    write(u, GL_FLOAT_MAT4, glm::value_ptr(mat4), sizeof(mat4));
+}
+
+bool Shader::getBool(Uniform u) const
+{
+    return getInt(u) != 0;
+}
+
+int Shader::getInt(Uniform u) const
+{
+    int value;
+    read(u, GL_INT, &value, sizeof(value));
+    return value;
+}
+
+float Shader::getFloat(Uniform u) const
+{
+    float value;
+    read(u, GL_FLOAT, &value, sizeof(value));
+    return value;
+}
+
+glm::vec3 Shader::getUniform3f(Uniform u) const
+{
+    glm::vec3 value;
+    read(u, GL_FLOAT_VEC3, glm::value_ptr(value), sizeof(value));
+    return value;
+}
+
+glm::mat4 Shader::getMat4(Uniform u) const
+{
+    glm::mat4 value;
+    read(u, GL_FLOAT_MAT4, glm::value_ptr(value), sizeof(value));
+    return value;
+}
+
+void Shader::flush()
+{
+    use();
+
+    for (int index : dirtyUniforms) {
+        UniformInfo &info = uniforms[index];
+        const void *value = &values[info.offset];
+
+        switch (info.type) {
+        case GL_FLOAT:        glUniform1fv(info.location, info.size, (const GLfloat *)value); break;
+        case GL_FLOAT_VEC2:   glUniform2fv(info.location, info.size, (const GLfloat *)value); break;
+        case GL_FLOAT_VEC3:   glUniform3fv(info.location, info.size, (const GLfloat *)value); break;
+        case GL_FLOAT_VEC4:   glUniform4fv(info.location, info.size, (const GLfloat *)value); break;
+        case GL_FLOAT_MAT2:   glUniformMatrix2fv(info.location, info.size, GL_FALSE, (const GLfloat *)value); break;
+        case GL_FLOAT_MAT3:   glUniformMatrix3fv(info.location, info.size, GL_FALSE, (const GLfloat *)value); break;
+        case GL_FLOAT_MAT4:   glUniformMatrix4fv(info.location, info.size, GL_FALSE, (const GLfloat *)value); break;
+        case GL_UNSIGNED_INT:      glUniform1uiv(info.location, info.size, (const GLuint *)value); break;
+        case GL_UNSIGNED_INT_VEC2: glUniform2uiv(info.location, info.size, (const GLuint *)value); break;
+        case GL_UNSIGNED_INT_VEC3: glUniform3uiv(info.location, info.size, (const GLuint *)value); break;
+        case GL_UNSIGNED_INT_VEC4: glUniform4uiv(info.location, info.size, (const GLuint *)value); break;
+        case GL_INT_VEC2: case GL_BOOL_VEC2: glUniform2iv(info.location, info.size, (const GLint *)value); break;
+        case GL_INT_VEC3: case GL_BOOL_VEC3: glUniform3iv(info.location, info.size, (const GLint *)value); break;
+        case GL_INT_VEC4: case GL_BOOL_VEC4: glUniform4iv(info.location, info.size, (const GLint *)value); break;
+        default:              glUniform1iv(info.location, info.size, (const GLint *)value); break;
+        }
+
+        info.dirty = false;
+    }
+
+    dirtyUniforms.clear();
 }
 
 void Shader::cleanup() 
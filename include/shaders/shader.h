@@ -2,20 +2,63 @@
 #define SHADER_H
 
 #include <glad/glad.h> // include glad to get all the required OpenGL headers
+#include <stdint.h>
 #include <string>
+#include <vector>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include "glm/glm.hpp"
+#include "glstate/gl_state.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 
 using namespace std;
 
+// Missing from the generated glad header
+#ifndef GL_INVALID_INDEX
+#define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif
+
+// FNV-1a hash of a uniform name. Being constexpr, names hashed into a
+// constexpr variable cost nothing at runtime.
+constexpr uint32_t uniformHash(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    while (*name)
+        hash = (hash ^ (unsigned char)*name++) * 16777619u;
+    return hash;
+}
+
 class Shader 
 {
     public:
+    // An active uniform as reported by glGetActiveUniform after linking
+    struct UniformInfo
+    {
+        uint32_t hash;
+        string name;
+        // another active uniform has the same hash
+        bool ambiguous;
+        GLint location;
+        GLenum type;
+        GLint size;
+
+        // where its CPU-side copy lives in Shader::values, and its length
+        uint32_t offset;
+        uint32_t bytes;
+        bool dirty;
+    };
+
+    // Prevalidated uniform handle. An index of -1 (inactive uniform) is
+    // silently ignored by the setters, just like glUniform* does.
+    struct Uniform
+    {
+        GLint location;
+        int index;
+    };
+
     // the program ID
     unsigned int ID;
 
@@ -29,16 +72,65 @@ class Shader
     
     // use/activate the shader
     void use();
+
+    // uniform lookups, served from the table built at link time. A hash that
+    // two active uniforms share finds neither of them; lookups by name check
+    // the name itself, so they still tell those apart.
+    Uniform uniform(uint32_t nameHash) const;
+    Uniform uniform(const char *name) const;
+    const vector<UniformInfo> &activeUniforms() const;
+
+    // Uniform blocks named here are bound to the given binding point in every
+    // program built afterwards, so one buffer can feed all of them.
+    static void registerUniformBlock(const string &name, GLuint binding);
     
-    // utility uniform functions
-    void setBool(const string &name, bool v) const;
-    void setInt(const string &name, int v) const;
-    void setFloat(const string &name, float v) const;
-    void setUniform3f(const string &name, float v1, float v2, float v3) const;
-    void setMat4(const string &name, glm::mat4 mat4) const;
+    /* utility uniform functions. These only update the CPU-side copy of the
+     uniform: writing the value it already has is free, and changed values
+     are sent to GL by the next flush().
+     */
+    void setBool(const string &name, bool v);
+    void setInt(const string &name, int v);
+    void setFloat(const string &name, float v);
+    void setUniform3f(const string &name, float v1, float v2, float v3);
+    void setMat4(const string &name, glm::mat4 mat4);
+
+    // hot-path variants that skip the name lookup entirely
+    void setBool(Uniform u, bool v);
+    void setInt(Uniform u, int v);
+    void setFloat(Uniform u, float v);
+    void setUniform3f(Uniform u, float v1, float v2, float v3);
+    void setMat4(Uniform u, const glm::mat4 &mat4);
+
+    // Read back from the CPU-side copy, never from GL
+    bool getBool(Uniform u) const;
+    int getInt(Uniform u) const;
+    float getFloat(Uniform u) const;
+    glm::vec3 getUniform3f(Uniform u) const;
+    glm::mat4 getMat4(Uniform u) const;
+
+    // Make the program current and upload every uniform changed since the
+    // last flush. Call right before drawing.
+    void flush();
 
     // Delete shader
     void cleanup();
+
+    private:
+    // sorted by hash so lookups are a binary search over a flat array
+    vector<UniformInfo> uniforms;
+
+    // CPU-side copy of every uniform value, and the uniforms not yet uploaded
+    vector<unsigned char> values;
+    vector<int> dirtyUniforms;
+
+    void reflectUniforms();
+    void bindUniformBlocks();
+
+    // type is the GL type of the value (GL_INT, GL_FLOAT, ...). Values that
+    // don't match the reflected uniform's type and size are rejected.
+    bool matches(Uniform u, GLenum type, size_t bytes) const;
+    void write(Uniform u, GLenum type, const void *data, size_t bytes);
+    void read(Uniform u, GLenum type, void *data, size_t bytes) const;
 };
 
 #endif
\ No newline at end of file
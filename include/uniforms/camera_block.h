@@ -0,0 +1,44 @@
+#ifndef CAMERA_BLOCK_H
+#define CAMERA_BLOCK_H
+
+#include "camera/camera.h"
+#include "uniforms/uniform_buffer.h"
+
+/* Mirrors the Camera block of the vertex shaders:
+
+ layout (std140) uniform Camera
+ {
+     mat4 view;
+     mat4 projection;
+     mat4 viewProjection;
+     vec3 cameraPosition;
+ };
+ */
+struct CameraBlock {
+  using Layout = std140::Block<glm::mat4, glm::mat4, glm::mat4, glm::vec3>;
+  static constexpr const char *name = "Camera";
+  static constexpr GLuint binding = 0;
+
+  glm::mat4 view;
+  glm::mat4 projection;
+  glm::mat4 viewProjection;
+  glm::vec3 position;
+  float padding;
+
+  static CameraBlock fromCamera(const Camera &cam) {
+    CameraBlock block;
+    block.view = cam.view;
+    block.projection = cam.projection;
+    block.viewProjection = cam.projection * cam.view;
+    block.position = cam.pos;
+    block.padding = 0.0f;
+    return block;
+  }
+};
+
+STD140_CHECK_MEMBER(CameraBlock, view, 0);
+STD140_CHECK_MEMBER(CameraBlock, projection, 1);
+STD140_CHECK_MEMBER(CameraBlock, viewProjection, 2);
+STD140_CHECK_MEMBER(CameraBlock, position, 3);
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef STD140_H
+#define STD140_H
+
+#include "glm/glm.hpp"
+#include <stddef.h>
+#include <stdexcept>
+
+/* Compile-time description of the std140 layout rules (OpenGL 4.6 spec,
+ section 7.6.2.2). A C++ struct mirroring a GLSL uniform block declares the
+ GLSL member types in order through std140::Block, and STD140_CHECK_MEMBER
+ then verifies that every C++ member sits exactly where the GPU expects it.
+ */
+namespace std140 {
+
+constexpr size_t alignUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Base alignment and size of a GLSL type
+template <typename T> struct Layout;
+
+template <> struct Layout<float> {
+  static constexpr size_t alignment = 4, size = 4;
+};
+template <> struct Layout<int> {
+  static constexpr size_t alignment = 4, size = 4;
+};
+template <> struct Layout<unsigned int> {
+  static constexpr size_t alignment = 4, size = 4;
+};
+template <> struct Layout<glm::vec2> {
+  static constexpr size_t alignment = 8, size = 8;
+};
+template <> struct Layout<glm::vec3> {
+  static constexpr size_t alignment = 16, size = 12;
+};
+template <> struct Layout<glm::vec4> {
+  static constexpr size_t alignment = 16, size = 16;
+};
+// Matrices are stored as arrays of column vectors
+template <> struct Layout<glm::mat4> {
+  static constexpr size_t alignment = 16, size = 64;
+};
+
+// Array elements are rounded up to the alignment of a vec4
+template <typename T, size_t N> struct Layout<T[N]> {
+  static constexpr size_t alignment = alignUp(Layout<T>::alignment, 16);
+  static constexpr size_t size = N * alignUp(Layout<T>::size, alignment);
+};
+
+// Offset of the index-th member, given the offset the previous member ended at.
+// An index past the last member throws, which fails constant evaluation.
+template <typename T> constexpr size_t memberOffset(size_t index, size_t end) {
+  return index == 0
+             ? alignUp(end, Layout<T>::alignment)
+             : throw std::out_of_range("std140 block member out of range");
+}
+
+template <typename T, typename Next, typename... Rest>
+constexpr size_t memberOffset(size_t index, size_t end) {
+  return index == 0 ? alignUp(end, Layout<T>::alignment)
+                    : memberOffset<Next, Rest...>(
+                          index - 1,
+                          alignUp(end, Layout<T>::alignment) + Layout<T>::size);
+}
+
+// Offset just past the last member
+template <typename T> constexpr size_t blockEnd(size_t end) {
+  return alignUp(end, Layout<T>::alignment) + Layout<T>::size;
+}
+
+template <typename T, typename Next, typename... Rest>
+constexpr size_t blockEnd(size_t end) {
+  return blockEnd<Next, Rest...>(alignUp(end, Layout<T>::alignment) +
+                                 Layout<T>::size);
+}
+
+// A uniform block whose members have the GLSL types Ts, in declaration order
+template <typename... Ts> struct Block {
+  static constexpr size_t count = sizeof...(Ts);
+
+  // The block is padded to a multiple of a vec4
+  static constexpr size_t size = alignUp(blockEnd<Ts...>(0), 16);
+
+  template <size_t I> static constexpr size_t offset() {
+    static_assert(I < sizeof...(Ts), "std140 block member out of range");
+    return memberOffset<Ts...>(I, 0);
+  }
+};
+
+} // namespace std140
+
+// Fails to compile if Struct::member is not at the std140 offset of the
+// index-th member of Struct::Layout, or if its C++ type has a different size.
+#define STD140_CHECK_MEMBER(Struct, member, index)                             \
+  static_assert(offsetof(Struct, member) ==                                    \
+                    Struct::Layout::offset<index>(),                           \
+                #Struct "::" #member " is not at its std140 offset");          \
+  static_assert(sizeof(Struct::member) ==                                      \
+                    std140::Layout<decltype(Struct::member)>::size,            \
+                #Struct "::" #member " does not match its std140 size")
+
+#endif
@@ -0,0 +1,29 @@
+#include "uniform_buffer.h"
+#include "glstate/gl_state.h"
+#include "shaders/shader.h"
+
+UniformBufferObject::UniformBufferObject() {
+  ID = 0;
+  binding = 0;
+  size = 0;
+}
+
+void UniformBufferObject::create(const char *blockName, GLuint newBinding,
+                                 GLsizeiptr newSize) {
+  binding = newBinding;
+  size = newSize;
+
+  glGenBuffers(1, &ID);
+  glState.bindBuffer(GL_UNIFORM_BUFFER, ID);
+  glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+  glState.bindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+
+  Shader::registerUniformBlock(blockName, binding);
+}
+
+void UniformBufferObject::upload(const void *data, GLsizeiptr dataSize) {
+  glState.bindBuffer(GL_UNIFORM_BUFFER, ID);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, dataSize, data);
+}
+
+void UniformBufferObject::cleanup() { glState.deleteBuffers(1, &ID); }
@@ -0,0 +1,39 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <glad/glad.h> // include glad to get all the required OpenGL headers
+
+#include "uniforms/std140.h"
+
+// A GL_UNIFORM_BUFFER permanently attached to one binding point. Every Shader
+// built after create() has its block of the same name bound to that point.
+class UniformBufferObject {
+public:
+  UniformBufferObject();
+
+  unsigned int ID;
+  GLuint binding;
+  GLsizeiptr size;
+
+  void create(const char *blockName, GLuint binding, GLsizeiptr size);
+  void upload(const void *data, GLsizeiptr size);
+  void cleanup();
+};
+
+/* Typed uniform buffer. Block must describe its GLSL layout with a
+ std140::Block typedef named Layout, and provide the GLSL block name and its
+ binding point as static members `name` and `binding`.
+ */
+template <typename Block> class UniformBuffer : public UniformBufferObject {
+public:
+  static_assert(sizeof(Block) == Block::Layout::size,
+                "uniform block struct does not match its std140 size");
+
+  void create() {
+    UniformBufferObject::create(Block::name, Block::binding, sizeof(Block));
+  }
+
+  void update(const Block &block) { upload(&block, sizeof(Block)); }
+};
+
+#endif
@@ -35,18 +35,41 @@ namespace detail
 		}
 	};
 
+	template<qualifier Q>
+	struct compute_length<3, float, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static float call(vec<3, float, Q> const& v)
+		{
+			return _mm_cvtss_f32(glm_vec3_length(v.data));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_distance<3, float, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static float call(vec<3, float, Q> const& p0, vec<3, float, Q> const& p1)
+		{
+			return _mm_cvtss_f32(glm_vec3_distance(p0.data, p1.data));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_dot<vec<3, float, Q>, float, true>
+	{
+		GLM_FUNC_QUALIFIER static float call(vec<3, float, Q> const& x, vec<3, float, Q> const& y)
+		{
+			return _mm_cvtss_f32(glm_vec3_dot(x.data, y.data));
+		}
+	};
+
 	template<qualifier Q>
 	struct compute_cross<float, Q, true>
 	{
 		GLM_FUNC_QUALIFIER static vec<3, float, Q> call(vec<3, float, Q> const& a, vec<3, float, Q> const& b)
 		{
-			__m128 const set0 = _mm_set_ps(0.0f, a.z, a.y, a.x);
-			__m128 const set1 = _mm_set_ps(0.0f, b.z, b.y, b.x);
-			__m128 const xpd0 = glm_vec4_cross(set0, set1);
-
-			vec<4, float, Q> Result;
-			Result.data = xpd0;
-			return vec<3, float, Q>(Result);
+			vec<3, float, Q> Result;
+			Result.data = glm_vec4_cross(a.data, b.data);
+			return Result;
 		}
 	};
 
@@ -61,6 +84,28 @@ namespace detail
 		}
 	};
 
+	template<qualifier Q>
+	struct compute_normalize<3, float, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<3, float, Q> call(vec<3, float, Q> const& v)
+		{
+			vec<3, float, Q> Result;
+			Result.data = glm_vec3_normalize(v.data);
+			return Result;
+		}
+	};
+
+	template<>
+	struct compute_normalize<3, float, aligned_lowp, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<3, float, aligned_lowp> call(vec<3, float, aligned_lowp> const& v)
+		{
+			vec<3, float, aligned_lowp> Result;
+			Result.data = glm_vec3_normalize_lowp(v.data);
+			return Result;
+		}
+	};
+
 	template<qualifier Q>
 	struct compute_faceforward<4, float, Q, true>
 	{
@@ -93,6 +138,95 @@ namespace detail
 			return Result;
 		}
 	};
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_length<4, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(vec<4, double, Q> const& v)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dvec4_length(v.data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_length<3, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(vec<3, double, Q> const& v)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dvec3_length(v.data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_distance<4, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(vec<4, double, Q> const& p0, vec<4, double, Q> const& p1)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dvec4_distance(p0.data, p1.data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_distance<3, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(vec<3, double, Q> const& p0, vec<3, double, Q> const& p1)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dvec3_distance(p0.data, p1.data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_dot<vec<4, double, Q>, double, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(vec<4, double, Q> const& x, vec<4, double, Q> const& y)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dvec4_dot(x.data, y.data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_dot<vec<3, double, Q>, double, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(vec<3, double, Q> const& x, vec<3, double, Q> const& y)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dvec3_dot(x.data, y.data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_cross<double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<3, double, Q> call(vec<3, double, Q> const& a, vec<3, double, Q> const& b)
+		{
+			vec<3, double, Q> Result;
+			Result.data = glm_dvec3_cross(a.data, b.data);
+			return Result;
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_normalize<4, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<4, double, Q> call(vec<4, double, Q> const& v)
+		{
+			vec<4, double, Q> Result;
+			Result.data = glm_dvec4_normalize(v.data);
+			return Result;
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_normalize<3, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static vec<3, double, Q> call(vec<3, double, Q> const& v)
+		{
+			vec<3, double, Q> Result;
+			Result.data = glm_dvec3_normalize(v.data);
+			return Result;
+		}
+	};
+#	endif
 }//namespace detail
 }//namespace glm
 
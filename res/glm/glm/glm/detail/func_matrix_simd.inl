@@ -32,7 +32,11 @@ namespace detail
 		GLM_FUNC_QUALIFIER static mat<4, 4, float, Q> call(mat<4, 4, float, Q> const& m)
 		{
 			mat<4, 4, float, Q> Result;
-			glm_mat4_transpose(&m[0].data, &Result[0].data);
+#			if GLM_ARCH & GLM_ARCH_AVX2_BIT
+				glm_mat4_transpose_avx2(&m[0].data, &Result[0].data);
+#			else
+				glm_mat4_transpose(&m[0].data, &Result[0].data);
+#			endif
 			return Result;
 		}
 	};
@@ -52,10 +56,49 @@ namespace detail
 		GLM_FUNC_QUALIFIER static mat<4, 4, float, Q> call(mat<4, 4, float, Q> const& m)
 		{
 			mat<4, 4, float, Q> Result;
-			glm_mat4_inverse(&m[0].data, &Result[0].data);
+#			if GLM_ARCH & GLM_ARCH_AVX_BIT
+				glm_mat4_inverse_avx(&m[0].data, &Result[0].data);
+#			else
+				glm_mat4_inverse(&m[0].data, &Result[0].data);
+#			endif
 			return Result;
 		}
 	};
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_transpose<4, 4, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static mat<4, 4, double, Q> call(mat<4, 4, double, Q> const& m)
+		{
+			mat<4, 4, double, Q> Result;
+			glm_dmat4_transpose(&m[0].data, &Result[0].data);
+			return Result;
+		}
+	};
+#	endif
+
+#	if GLM_ARCH & GLM_ARCH_AVX2_BIT
+	template<qualifier Q>
+	struct compute_determinant<4, 4, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static double call(mat<4, 4, double, Q> const& m)
+		{
+			return _mm_cvtsd_f64(_mm256_castpd256_pd128(glm_dmat4_determinant(&m[0].data)));
+		}
+	};
+
+	template<qualifier Q>
+	struct compute_inverse<4, 4, double, Q, true>
+	{
+		GLM_FUNC_QUALIFIER static mat<4, 4, double, Q> call(mat<4, 4, double, Q> const& m)
+		{
+			mat<4, 4, double, Q> Result;
+			glm_dmat4_inverse(&m[0].data, &Result[0].data);
+			return Result;
+		}
+	};
+#	endif
 }//namespace detail
 
 #	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
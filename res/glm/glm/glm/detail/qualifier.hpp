@@ -108,6 +108,12 @@ namespace detail
 #	endif
 
 #	if GLM_ARCH & GLM_ARCH_SSE2_BIT
+	template<>
+	struct storage<3, float, true>
+	{
+		typedef glm_f32vec4 type;
+	};
+
 	template<>
 	struct storage<4, float, true>
 	{
@@ -146,6 +152,12 @@ namespace detail
 #	endif
 
 #	if (GLM_ARCH & GLM_ARCH_AVX_BIT)
+	template<>
+	struct storage<3, double, true>
+	{
+		typedef glm_f64vec4 type;
+	};
+
 	template<>
 	struct storage<4, double, true>
 	{
@@ -0,0 +1,213 @@
+/// @ref core
+/// @file glm/detail/type_vec3_simd.inl
+
+// Aligned float vec3 is stored in a __m128 and, with AVX, aligned double vec3
+// in a __m256d. The fourth lane is padding: the operators leave whatever they
+// compute there and the horizontal kernels of simd/geometric.h mask it out.
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+// The constructor specializations instantiate the aligned vec3 types and
+// their swizzle members, the SIMD swizzles of vec4 have to be declared first
+#include "type_vec4.hpp"
+
+namespace glm{
+namespace detail
+{
+	template<qualifier Q>
+	struct compute_vec3_add<float, Q, true>
+	{
+		static vec<3, float, Q> call(vec<3, float, Q> const& a, vec<3, float, Q> const& b)
+		{
+			vec<3, float, Q> Result;
+			Result.data = _mm_add_ps(a.data, b.data);
+			return Result;
+		}
+	};
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_vec3_add<double, Q, true>
+	{
+		static vec<3, double, Q> call(vec<3, double, Q> const& a, vec<3, double, Q> const& b)
+		{
+			vec<3, double, Q> Result;
+			Result.data = _mm256_add_pd(a.data, b.data);
+			return Result;
+		}
+	};
+#	endif
+
+	template<qualifier Q>
+	struct compute_vec3_sub<float, Q, true>
+	{
+		static vec<3, float, Q> call(vec<3, float, Q> const& a, vec<3, float, Q> const& b)
+		{
+			vec<3, float, Q> Result;
+			Result.data = _mm_sub_ps(a.data, b.data);
+			return Result;
+		}
+	};
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_vec3_sub<double, Q, true>
+	{
+		static vec<3, double, Q> call(vec<3, double, Q> const& a, vec<3, double, Q> const& b)
+		{
+			vec<3, double, Q> Result;
+			Result.data = _mm256_sub_pd(a.data, b.data);
+			return Result;
+		}
+	};
+#	endif
+
+	template<qualifier Q>
+	struct compute_vec3_mul<float, Q, true>
+	{
+		static vec<3, float, Q> call(vec<3, float, Q> const& a, vec<3, float, Q> const& b)
+		{
+			vec<3, float, Q> Result;
+			Result.data = _mm_mul_ps(a.data, b.data);
+			return Result;
+		}
+	};
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_vec3_mul<double, Q, true>
+	{
+		static vec<3, double, Q> call(vec<3, double, Q> const& a, vec<3, double, Q> const& b)
+		{
+			vec<3, double, Q> Result;
+			Result.data = _mm256_mul_pd(a.data, b.data);
+			return Result;
+		}
+	};
+#	endif
+
+	template<qualifier Q>
+	struct compute_vec3_div<float, Q, true>
+	{
+		static vec<3, float, Q> call(vec<3, float, Q> const& a, vec<3, float, Q> const& b)
+		{
+			vec<3, float, Q> Result;
+			Result.data = _mm_div_ps(a.data, b.data);
+			return Result;
+		}
+	};
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<qualifier Q>
+	struct compute_vec3_div<double, Q, true>
+	{
+		static vec<3, double, Q> call(vec<3, double, Q> const& a, vec<3, double, Q> const& b)
+		{
+			vec<3, double, Q> Result;
+			Result.data = _mm256_div_pd(a.data, b.data);
+			return Result;
+		}
+	};
+#	endif
+}//namespace detail
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_lowp>::vec(float _s) :
+		data(_mm_set1_ps(_s))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_mediump>::vec(float _s) :
+		data(_mm_set1_ps(_s))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_highp>::vec(float _s) :
+		data(_mm_set1_ps(_s))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_lowp>::vec(float _x, float _y, float _z) :
+		data(_mm_set_ps(0.0f, _z, _y, _x))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_mediump>::vec(float _x, float _y, float _z) :
+		data(_mm_set_ps(0.0f, _z, _y, _x))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_highp>::vec(float _x, float _y, float _z) :
+		data(_mm_set_ps(0.0f, _z, _y, _x))
+	{}
+
+	template<>
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_lowp>::vec(vec<3, float, packed_lowp> const& v) :
+		data(_mm_set_ps(0.0f, v.z, v.y, v.x))
+	{}
+
+	template<>
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_mediump>::vec(vec<3, float, packed_mediump> const& v) :
+		data(_mm_set_ps(0.0f, v.z, v.y, v.x))
+	{}
+
+	template<>
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, float, aligned_highp>::vec(vec<3, float, packed_highp> const& v) :
+		data(_mm_set_ps(0.0f, v.z, v.y, v.x))
+	{}
+
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_lowp>::vec(double _s) :
+		data(_mm256_set1_pd(_s))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_mediump>::vec(double _s) :
+		data(_mm256_set1_pd(_s))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_highp>::vec(double _s) :
+		data(_mm256_set1_pd(_s))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_lowp>::vec(double _x, double _y, double _z) :
+		data(_mm256_set_pd(0.0, _z, _y, _x))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_mediump>::vec(double _x, double _y, double _z) :
+		data(_mm256_set_pd(0.0, _z, _y, _x))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_highp>::vec(double _x, double _y, double _z) :
+		data(_mm256_set_pd(0.0, _z, _y, _x))
+	{}
+
+	template<>
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_lowp>::vec(vec<3, double, packed_lowp> const& v) :
+		data(_mm256_set_pd(0.0, v.z, v.y, v.x))
+	{}
+
+	template<>
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_mediump>::vec(vec<3, double, packed_mediump> const& v) :
+		data(_mm256_set_pd(0.0, v.z, v.y, v.x))
+	{}
+
+	template<>
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<3, double, aligned_highp>::vec(vec<3, double, packed_highp> const& v) :
+		data(_mm256_set_pd(0.0, v.z, v.y, v.x))
+	{}
+#	endif
+}//namespace glm
+
+#endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -423,6 +423,23 @@ namespace detail
 		data(_mm_set_ps(_w, _z, _y, _x))
 	{}
 
+#	if GLM_ARCH & GLM_ARCH_AVX_BIT
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<4, double, aligned_lowp>::vec(double _x, double _y, double _z, double _w) :
+		data(_mm256_set_pd(_w, _z, _y, _x))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<4, double, aligned_mediump>::vec(double _x, double _y, double _z, double _w) :
+		data(_mm256_set_pd(_w, _z, _y, _x))
+	{}
+
+	template<>
+	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<4, double, aligned_highp>::vec(double _x, double _y, double _z, double _w) :
+		data(_mm256_set_pd(_w, _z, _y, _x))
+	{}
+#	endif
+
 	template<>
 	template<>
 	GLM_FUNC_QUALIFIER GLM_CONSTEXPR vec<4, int, aligned_lowp>::vec(int _x, int _y, int _z, int _w) :
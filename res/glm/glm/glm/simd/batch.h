@@ -0,0 +1,586 @@
+/// @ref simd
+/// @file glm/simd/batch.h
+///
+/// Batched kernels over spans of vectors and matrices, in AoS and SoA layouts.
+///
+/// Unlike the rest of glm/simd, the instruction set is chosen at runtime: every
+/// call goes to the widest kernel the CPU and the OS support (SSE 4.1, AVX2 with
+/// FMA or AVX-512), whatever the build targets. glm_batch_set_isa() overrides it.
+///
+/// Each kernel gives the same bits as glm::detail::batch_scalar with the same
+/// Fused argument (glm_batch_fused()), including the elements left over past the
+/// last full register. Kernels with FMA round every multiply-add once, the
+/// others twice, so results may only differ between those two groups.
+/// Outputs may alias inputs of the same layout.
+
+#pragma once
+
+#include "../detail/setup.hpp"
+#include <cmath>
+#include <math.h>
+#include <cstddef>
+
+#if (GLM_ARCH & GLM_ARCH_X86_BIT) && (GLM_COMPILER & (GLM_COMPILER_GCC | GLM_COMPILER_CLANG | GLM_COMPILER_VC))
+#	define GLM_BATCH_DISPATCH
+#	include <immintrin.h>
+#	if GLM_COMPILER & GLM_COMPILER_VC
+#		include <intrin.h>
+#		define GLM_BATCH_TARGET(isa)
+#	else
+#		include <cpuid.h>
+#		define GLM_BATCH_TARGET(isa) __attribute__((target(isa)))
+#	endif
+#endif
+
+// Keeps a value rounded on its own. GCC fuses multiplies and adds whenever
+// FMA is enabled, even across statements, and the unfused kernels have to
+// round the way the reference does.
+#if (GLM_COMPILER & (GLM_COMPILER_GCC | GLM_COMPILER_CLANG)) && defined(__SSE__)
+#	define GLM_BATCH_ROUNDED(x) __asm__("" : "+x"(x))
+#else
+#	define GLM_BATCH_ROUNDED(x)
+#endif
+
+enum glm_batch_isa
+{
+	GLM_BATCH_SCALAR,
+	GLM_BATCH_SSE4_1,
+	GLM_BATCH_AVX2,
+	GLM_BATCH_AVX512
+};
+
+namespace glm{
+namespace detail{
+namespace batch_scalar
+{
+	inline float fma(float a, float b, float c)
+	{
+#		if GLM_HAS_CXX11_STL
+			return std::fma(a, b, c);
+#		else
+			return ::fmaf(a, b, c);
+#		endif
+	}
+
+	template<bool Fused>
+	inline float madd(float a, float b, float c)
+	{
+		if(Fused)
+			return fma(a, b, c);
+		float product = a * b;
+		GLM_BATCH_ROUNDED(product);
+		GLM_BATCH_ROUNDED(c);
+		return product + c;
+	}
+
+	template<bool Fused>
+	inline float msub(float a, float b, float c)
+	{
+		if(Fused)
+			return fma(a, b, -c);
+		float product = a * b;
+		GLM_BATCH_ROUNDED(product);
+		GLM_BATCH_ROUNDED(c);
+		return product - c;
+	}
+
+	// Components are separate arrays, and vectors are step floats apart in
+	// them: 1 for SoA, or the vector size for AoS
+
+	template<bool Fused>
+	inline void mat4_mul_vec4_strided(float const* const in[4], float const m[16], float* const out[4], std::size_t step, std::size_t count)
+	{
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			float const vx = in[0][i * step], vy = in[1][i * step], vz = in[2][i * step], vw = in[3][i * step];
+			for(int row = 0; row < 4; ++row)
+				out[row][i * step] = madd<Fused>(m[12 + row], vw, madd<Fused>(m[8 + row], vz, madd<Fused>(m[4 + row], vy, m[row] * vx)));
+		}
+	}
+
+	template<bool Fused>
+	inline float dot(float ax, float ay, float az, float bx, float by, float bz)
+	{
+		return madd<Fused>(az, bz, madd<Fused>(ay, by, ax * bx));
+	}
+
+	template<bool Fused>
+	inline void vec3_dot_strided(float const* const a[3], float const* const b[3], float* out, std::size_t step, std::size_t count)
+	{
+		for(std::size_t i = 0; i < count; ++i)
+			out[i] = dot<Fused>(a[0][i * step], a[1][i * step], a[2][i * step], b[0][i * step], b[1][i * step], b[2][i * step]);
+	}
+
+	template<bool Fused>
+	inline void vec3_cross_strided(float const* const a[3], float const* const b[3], float* const out[3], std::size_t step, std::size_t count)
+	{
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			float const ax = a[0][i * step], ay = a[1][i * step], az = a[2][i * step];
+			float const bx = b[0][i * step], by = b[1][i * step], bz = b[2][i * step];
+			out[0][i * step] = msub<Fused>(ay, bz, az * by);
+			out[1][i * step] = msub<Fused>(az, bx, ax * bz);
+			out[2][i * step] = msub<Fused>(ax, by, ay * bx);
+		}
+	}
+
+	template<bool Fused>
+	inline void vec3_normalize_strided(float const* const in[3], float* const out[3], std::size_t step, std::size_t count)
+	{
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			float const x = in[0][i * step], y = in[1][i * step], z = in[2][i * step];
+			float const length = std::sqrt(dot<Fused>(x, y, z, x, y, z));
+			out[0][i * step] = x / length;
+			out[1][i * step] = y / length;
+			out[2][i * step] = z / length;
+		}
+	}
+
+	// The span entry points, which the SIMD kernels mirror
+
+	template<bool Fused>
+	inline void mat4_mul_vec4(float const m[16], float const* in, float* out, std::size_t count)
+	{
+		float const* const ins[4] = {in, in + 1, in + 2, in + 3};
+		float* const outs[4] = {out, out + 1, out + 2, out + 3};
+		mat4_mul_vec4_strided<Fused>(ins, m, outs, 4, count);
+	}
+
+	template<bool Fused>
+	inline void mat4_mul_vec4_soa(float const m[16], float const* const in[4], float* const out[4], std::size_t count)
+	{
+		mat4_mul_vec4_strided<Fused>(in, m, out, 1, count);
+	}
+
+	template<bool Fused>
+	inline void vec3_dot(float const* a, float const* b, float* out, std::size_t count)
+	{
+		float const* const as[3] = {a, a + 1, a + 2};
+		float const* const bs[3] = {b, b + 1, b + 2};
+		vec3_dot_strided<Fused>(as, bs, out, 3, count);
+	}
+
+	template<bool Fused>
+	inline void vec3_dot_soa(float const* const a[3], float const* const b[3], float* out, std::size_t count)
+	{
+		vec3_dot_strided<Fused>(a, b, out, 1, count);
+	}
+
+	template<bool Fused>
+	inline void vec3_cross(float const* a, float const* b, float* out, std::size_t count)
+	{
+		float const* const as[3] = {a, a + 1, a + 2};
+		float const* const bs[3] = {b, b + 1, b + 2};
+		float* const outs[3] = {out, out + 1, out + 2};
+		vec3_cross_strided<Fused>(as, bs, outs, 3, count);
+	}
+
+	template<bool Fused>
+	inline void vec3_cross_soa(float const* const a[3], float const* const b[3], float* const out[3], std::size_t count)
+	{
+		vec3_cross_strided<Fused>(a, b, out, 1, count);
+	}
+
+	template<bool Fused>
+	inline void vec3_normalize(float const* in, float* out, std::size_t count)
+	{
+		float const* const ins[3] = {in, in + 1, in + 2};
+		float* const outs[3] = {out, out + 1, out + 2};
+		vec3_normalize_strided<Fused>(ins, outs, 3, count);
+	}
+
+	template<bool Fused>
+	inline void vec3_normalize_soa(float const* const in[3], float* const out[3], std::size_t count)
+	{
+		vec3_normalize_strided<Fused>(in, out, 1, count);
+	}
+}//namespace batch_scalar
+
+#ifdef GLM_BATCH_DISPATCH
+
+	inline void batch_cpuid(int leaf, int subleaf, unsigned int regs[4])
+	{
+#		if GLM_COMPILER & GLM_COMPILER_VC
+			int r[4];
+			__cpuidex(r, leaf, subleaf);
+			for(int i = 0; i < 4; ++i)
+				regs[i] = static_cast<unsigned int>(r[i]);
+#		else
+			__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#		endif
+	}
+
+	// Which register states the OS saves on context switches
+	inline unsigned long long batch_xgetbv()
+	{
+#		if GLM_COMPILER & GLM_COMPILER_VC
+			return _xgetbv(0);
+#		else
+			unsigned int eax, edx;
+			__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+			return (static_cast<unsigned long long>(edx) << 32) | eax;
+#		endif
+	}
+
+	inline glm_batch_isa batch_detect()
+	{
+		unsigned int regs[4];
+		batch_cpuid(0, 0, regs);
+		unsigned int const maxLeaf = regs[0];
+		if(maxLeaf < 1)
+			return GLM_BATCH_SCALAR;
+
+		batch_cpuid(1, 0, regs);
+		bool const sse41 = (regs[2] >> 19) & 1;
+		bool const fma = (regs[2] >> 12) & 1;
+		bool const osxsave = (regs[2] >> 27) & 1;
+		bool const avx = (regs[2] >> 28) & 1;
+		if(!sse41)
+			return GLM_BATCH_SCALAR;
+		if(!osxsave || !avx || !fma || maxLeaf < 7)
+			return GLM_BATCH_SSE4_1;
+
+		unsigned long long const xcr0 = batch_xgetbv();
+		batch_cpuid(7, 0, regs);
+		bool const avx2 = (regs[1] >> 5) & 1;
+		bool const avx512f = (regs[1] >> 16) & 1;
+		// XMM and YMM, then opmask and both halves of ZMM
+		if(!avx2 || (xcr0 & 0x06) != 0x06)
+			return GLM_BATCH_SSE4_1;
+		if(!avx512f || (xcr0 & 0xE6) != 0xE6)
+			return GLM_BATCH_AVX2;
+		return GLM_BATCH_AVX512;
+	}
+
+namespace batch_sse4_1
+{
+#	define GLM_BATCH_KERNEL inline GLM_BATCH_TARGET("sse4.1")
+
+	typedef __m128 wide;
+	static std::size_t const lanes = 4;
+	static bool const fused = false;
+
+	GLM_BATCH_KERNEL wide load(float const* p) { return _mm_loadu_ps(p); }
+	GLM_BATCH_KERNEL void store(float* p, wide v) { _mm_storeu_ps(p, v); }
+	GLM_BATCH_KERNEL wide set1(float s) { return _mm_set1_ps(s); }
+	GLM_BATCH_KERNEL wide mul(wide a, wide b) { return _mm_mul_ps(a, b); }
+	GLM_BATCH_KERNEL wide div(wide a, wide b) { return _mm_div_ps(a, b); }
+	GLM_BATCH_KERNEL wide sqrt(wide a) { return _mm_sqrt_ps(a); }
+
+	GLM_BATCH_KERNEL wide madd(wide a, wide b, wide c)
+	{
+		wide product = _mm_mul_ps(a, b);
+		GLM_BATCH_ROUNDED(product);
+		GLM_BATCH_ROUNDED(c);
+		return _mm_add_ps(product, c);
+	}
+
+	GLM_BATCH_KERNEL wide msub(wide a, wide b, wide c)
+	{
+		wide product = _mm_mul_ps(a, b);
+		GLM_BATCH_ROUNDED(product);
+		GLM_BATCH_ROUNDED(c);
+		return _mm_sub_ps(product, c);
+	}
+
+
+	// A vec4 in every 128 bit lane, and one of its components across it
+	GLM_BATCH_KERNEL wide broadcast4(float const* p) { return _mm_loadu_ps(p); }
+	GLM_BATCH_KERNEL wide splat_x(wide v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)); }
+	GLM_BATCH_KERNEL wide splat_y(wide v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)); }
+	GLM_BATCH_KERNEL wide splat_z(wide v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)); }
+	GLM_BATCH_KERNEL wide splat_w(wide v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+	// Four packed vec3 (x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3) to and from
+	// one register per component
+	GLM_BATCH_KERNEL void load3(float const* p, wide& x, wide& y, wide& z)
+	{
+		wide const a = _mm_loadu_ps(p), b = _mm_loadu_ps(p + 4), c = _mm_loadu_ps(p + 8);
+		wide const qx = _mm_blend_ps(_mm_blend_ps(a, b, 0x4), c, 0x2);
+		wide const qy = _mm_blend_ps(_mm_blend_ps(a, b, 0x9), c, 0x4);
+		wide const qz = _mm_blend_ps(_mm_blend_ps(a, b, 0x2), c, 0x9);
+		x = _mm_shuffle_ps(qx, qx, _MM_SHUFFLE(1, 2, 3, 0));
+		y = _mm_shuffle_ps(qy, qy, _MM_SHUFFLE(2, 3, 0, 1));
+		z = _mm_shuffle_ps(qz, qz, _MM_SHUFFLE(3, 0, 1, 2));
+	}
+
+	GLM_BATCH_KERNEL void store3(float* p, wide x, wide y, wide z)
+	{
+		wide const qx = _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 2, 3, 0));
+		wide const qy = _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 3, 0, 1));
+		wide const qz = _mm_shuffle_ps(z, z, _MM_SHUFFLE(3, 0, 1, 2));
+		_mm_storeu_ps(p, _mm_blend_ps(_mm_blend_ps(qx, qy, 0x2), qz, 0x4));
+		_mm_storeu_ps(p + 4, _mm_blend_ps(_mm_blend_ps(qy, qz, 0x2), qx, 0x4));
+		_mm_storeu_ps(p + 8, _mm_blend_ps(_mm_blend_ps(qz, qx, 0x2), qy, 0x4));
+	}
+
+#	include "batch_kernels.h"
+#	undef GLM_BATCH_KERNEL
+}//namespace batch_sse4_1
+
+namespace batch_avx2
+{
+#	define GLM_BATCH_KERNEL inline GLM_BATCH_TARGET("avx2,fma")
+
+	typedef __m256 wide;
+	static std::size_t const lanes = 8;
+	static bool const fused = true;
+
+	GLM_BATCH_KERNEL wide load(float const* p) { return _mm256_loadu_ps(p); }
+	GLM_BATCH_KERNEL void store(float* p, wide v) { _mm256_storeu_ps(p, v); }
+	GLM_BATCH_KERNEL wide set1(float s) { return _mm256_set1_ps(s); }
+	GLM_BATCH_KERNEL wide mul(wide a, wide b) { return _mm256_mul_ps(a, b); }
+	GLM_BATCH_KERNEL wide div(wide a, wide b) { return _mm256_div_ps(a, b); }
+	GLM_BATCH_KERNEL wide sqrt(wide a) { return _mm256_sqrt_ps(a); }
+	GLM_BATCH_KERNEL wide madd(wide a, wide b, wide c) { return _mm256_fmadd_ps(a, b, c); }
+	GLM_BATCH_KERNEL wide msub(wide a, wide b, wide c) { return _mm256_fmsub_ps(a, b, c); }
+
+	GLM_BATCH_KERNEL wide broadcast4(float const* p) { return _mm256_broadcast_ps(reinterpret_cast<__m128 const*>(p)); }
+	GLM_BATCH_KERNEL wide splat_x(wide v) { return _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)); }
+	GLM_BATCH_KERNEL wide splat_y(wide v) { return _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)); }
+	GLM_BATCH_KERNEL wide splat_z(wide v) { return _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)); }
+	GLM_BATCH_KERNEL wide splat_w(wide v) { return _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+	// As for SSE 4.1, with vec3 0-3 in the low lane and 4-7 in the high one
+	GLM_BATCH_KERNEL wide load_lanes(float const* p)
+	{
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + 12), 1);
+	}
+
+	GLM_BATCH_KERNEL void store_lanes(float* p, wide v)
+	{
+		_mm_storeu_ps(p, _mm256_castps256_ps128(v));
+		_mm_storeu_ps(p + 12, _mm256_extractf128_ps(v, 1));
+	}
+
+	GLM_BATCH_KERNEL void load3(float const* p, wide& x, wide& y, wide& z)
+	{
+		wide const a = load_lanes(p), b = load_lanes(p + 4), c = load_lanes(p + 8);
+		wide const qx = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x44), c, 0x22);
+		wide const qy = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x99), c, 0x44);
+		wide const qz = _mm256_blend_ps(_mm256_blend_ps(a, b, 0x22), c, 0x99);
+		x = _mm256_permute_ps(qx, _MM_SHUFFLE(1, 2, 3, 0));
+		y = _mm256_permute_ps(qy, _MM_SHUFFLE(2, 3, 0, 1));
+		z = _mm256_permute_ps(qz, _MM_SHUFFLE(3, 0, 1, 2));
+	}
+
+	GLM_BATCH_KERNEL void store3(float* p, wide x, wide y, wide z)
+	{
+		wide const qx = _mm256_permute_ps(x, _MM_SHUFFLE(1, 2, 3, 0));
+		wide const qy = _mm256_permute_ps(y, _MM_SHUFFLE(2, 3, 0, 1));
+		wide const qz = _mm256_permute_ps(z, _MM_SHUFFLE(3, 0, 1, 2));
+		store_lanes(p, _mm256_blend_ps(_mm256_blend_ps(qx, qy, 0x22), qz, 0x44));
+		store_lanes(p + 4, _mm256_blend_ps(_mm256_blend_ps(qy, qz, 0x22), qx, 0x44));
+		store_lanes(p + 8, _mm256_blend_ps(_mm256_blend_ps(qz, qx, 0x22), qy, 0x44));
+	}
+
+#	include "batch_kernels.h"
+#	undef GLM_BATCH_KERNEL
+}//namespace batch_avx2
+
+// GCC 12 sees the _mm512_undefined_* behind the AVX-512 intrinsics as
+// uninitialized reads
+#if GLM_COMPILER & GLM_COMPILER_GCC
+#	pragma GCC diagnostic push
+#	pragma GCC diagnostic ignored "-Wuninitialized"
+#	pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace batch_avx512
+{
+#	define GLM_BATCH_KERNEL inline GLM_BATCH_TARGET("avx512f")
+
+	typedef __m512 wide;
+	static std::size_t const lanes = 16;
+	static bool const fused = true;
+
+	GLM_BATCH_KERNEL wide load(float const* p) { return _mm512_loadu_ps(p); }
+	GLM_BATCH_KERNEL void store(float* p, wide v) { _mm512_storeu_ps(p, v); }
+	GLM_BATCH_KERNEL wide set1(float s) { return _mm512_set1_ps(s); }
+	GLM_BATCH_KERNEL wide mul(wide a, wide b) { return _mm512_mul_ps(a, b); }
+	GLM_BATCH_KERNEL wide div(wide a, wide b) { return _mm512_div_ps(a, b); }
+	GLM_BATCH_KERNEL wide sqrt(wide a) { return _mm512_sqrt_ps(a); }
+	GLM_BATCH_KERNEL wide madd(wide a, wide b, wide c) { return _mm512_fmadd_ps(a, b, c); }
+	GLM_BATCH_KERNEL wide msub(wide a, wide b, wide c) { return _mm512_fmsub_ps(a, b, c); }
+
+	GLM_BATCH_KERNEL wide broadcast4(float const* p) { return _mm512_broadcast_f32x4(_mm_loadu_ps(p)); }
+	GLM_BATCH_KERNEL wide splat_x(wide v) { return _mm512_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)); }
+	GLM_BATCH_KERNEL wide splat_y(wide v) { return _mm512_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)); }
+	GLM_BATCH_KERNEL wide splat_z(wide v) { return _mm512_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)); }
+	GLM_BATCH_KERNEL wide splat_w(wide v) { return _mm512_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)); }
+
+	// Four groups of four vec3, one per 128 bit lane
+	GLM_BATCH_KERNEL wide load_lanes(float const* p)
+	{
+		wide v = _mm512_castps128_ps512(_mm_loadu_ps(p));
+		v = _mm512_insertf32x4(v, _mm_loadu_ps(p + 12), 1);
+		v = _mm512_insertf32x4(v, _mm_loadu_ps(p + 24), 2);
+		return _mm512_insertf32x4(v, _mm_loadu_ps(p + 36), 3);
+	}
+
+	GLM_BATCH_KERNEL void store_lanes(float* p, wide v)
+	{
+		_mm_storeu_ps(p, _mm512_castps512_ps128(v));
+		_mm_storeu_ps(p + 12, _mm512_extractf32x4_ps(v, 1));
+		_mm_storeu_ps(p + 24, _mm512_extractf32x4_ps(v, 2));
+		_mm_storeu_ps(p + 36, _mm512_extractf32x4_ps(v, 3));
+	}
+
+	GLM_BATCH_KERNEL wide blend(wide a, wide b, __mmask16 mask) { return _mm512_mask_blend_ps(mask, a, b); }
+
+	GLM_BATCH_KERNEL void load3(float const* p, wide& x, wide& y, wide& z)
+	{
+		wide const a = load_lanes(p), b = load_lanes(p + 4), c = load_lanes(p + 8);
+		wide const qx = blend(blend(a, b, 0x4444), c, 0x2222);
+		wide const qy = blend(blend(a, b, 0x9999), c, 0x4444);
+		wide const qz = blend(blend(a, b, 0x2222), c, 0x9999);
+		x = _mm512_permute_ps(qx, _MM_SHUFFLE(1, 2, 3, 0));
+		y = _mm512_permute_ps(qy, _MM_SHUFFLE(2, 3, 0, 1));
+		z = _mm512_permute_ps(qz, _MM_SHUFFLE(3, 0, 1, 2));
+	}
+
+	GLM_BATCH_KERNEL void store3(float* p, wide x, wide y, wide z)
+	{
+		wide const qx = _mm512_permute_ps(x, _MM_SHUFFLE(1, 2, 3, 0));
+		wide const qy = _mm512_permute_ps(y, _MM_SHUFFLE(2, 3, 0, 1));
+		wide const qz = _mm512_permute_ps(z, _MM_SHUFFLE(3, 0, 1, 2));
+		store_lanes(p, blend(blend(qx, qy, 0x2222), qz, 0x4444));
+		store_lanes(p + 4, blend(blend(qy, qz, 0x2222), qx, 0x4444));
+		store_lanes(p + 8, blend(blend(qz, qx, 0x2222), qy, 0x4444));
+	}
+
+#	include "batch_kernels.h"
+#	undef GLM_BATCH_KERNEL
+}//namespace batch_avx512
+
+#if GLM_COMPILER & GLM_COMPILER_GCC
+#	pragma GCC diagnostic pop
+#endif
+
+#endif//GLM_BATCH_DISPATCH
+
+	inline glm_batch_isa& batch_isa()
+	{
+#		ifdef GLM_BATCH_DISPATCH
+			static glm_batch_isa isa = batch_detect();
+#		else
+			static glm_batch_isa isa = GLM_BATCH_SCALAR;
+#		endif
+		return isa;
+	}
+}//namespace detail
+}//namespace glm
+
+#ifdef GLM_BATCH_DISPATCH
+#	define GLM_BATCH_CALL(kernel, args) \
+		switch(glm::detail::batch_isa()) \
+		{ \
+		case GLM_BATCH_AVX512: glm::detail::batch_avx512::kernel args; return; \
+		case GLM_BATCH_AVX2: glm::detail::batch_avx2::kernel args; return; \
+		case GLM_BATCH_SSE4_1: glm::detail::batch_sse4_1::kernel args; return; \
+		default: glm::detail::batch_scalar::kernel<false> args; return; \
+		}
+#else
+#	define GLM_BATCH_CALL(kernel, args) glm::detail::batch_scalar::kernel<false> args;
+#endif
+
+/// The best kernels this CPU and OS support
+GLM_FUNC_QUALIFIER glm_batch_isa glm_batch_detect_isa()
+{
+#	ifdef GLM_BATCH_DISPATCH
+		return glm::detail::batch_detect();
+#	else
+		return GLM_BATCH_SCALAR;
+#	endif
+}
+
+/// The kernels every call below uses, glm_batch_detect_isa() until set
+GLM_FUNC_QUALIFIER glm_batch_isa glm_batch_get_isa()
+{
+	return glm::detail::batch_isa();
+}
+
+/// Uses `isa`, or the best supported kernels below it, from now on. Returns
+/// what was picked. Not safe while other threads are calling the kernels.
+GLM_FUNC_QUALIFIER glm_batch_isa glm_batch_set_isa(glm_batch_isa isa)
+{
+	glm_batch_isa const best = glm_batch_detect_isa();
+	glm::detail::batch_isa() = isa < best ? isa : best;
+	return glm::detail::batch_isa();
+}
+
+GLM_FUNC_QUALIFIER char const* glm_batch_isa_name(glm_batch_isa isa)
+{
+	switch(isa)
+	{
+	case GLM_BATCH_SSE4_1: return "SSE4.1";
+	case GLM_BATCH_AVX2: return "AVX2+FMA";
+	case GLM_BATCH_AVX512: return "AVX-512";
+	default: return "scalar";
+	}
+}
+
+/// Whether the kernels of `isa` round each multiply-add once
+GLM_FUNC_QUALIFIER bool glm_batch_fused(glm_batch_isa isa)
+{
+	return isa >= GLM_BATCH_AVX2;
+}
+
+/// out[i] = m * in[i], over count vec4 stored as x y z w. m is column major,
+/// as glm::value_ptr gives it.
+GLM_FUNC_QUALIFIER void glm_batch_mat4_mul_vec4(float const m[16], float const* in, float* out, std::size_t count)
+{
+	GLM_BATCH_CALL(mat4_mul_vec4, (m, in, out, count))
+}
+
+/// out[i] = a * b[i], over count column major mat4
+GLM_FUNC_QUALIFIER void glm_batch_mat4_mul(float const a[16], float const* b, float* out, std::size_t count)
+{
+	glm_batch_mat4_mul_vec4(a, b, out, count * 4);
+}
+
+/// out[i] = dot(a[i], b[i]), over count vec3 stored as x y z
+GLM_FUNC_QUALIFIER void glm_batch_vec3_dot(float const* a, float const* b, float* out, std::size_t count)
+{
+	GLM_BATCH_CALL(vec3_dot, (a, b, out, count))
+}
+
+/// out[i] = cross(a[i], b[i]), over count vec3 stored as x y z
+GLM_FUNC_QUALIFIER void glm_batch_vec3_cross(float const* a, float const* b, float* out, std::size_t count)
+{
+	GLM_BATCH_CALL(vec3_cross, (a, b, out, count))
+}
+
+/// out[i] = normalize(in[i]), over count vec3 stored as x y z
+GLM_FUNC_QUALIFIER void glm_batch_vec3_normalize(float const* in, float* out, std::size_t count)
+{
+	GLM_BATCH_CALL(vec3_normalize, (in, out, count))
+}
+
+/// As glm_batch_mat4_mul_vec4, with one array per component
+GLM_FUNC_QUALIFIER void glm_batch_mat4_mul_vec4_soa(float const m[16], float const* const in[4], float* const out[4], std::size_t count)
+{
+	GLM_BATCH_CALL(mat4_mul_vec4_soa, (m, in, out, count))
+}
+
+/// As glm_batch_vec3_dot, with one array per component
+GLM_FUNC_QUALIFIER void glm_batch_vec3_dot_soa(float const* const a[3], float const* const b[3], float* out, std::size_t count)
+{
+	GLM_BATCH_CALL(vec3_dot_soa, (a, b, out, count))
+}
+
+/// As glm_batch_vec3_cross, with one array per component
+GLM_FUNC_QUALIFIER void glm_batch_vec3_cross_soa(float const* const a[3], float const* const b[3], float* const out[3], std::size_t count)
+{
+	GLM_BATCH_CALL(vec3_cross_soa, (a, b, out, count))
+}
+
+/// As glm_batch_vec3_normalize, with one array per component
+GLM_FUNC_QUALIFIER void glm_batch_vec3_normalize_soa(float const* const in[3], float* const out[3], std::size_t count)
+{
+	GLM_BATCH_CALL(vec3_normalize_soa, (in, out, count))
+}
+
+#undef GLM_BATCH_CALL
+#undef GLM_BATCH_ROUNDED
@@ -63,7 +63,7 @@ GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_swizzle_xyzw(glm_f32vec4 a)
 
 GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec1_fma(glm_f32vec4 a, glm_f32vec4 b, glm_f32vec4 c)
 {
-#	if (GLM_ARCH & GLM_ARCH_AVX2_BIT) && !(GLM_COMPILER & GLM_COMPILER_CLANG)
+#	if GLM_HAS_FMA
 		return _mm_fmadd_ss(a, b, c);
 #	else
 		return _mm_add_ss(_mm_mul_ss(a, b), c);
@@ -72,7 +72,7 @@ GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec1_fma(glm_f32vec4 a, glm_f32vec4 b, glm_f3
 
 GLM_FUNC_QUALIFIER glm_f32vec4 glm_vec4_fma(glm_f32vec4 a, glm_f32vec4 b, glm_f32vec4 c)
 {
-#	if (GLM_ARCH & GLM_ARCH_AVX2_BIT) && !(GLM_COMPILER & GLM_COMPILER_CLANG)
+#	if GLM_HAS_FMA
 		return _mm_fmadd_ps(a, b, c);
 #	else
 		return glm_vec4_add(glm_vec4_mul(a, b), c);
@@ -237,4 +237,62 @@ GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_inf(glm_vec4 x)
 	return _mm_castsi128_ps(_mm_cmpeq_epi32(t2, _mm_set1_epi32(int(0xFF000000))));		// exponent is all 1s, fraction is 0
 }
 
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_splat_x(glm_dvec4 v)
+{
+	glm_dvec4 const lo = _mm256_permute2f128_pd(v, v, 0x00);
+	return _mm256_permute_pd(lo, 0x0);
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_splat_y(glm_dvec4 v)
+{
+	glm_dvec4 const lo = _mm256_permute2f128_pd(v, v, 0x00);
+	return _mm256_permute_pd(lo, 0xF);
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_splat_z(glm_dvec4 v)
+{
+	glm_dvec4 const hi = _mm256_permute2f128_pd(v, v, 0x11);
+	return _mm256_permute_pd(hi, 0x0);
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_splat_w(glm_dvec4 v)
+{
+	glm_dvec4 const hi = _mm256_permute2f128_pd(v, v, 0x11);
+	return _mm256_permute_pd(hi, 0xF);
+}
+
+// a * b + c
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_fma(glm_dvec4 a, glm_dvec4 b, glm_dvec4 c)
+{
+#	if GLM_HAS_FMA
+		return _mm256_fmadd_pd(a, b, c);
+#	else
+		return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#	endif
+}
+
+// a * b - c
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_fms(glm_dvec4 a, glm_dvec4 b, glm_dvec4 c)
+{
+#	if GLM_HAS_FMA
+		return _mm256_fmsub_pd(a, b, c);
+#	else
+		return _mm256_sub_pd(_mm256_mul_pd(a, b), c);
+#	endif
+}
+
+// c - a * b
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_fnma(glm_dvec4 a, glm_dvec4 b, glm_dvec4 c)
+{
+#	if GLM_HAS_FMA
+		return _mm256_fnmadd_pd(a, b, c);
+#	else
+		return _mm256_sub_pd(c, _mm256_mul_pd(a, b));
+#	endif
+}
+
+#endif//GLM_ARCH & GLM_ARCH_AVX_BIT
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -82,6 +82,52 @@ GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_normalize(glm_vec4 v)
 	return mul0;
 }
 
+// The vec3 functions ignore the fourth lane of their arguments
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec3_dot(glm_vec4 v1, glm_vec4 v2)
+{
+#	if GLM_ARCH & GLM_ARCH_SSE41_BIT
+		return _mm_dp_ps(v1, v2, 0x7f);
+#	else
+		glm_vec4 const mul0 = _mm_mul_ps(v1, v2);
+		glm_vec4 const swp0 = _mm_shuffle_ps(mul0, mul0, _MM_SHUFFLE(1, 1, 1, 1));
+		glm_vec4 const swp1 = _mm_shuffle_ps(mul0, mul0, _MM_SHUFFLE(2, 2, 2, 2));
+		glm_vec4 const add0 = _mm_add_ss(mul0, swp0);
+		glm_vec4 const add1 = _mm_add_ss(add0, swp1);
+		return _mm_shuffle_ps(add1, add1, _MM_SHUFFLE(0, 0, 0, 0));
+#	endif
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec3_length(glm_vec4 x)
+{
+	glm_vec4 const dot0 = glm_vec3_dot(x, x);
+	glm_vec4 const sqt0 = _mm_sqrt_ps(dot0);
+	return sqt0;
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec3_distance(glm_vec4 p0, glm_vec4 p1)
+{
+	glm_vec4 const sub0 = _mm_sub_ps(p0, p1);
+	glm_vec4 const len0 = glm_vec3_length(sub0);
+	return len0;
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec3_normalize(glm_vec4 v)
+{
+	glm_vec4 const dot0 = glm_vec3_dot(v, v);
+	glm_vec4 const sqt0 = _mm_sqrt_ps(dot0);
+	glm_vec4 const div0 = _mm_div_ps(v, sqt0);
+	return div0;
+}
+
+// About 12 bits of precision
+GLM_FUNC_QUALIFIER glm_vec4 glm_vec3_normalize_lowp(glm_vec4 v)
+{
+	glm_vec4 const dot0 = glm_vec3_dot(v, v);
+	glm_vec4 const isr0 = _mm_rsqrt_ps(dot0);
+	glm_vec4 const mul0 = _mm_mul_ps(v, isr0);
+	return mul0;
+}
+
 GLM_FUNC_QUALIFIER glm_vec4 glm_vec4_faceforward(glm_vec4 N, glm_vec4 I, glm_vec4 Nref)
 {
 	glm_vec4 const dot0 = glm_vec4_dot(Nref, I);
@@ -121,4 +167,92 @@ GLM_FUNC_QUALIFIER __m128 glm_vec4_refract(glm_vec4 I, glm_vec4 N, glm_vec4 eta)
 	return sub2;
 }
 
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+
+// Same summation order as the scalar code: (x + y) + (z + w)
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_dot(glm_dvec4 v1, glm_dvec4 v2)
+{
+	glm_dvec4 const mul0 = _mm256_mul_pd(v1, v2);
+	glm_dvec4 const had0 = _mm256_hadd_pd(mul0, mul0);
+	glm_dvec4 const swp0 = _mm256_permute2f128_pd(had0, had0, 0x01);
+	return _mm256_add_pd(had0, swp0);
+}
+
+// (x + y) + z, the fourth lane is ignored
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec3_dot(glm_dvec4 v1, glm_dvec4 v2)
+{
+	glm_dvec4 const mul0 = _mm256_mul_pd(v1, v2);
+	glm_dvec4 const msk0 = _mm256_blend_pd(mul0, _mm256_setzero_pd(), 0x8);
+	glm_dvec4 const had0 = _mm256_hadd_pd(msk0, msk0);
+	glm_dvec4 const swp0 = _mm256_permute2f128_pd(had0, had0, 0x01);
+	return _mm256_add_pd(had0, swp0);
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_length(glm_dvec4 x)
+{
+	glm_dvec4 const dot0 = glm_dvec4_dot(x, x);
+	glm_dvec4 const sqt0 = _mm256_sqrt_pd(dot0);
+	return sqt0;
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_distance(glm_dvec4 p0, glm_dvec4 p1)
+{
+	glm_dvec4 const sub0 = _mm256_sub_pd(p0, p1);
+	glm_dvec4 const len0 = glm_dvec4_length(sub0);
+	return len0;
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec4_normalize(glm_dvec4 v)
+{
+	glm_dvec4 const dot0 = glm_dvec4_dot(v, v);
+	glm_dvec4 const isr0 = _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(dot0));
+	glm_dvec4 const mul0 = _mm256_mul_pd(v, isr0);
+	return mul0;
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec3_length(glm_dvec4 x)
+{
+	glm_dvec4 const dot0 = glm_dvec3_dot(x, x);
+	glm_dvec4 const sqt0 = _mm256_sqrt_pd(dot0);
+	return sqt0;
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec3_distance(glm_dvec4 p0, glm_dvec4 p1)
+{
+	glm_dvec4 const sub0 = _mm256_sub_pd(p0, p1);
+	glm_dvec4 const len0 = glm_dvec3_length(sub0);
+	return len0;
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec3_normalize(glm_dvec4 v)
+{
+	glm_dvec4 const dot0 = glm_dvec3_dot(v, v);
+	glm_dvec4 const isr0 = _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(dot0));
+	glm_dvec4 const mul0 = _mm256_mul_pd(v, isr0);
+	return mul0;
+}
+
+// v1.yzx * v2.zxy - v1.zxy * v2.yzx, the fourth lane is left undefined
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dvec3_cross(glm_dvec4 v1, glm_dvec4 v2)
+{
+#	if GLM_ARCH & GLM_ARCH_AVX2_BIT
+		glm_dvec4 const yzx1 = _mm256_permute4x64_pd(v1, _MM_SHUFFLE(3, 0, 2, 1));
+		glm_dvec4 const zxy1 = _mm256_permute4x64_pd(v1, _MM_SHUFFLE(3, 1, 0, 2));
+		glm_dvec4 const yzx2 = _mm256_permute4x64_pd(v2, _MM_SHUFFLE(3, 0, 2, 1));
+		glm_dvec4 const zxy2 = _mm256_permute4x64_pd(v2, _MM_SHUFFLE(3, 1, 0, 2));
+#	else
+		// (z, w, x, y) then in-lane picks
+		glm_dvec4 const swp1 = _mm256_permute2f128_pd(v1, v1, 0x01);
+		glm_dvec4 const swp2 = _mm256_permute2f128_pd(v2, v2, 0x01);
+		glm_dvec4 const yzx1 = _mm256_blend_pd(_mm256_shuffle_pd(v1, swp1, 0x5), swp1, 0x4);
+		glm_dvec4 const zxy1 = _mm256_shuffle_pd(swp1, v1, 0x4);
+		glm_dvec4 const yzx2 = _mm256_blend_pd(_mm256_shuffle_pd(v2, swp2, 0x5), swp2, 0x4);
+		glm_dvec4 const zxy2 = _mm256_shuffle_pd(swp2, v2, 0x4);
+#	endif
+	glm_dvec4 const mul0 = _mm256_mul_pd(zxy1, yzx2);
+	return glm_dvec4_fms(yzx1, zxy2, mul0);
+}
+
+#endif//GLM_ARCH & GLM_ARCH_AVX_BIT
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
@@ -1025,4 +1025,291 @@ GLM_FUNC_QUALIFIER void glm_mat4_outerProduct(__m128 const& c, __m128 const& r,
 	out[3] = _mm_mul_ps(c, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
 }
 
+GLM_FUNC_QUALIFIER void glm_mat4_affine_inverse(glm_vec4 const in[4], glm_vec4 out[4])
+{
+	// The rows of the inverse of the upper 3x3 are cross products of its columns
+	__m128 r0 = glm_vec4_cross(in[1], in[2]);
+	__m128 r1 = glm_vec4_cross(in[2], in[0]);
+	__m128 r2 = glm_vec4_cross(in[0], in[1]);
+
+	__m128 det = glm_vec4_dot(in[0], r0);
+	__m128 rcp = _mm_div_ps(_mm_set1_ps(1.0f), det);
+	r0 = _mm_mul_ps(r0, rcp);
+	r1 = _mm_mul_ps(r1, rcp);
+	r2 = _mm_mul_ps(r2, rcp);
+
+	__m128 tmp0 = _mm_unpacklo_ps(r0, r1);
+	__m128 tmp1 = _mm_unpackhi_ps(r0, r1);
+	__m128 tmp2 = _mm_unpacklo_ps(r2, _mm_setzero_ps());
+	__m128 tmp3 = _mm_unpackhi_ps(r2, _mm_setzero_ps());
+
+	__m128 c0 = _mm_movelh_ps(tmp0, tmp2);
+	__m128 c1 = _mm_movehl_ps(tmp2, tmp0);
+	__m128 c2 = _mm_movelh_ps(tmp1, tmp3);
+
+	__m128 t0 = _mm_shuffle_ps(in[3], in[3], _MM_SHUFFLE(0, 0, 0, 0));
+	__m128 t1 = _mm_shuffle_ps(in[3], in[3], _MM_SHUFFLE(1, 1, 1, 1));
+	__m128 t2 = _mm_shuffle_ps(in[3], in[3], _MM_SHUFFLE(2, 2, 2, 2));
+	__m128 a0 = glm_vec4_fma(c1, t1, _mm_mul_ps(c0, t0));
+	__m128 a1 = glm_vec4_fma(c2, t2, a0);
+
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = _mm_sub_ps(_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f), a1);
+}
+
+#if GLM_ARCH & GLM_ARCH_AVX_BIT
+
+// The AVX functions hold two columns per 256-bit register. Matrix columns
+// are only 16-byte aligned so loads and stores are unaligned.
+
+GLM_FUNC_QUALIFIER __m256 glm_vec4x2_fma(__m256 a, __m256 b, __m256 c)
+{
+#	if GLM_HAS_FMA
+		return _mm256_fmadd_ps(a, b, c);
+#	else
+		return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#	endif
+}
+
+GLM_FUNC_QUALIFIER __m256 glm_vec4x2_fms(__m256 a, __m256 b, __m256 c)
+{
+#	if GLM_HAS_FMA
+		return _mm256_fmsub_ps(a, b, c);
+#	else
+		return _mm256_sub_ps(_mm256_mul_ps(a, b), c);
+#	endif
+}
+
+GLM_FUNC_QUALIFIER __m256 glm_mat4_mul_vec4x2(__m256 const m[4], __m256 v)
+{
+	__m256 e0 = _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0));
+	__m256 e1 = _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1));
+	__m256 e2 = _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2));
+	__m256 e3 = _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3));
+
+	__m256 a0 = glm_vec4x2_fma(m[1], e1, _mm256_mul_ps(m[0], e0));
+	__m256 a1 = glm_vec4x2_fma(m[3], e3, _mm256_mul_ps(m[2], e2));
+
+	return _mm256_add_ps(a0, a1);
+}
+
+GLM_FUNC_QUALIFIER void glm_mat4_mul_avx(glm_vec4 const in1[4], glm_vec4 const in2[4], glm_vec4 out[4])
+{
+	__m256 m[4];
+	m[0] = _mm256_broadcast_ps(&in1[0]);
+	m[1] = _mm256_broadcast_ps(&in1[1]);
+	m[2] = _mm256_broadcast_ps(&in1[2]);
+	m[3] = _mm256_broadcast_ps(&in1[3]);
+
+	__m256 v01 = _mm256_loadu_ps(reinterpret_cast<float const*>(&in2[0]));
+	__m256 v23 = _mm256_loadu_ps(reinterpret_cast<float const*>(&in2[2]));
+
+	_mm256_storeu_ps(reinterpret_cast<float*>(&out[0]), glm_mat4_mul_vec4x2(m, v01));
+	_mm256_storeu_ps(reinterpret_cast<float*>(&out[2]), glm_mat4_mul_vec4x2(m, v23));
+}
+
+GLM_FUNC_QUALIFIER glm_vec4 glm_mat4_mul_vec4_avx(glm_vec4 const m[4], glm_vec4 v)
+{
+	__m256 m01 = _mm256_loadu_ps(reinterpret_cast<float const*>(&m[0]));
+	__m256 m23 = _mm256_loadu_ps(reinterpret_cast<float const*>(&m[2]));
+
+	__m256 vv = _mm256_insertf128_ps(_mm256_castps128_ps256(v), v, 1);
+	__m256 e01 = _mm256_permutevar_ps(vv, _mm256_setr_epi32(0, 0, 0, 0, 1, 1, 1, 1));
+	__m256 e23 = _mm256_permutevar_ps(vv, _mm256_setr_epi32(2, 2, 2, 2, 3, 3, 3, 3));
+
+	__m256 a0 = glm_vec4x2_fma(m23, e23, _mm256_mul_ps(m01, e01));
+
+	return _mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1));
+}
+
+// Blockwise inversion: M = (A B, C D) with each 2x2 block stored in a vec4,
+// working on two blocks at once
+GLM_FUNC_QUALIFIER void glm_mat4_inverse_avx(glm_vec4 const in[4], glm_vec4 out[4])
+{
+	__m128 a = _mm_movelh_ps(in[0], in[1]);
+	__m128 b = _mm_movehl_ps(in[1], in[0]);
+	__m128 c = _mm_movelh_ps(in[2], in[3]);
+	__m128 d = _mm_movehl_ps(in[3], in[2]);
+
+	// (|A|, |B|, |C|, |D|)
+	__m128 det0 = _mm_mul_ps(_mm_shuffle_ps(in[0], in[2], _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(in[1], in[3], _MM_SHUFFLE(3, 1, 3, 1)));
+	__m128 det1 = _mm_mul_ps(_mm_shuffle_ps(in[0], in[2], _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(in[1], in[3], _MM_SHUFFLE(2, 0, 2, 0)));
+	__m128 det = _mm_sub_ps(det0, det1);
+	__m256 det2 = _mm256_insertf128_ps(_mm256_castps128_ps256(det), det, 1);
+
+	__m256 ad = _mm256_insertf128_ps(_mm256_castps128_ps256(a), d, 1);
+	__m256 bc = _mm256_insertf128_ps(_mm256_castps128_ps256(b), c, 1);
+	__m256 da = _mm256_permute2f128_ps(ad, ad, 0x01);
+	__m256 cb = _mm256_permute2f128_ps(bc, bc, 0x01);
+
+	// (adj(A) B, adj(D) C) and swapped
+	__m256 ab_dc = _mm256_sub_ps(
+		_mm256_mul_ps(_mm256_permute_ps(ad, _MM_SHUFFLE(0, 0, 3, 3)), bc),
+		_mm256_mul_ps(_mm256_permute_ps(ad, _MM_SHUFFLE(2, 2, 1, 1)), _mm256_permute_ps(bc, _MM_SHUFFLE(1, 0, 3, 2))));
+	__m256 dc_ab = _mm256_permute2f128_ps(ab_dc, ab_dc, 0x01);
+
+	// (|D| A - B adj(D) C, |A| D - C adj(A) B)
+	__m256 xw = glm_vec4x2_fma(
+		_mm256_permute_ps(bc, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute_ps(dc_ab, _MM_SHUFFLE(1, 2, 1, 2)),
+		_mm256_mul_ps(bc, _mm256_permute_ps(dc_ab, _MM_SHUFFLE(3, 0, 3, 0))));
+	xw = glm_vec4x2_fms(_mm256_permutevar_ps(det2, _mm256_setr_epi32(3, 3, 3, 3, 0, 0, 0, 0)), ad, xw);
+
+	// (|B| C - D adj(adj(A) B), |C| B - A adj(adj(D) C))
+	__m256 yz = glm_vec4x2_fms(
+		da, _mm256_permute_ps(ab_dc, _MM_SHUFFLE(0, 3, 0, 3)),
+		_mm256_mul_ps(_mm256_permute_ps(da, _MM_SHUFFLE(2, 3, 0, 1)), _mm256_permute_ps(ab_dc, _MM_SHUFFLE(1, 2, 1, 2))));
+	yz = glm_vec4x2_fms(_mm256_permutevar_ps(det2, _mm256_setr_epi32(1, 1, 1, 1, 2, 2, 2, 2)), cb, yz);
+
+	// |M| = |A| |D| + |B| |C| - tr(adj(A) B adj(D) C)
+	__m128 det3 = _mm_mul_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(0, 1, 2, 3)));
+	det3 = _mm_hadd_ps(det3, det3);
+	__m256 tr0 = _mm256_mul_ps(ab_dc, _mm256_permute_ps(dc_ab, _MM_SHUFFLE(3, 1, 2, 0)));
+	__m128 tr1 = _mm256_castps256_ps128(tr0);
+	tr1 = _mm_hadd_ps(tr1, tr1);
+	tr1 = _mm_hadd_ps(tr1, tr1);
+	__m128 det4 = _mm_sub_ps(det3, tr1);
+
+	__m256 rcp = _mm256_div_ps(_mm256_setr_ps(1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f), _mm256_insertf128_ps(_mm256_castps128_ps256(det4), det4, 1));
+	xw = _mm256_mul_ps(xw, rcp);
+	yz = _mm256_mul_ps(yz, rcp);
+
+	// Adjugate of each block, then back to columns
+	__m256 xz = _mm256_blend_ps(xw, yz, 0xF0);
+	__m256 yw = _mm256_blend_ps(yz, xw, 0xF0);
+	__m256 r02 = _mm256_shuffle_ps(xz, yw, _MM_SHUFFLE(1, 3, 1, 3));
+	__m256 r13 = _mm256_shuffle_ps(xz, yw, _MM_SHUFFLE(0, 2, 0, 2));
+
+	_mm256_storeu_ps(reinterpret_cast<float*>(&out[0]), _mm256_permute2f128_ps(r02, r13, 0x20));
+	_mm256_storeu_ps(reinterpret_cast<float*>(&out[2]), _mm256_permute2f128_ps(r02, r13, 0x31));
+}
+
+// The double precision functions hold one column per 256-bit register
+
+GLM_FUNC_QUALIFIER void glm_dmat4_transpose(glm_dvec4 const in[4], glm_dvec4 out[4])
+{
+	glm_dvec4 const tmp0 = _mm256_unpacklo_pd(in[0], in[1]);
+	glm_dvec4 const tmp1 = _mm256_unpackhi_pd(in[0], in[1]);
+	glm_dvec4 const tmp2 = _mm256_unpacklo_pd(in[2], in[3]);
+	glm_dvec4 const tmp3 = _mm256_unpackhi_pd(in[2], in[3]);
+
+	out[0] = _mm256_permute2f128_pd(tmp0, tmp2, 0x20);
+	out[1] = _mm256_permute2f128_pd(tmp1, tmp3, 0x20);
+	out[2] = _mm256_permute2f128_pd(tmp0, tmp2, 0x31);
+	out[3] = _mm256_permute2f128_pd(tmp1, tmp3, 0x31);
+}
+
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dmat4_mul_dvec4(glm_dvec4 const m[4], glm_dvec4 v)
+{
+	glm_dvec4 const mul0 = _mm256_mul_pd(m[0], glm_dvec4_splat_x(v));
+	glm_dvec4 const add0 = glm_dvec4_fma(m[1], glm_dvec4_splat_y(v), mul0);
+	glm_dvec4 const mul1 = _mm256_mul_pd(m[2], glm_dvec4_splat_z(v));
+	glm_dvec4 const add1 = glm_dvec4_fma(m[3], glm_dvec4_splat_w(v), mul1);
+	return _mm256_add_pd(add0, add1);
+}
+
+GLM_FUNC_QUALIFIER void glm_dmat4_mul(glm_dvec4 const in1[4], glm_dvec4 const in2[4], glm_dvec4 out[4])
+{
+	out[0] = glm_dmat4_mul_dvec4(in1, in2[0]);
+	out[1] = glm_dmat4_mul_dvec4(in1, in2[1]);
+	out[2] = glm_dmat4_mul_dvec4(in1, in2[2]);
+	out[3] = glm_dmat4_mul_dvec4(in1, in2[3]);
+}
+
+#if GLM_ARCH & GLM_ARCH_AVX2_BIT
+
+GLM_FUNC_QUALIFIER void glm_mat4_transpose_avx2(glm_vec4 const in[4], glm_vec4 out[4])
+{
+	__m256 a = _mm256_insertf128_ps(_mm256_castps128_ps256(in[0]), in[2], 1);
+	__m256 b = _mm256_insertf128_ps(_mm256_castps128_ps256(in[1]), in[3], 1);
+
+	// (x0 x1 y0 y1 | x2 x3 y2 y3) and (z0 z1 w0 w1 | z2 z3 w2 w3)
+	__m256d xy = _mm256_castps_pd(_mm256_unpacklo_ps(a, b));
+	__m256d zw = _mm256_castps_pd(_mm256_unpackhi_ps(a, b));
+
+	_mm256_storeu_ps(reinterpret_cast<float*>(&out[0]), _mm256_castpd_ps(_mm256_permute4x64_pd(xy, _MM_SHUFFLE(3, 1, 2, 0))));
+	_mm256_storeu_ps(reinterpret_cast<float*>(&out[2]), _mm256_castpd_ps(_mm256_permute4x64_pd(zw, _MM_SHUFFLE(3, 1, 2, 0))));
+}
+
+// Same cofactor expansion as the scalar code, the 2x2 minors of the last two
+// columns are F(i, j) = m[2][i] * m[3][j] - m[3][i] * m[2][j]
+GLM_FUNC_QUALIFIER glm_dvec4 glm_dmat4_determinant(glm_dvec4 const m[4])
+{
+	glm_dvec4 const m2a = _mm256_permute4x64_pd(m[2], _MM_SHUFFLE(1, 1, 2, 2));
+	glm_dvec4 const m2b = _mm256_permute4x64_pd(m[2], _MM_SHUFFLE(2, 3, 3, 3));
+	glm_dvec4 const m2c = _mm256_permute4x64_pd(m[2], _MM_SHUFFLE(0, 0, 0, 1));
+	glm_dvec4 const m3a = _mm256_permute4x64_pd(m[3], _MM_SHUFFLE(1, 1, 2, 2));
+	glm_dvec4 const m3b = _mm256_permute4x64_pd(m[3], _MM_SHUFFLE(2, 3, 3, 3));
+	glm_dvec4 const m3c = _mm256_permute4x64_pd(m[3], _MM_SHUFFLE(0, 0, 0, 1));
+
+	// (F23, F23, F13, F12), (F13, F03, F03, F02) and (F12, F02, F01, F01)
+	glm_dvec4 const fac0 = glm_dvec4_fms(m2a, m3b, _mm256_mul_pd(m3a, m2b));
+	glm_dvec4 const fac1 = glm_dvec4_fms(m2c, m3b, _mm256_mul_pd(m3c, m2b));
+	glm_dvec4 const fac2 = glm_dvec4_fms(m2c, m3a, _mm256_mul_pd(m3c, m2a));
+
+	glm_dvec4 const m1a = _mm256_permute4x64_pd(m[1], _MM_SHUFFLE(1, 1, 2, 2));
+	glm_dvec4 const m1b = _mm256_permute4x64_pd(m[1], _MM_SHUFFLE(2, 3, 3, 3));
+	glm_dvec4 const m1c = _mm256_permute4x64_pd(m[1], _MM_SHUFFLE(0, 0, 0, 1));
+
+	glm_dvec4 const sub0 = glm_dvec4_fnma(m1a, fac1, _mm256_mul_pd(m1c, fac0));
+	glm_dvec4 const add0 = glm_dvec4_fma(m1b, fac2, sub0);
+	glm_dvec4 const cof0 = _mm256_mul_pd(add0, _mm256_setr_pd(1.0, -1.0, 1.0, -1.0));
+
+	return glm_dvec4_dot(m[0], cof0);
+}
+
+// Same cofactors as the scalar code, gathered from the rows of the matrix
+GLM_FUNC_QUALIFIER void glm_dmat4_inverse(glm_dvec4 const in[4], glm_dvec4 out[4])
+{
+	glm_dvec4 r[4];
+	glm_dmat4_transpose(in, r);
+
+	// (m[2][i], m[2][i], m[1][i], m[1][i])
+	glm_dvec4 const a0 = _mm256_permute4x64_pd(r[0], _MM_SHUFFLE(1, 1, 2, 2));
+	glm_dvec4 const a1 = _mm256_permute4x64_pd(r[1], _MM_SHUFFLE(1, 1, 2, 2));
+	glm_dvec4 const a2 = _mm256_permute4x64_pd(r[2], _MM_SHUFFLE(1, 1, 2, 2));
+	glm_dvec4 const a3 = _mm256_permute4x64_pd(r[3], _MM_SHUFFLE(1, 1, 2, 2));
+
+	// (m[3][i], m[3][i], m[3][i], m[2][i])
+	glm_dvec4 const b0 = _mm256_permute4x64_pd(r[0], _MM_SHUFFLE(2, 3, 3, 3));
+	glm_dvec4 const b1 = _mm256_permute4x64_pd(r[1], _MM_SHUFFLE(2, 3, 3, 3));
+	glm_dvec4 const b2 = _mm256_permute4x64_pd(r[2], _MM_SHUFFLE(2, 3, 3, 3));
+	glm_dvec4 const b3 = _mm256_permute4x64_pd(r[3], _MM_SHUFFLE(2, 3, 3, 3));
+
+	// (m[1][i], m[0][i], m[0][i], m[0][i])
+	glm_dvec4 const v0 = _mm256_permute4x64_pd(r[0], _MM_SHUFFLE(0, 0, 0, 1));
+	glm_dvec4 const v1 = _mm256_permute4x64_pd(r[1], _MM_SHUFFLE(0, 0, 0, 1));
+	glm_dvec4 const v2 = _mm256_permute4x64_pd(r[2], _MM_SHUFFLE(0, 0, 0, 1));
+	glm_dvec4 const v3 = _mm256_permute4x64_pd(r[3], _MM_SHUFFLE(0, 0, 0, 1));
+
+	glm_dvec4 const fac0 = glm_dvec4_fms(a2, b3, _mm256_mul_pd(b2, a3));
+	glm_dvec4 const fac1 = glm_dvec4_fms(a1, b3, _mm256_mul_pd(b1, a3));
+	glm_dvec4 const fac2 = glm_dvec4_fms(a1, b2, _mm256_mul_pd(b1, a2));
+	glm_dvec4 const fac3 = glm_dvec4_fms(a0, b3, _mm256_mul_pd(b0, a3));
+	glm_dvec4 const fac4 = glm_dvec4_fms(a0, b2, _mm256_mul_pd(b0, a2));
+	glm_dvec4 const fac5 = glm_dvec4_fms(a0, b1, _mm256_mul_pd(b0, a1));
+
+	glm_dvec4 const signA = _mm256_setr_pd( 1.0,-1.0, 1.0,-1.0);
+	glm_dvec4 const signB = _mm256_setr_pd(-1.0, 1.0,-1.0, 1.0);
+
+	glm_dvec4 const inv0 = _mm256_mul_pd(signA, glm_dvec4_fma(v3, fac2, glm_dvec4_fnma(v2, fac1, _mm256_mul_pd(v1, fac0))));
+	glm_dvec4 const inv1 = _mm256_mul_pd(signB, glm_dvec4_fma(v3, fac4, glm_dvec4_fnma(v2, fac3, _mm256_mul_pd(v0, fac0))));
+	glm_dvec4 const inv2 = _mm256_mul_pd(signA, glm_dvec4_fma(v3, fac5, glm_dvec4_fnma(v1, fac3, _mm256_mul_pd(v0, fac1))));
+	glm_dvec4 const inv3 = _mm256_mul_pd(signB, glm_dvec4_fma(v2, fac5, glm_dvec4_fnma(v1, fac4, _mm256_mul_pd(v0, fac2))));
+
+	// (inv0[0], inv1[0], inv2[0], inv3[0])
+	glm_dvec4 const row0 = _mm256_permute2f128_pd(_mm256_unpacklo_pd(inv0, inv1), _mm256_unpacklo_pd(inv2, inv3), 0x20);
+	glm_dvec4 const det0 = glm_dvec4_dot(in[0], row0);
+	glm_dvec4 const rcp0 = _mm256_div_pd(_mm256_set1_pd(1.0), det0);
+
+	out[0] = _mm256_mul_pd(inv0, rcp0);
+	out[1] = _mm256_mul_pd(inv1, rcp0);
+	out[2] = _mm256_mul_pd(inv2, rcp0);
+	out[3] = _mm256_mul_pd(inv3, rcp0);
+}
+
+#endif//GLM_ARCH & GLM_ARCH_AVX2_BIT
+#endif//GLM_ARCH & GLM_ARCH_AVX_BIT
+
 #endif//GLM_ARCH & GLM_ARCH_SSE2_BIT
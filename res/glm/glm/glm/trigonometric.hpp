@@ -20,6 +20,10 @@
 
 #include "detail/setup.hpp"
 #include "detail/qualifier.hpp"
+#include "detail/type_vec1.hpp"
+#include "detail/type_vec2.hpp"
+#include "detail/type_vec3.hpp"
+#include "detail/type_vec4.hpp"
 
 namespace glm
 {
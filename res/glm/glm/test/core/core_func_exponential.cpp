@@ -1,3 +1,6 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
 #include <glm/gtc/constants.hpp>
 #include <glm/ext/scalar_relational.hpp>
 #include <glm/ext/vector_relational.hpp>
@@ -7,6 +10,12 @@
 #include <glm/ext/vector_float4.hpp>
 #include <glm/common.hpp>
 #include <glm/exponential.hpp>
+#include <glm/ext/scalar_ulp.hpp>
+#include <cmath>
+#include <limits>
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#	include <glm/gtc/type_aligned.hpp>
+#endif
 
 static int test_pow()
 {
@@ -168,6 +177,114 @@ static int test_inversesqrt()
 	return Error;
 }
 
+// Against the C library in double precision, rounded to float, for the SIMD
+// paths the aligned types take when there are some
+static float sample(int i, int Count, float Min, float Max)
+{
+	return Min + (Max - Min) * static_cast<float>(i) / static_cast<float>(Count - 1);
+}
+
+template<typename vecType>
+static int test_exp_log_ulp()
+{
+	int Error = 0;
+
+	int const Count = 1 << 16;
+	for(int i = 0; i < Count; i += 4)
+	{
+		vecType x, m;
+		for(int c = 0; c < 4; ++c)
+		{
+			x[c] = sample(i + c, Count, -103.0f, 88.0f);
+			m[c] = std::pow(2.0f, sample(i + c, Count, -140.0f, 127.0f));
+		}
+
+		vecType const e = glm::exp(x);
+		vecType const l = glm::log(m);
+		for(int c = 0; c < 4; ++c)
+		{
+			Error += glm::floatDistance(e[c], static_cast<float>(std::exp(static_cast<double>(x[c])))) <= 2 ? 0 : 1;
+			Error += glm::floatDistance(l[c], static_cast<float>(std::log(static_cast<double>(m[c])))) <= 2 ? 0 : 1;
+		}
+	}
+
+	float const Inf = std::numeric_limits<float>::infinity();
+	vecType const e = glm::exp(vecType(Inf, -Inf, 89.0f, -104.0f));
+	Error += glm::all(glm::equal(e, vecType(Inf, 0.0f, Inf, 0.0f))) ? 0 : 1;
+	vecType const l = glm::log(vecType(0.0f, Inf, 1.0f, -1.0f));
+	Error += glm::all(glm::equal(glm::vec3(l), glm::vec3(-Inf, Inf, 0.0f))) && glm::isnan(l.w) ? 0 : 1;
+
+	return Error;
+}
+
+template<typename vecType>
+static int test_pow_ulp()
+{
+	int Error = 0;
+
+	int const Count = 1 << 8;
+	for(int i = 0; i < Count; ++i)
+	for(int j = 0; j < Count; j += 4)
+	{
+		float const Base = std::pow(2.0f, sample(i, Count, -8.0f, 8.0f));
+		vecType const x(Base, -Base, Base, -Base);
+		vecType y;
+		for(int c = 0; c < 4; ++c)
+			y[c] = c < 2 ? sample(j + c, Count, -10.0f, 10.0f) : std::floor(sample(j + c, Count, -10.0f, 10.0f));
+
+		vecType const p = glm::pow(x, y);
+		for(int c = 0; c < 4; ++c)
+		{
+			float const Expected = static_cast<float>(std::pow(static_cast<double>(x[c]), static_cast<double>(y[c])));
+			if(glm::isnan(Expected))
+				Error += glm::isnan(p[c]) ? 0 : 1;
+			else
+				Error += glm::floatDistance(p[c], Expected) <= 2 ? 0 : 1;
+		}
+	}
+
+	float const Inf = std::numeric_limits<float>::infinity();
+	vecType const p = glm::pow(vecType(-2.0f, 0.0f, -0.0f, glm::sqrt(-1.0f)), vecType(3.0f, -1.0f, -3.0f, 0.0f));
+	Error += glm::all(glm::equal(p, vecType(-8.0f, Inf, -Inf, 1.0f))) ? 0 : 1;
+
+	return Error;
+}
+
+// The lowp SIMD functions trade accuracy for speed
+static int test_lowp()
+{
+	int Error = 0;
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		int const Count = 1 << 16;
+		for(int i = 0; i < Count; i += 4)
+		{
+			glm::aligned_lowp_vec4 x, m, y;
+			for(int c = 0; c < 4; ++c)
+			{
+				x[c] = sample(i + c, Count, -80.0f, 80.0f);
+				m[c] = std::pow(2.0f, sample(i + c, Count, -120.0f, 120.0f));
+				y[c] = sample(i + c, Count, -4.0f, 4.0f);
+			}
+
+			glm::aligned_lowp_vec4 const e = glm::exp(x);
+			glm::aligned_lowp_vec4 const l = glm::log(m);
+			glm::aligned_lowp_vec4 const p = glm::pow(glm::aligned_lowp_vec4(glm::e<float>(), 0.5f, 3.0f, 100.0f), y);
+			glm::aligned_lowp_vec4 const b(glm::e<float>(), 0.5f, 3.0f, 100.0f);
+			for(int c = 0; c < 4; ++c)
+			{
+				double const ExpectedE = std::exp(static_cast<double>(x[c]));
+				double const ExpectedP = std::pow(static_cast<double>(b[c]), static_cast<double>(y[c]));
+				Error += std::abs(e[c] - ExpectedE) <= 1e-5 * ExpectedE ? 0 : 1;
+				Error += std::abs(l[c] - std::log(static_cast<double>(m[c]))) <= 1e-5 ? 0 : 1;
+				Error += std::abs(p[c] - ExpectedP) <= 1e-4 * ExpectedP ? 0 : 1;
+			}
+		}
+#	endif
+
+	return Error;
+}
+
 int main()
 {
 	int Error = 0;
@@ -179,6 +296,13 @@ int main()
 	Error += test_exp2();
 	Error += test_log2();
 	Error += test_inversesqrt();
+	Error += test_exp_log_ulp<glm::vec4>();
+	Error += test_pow_ulp<glm::vec4>();
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += test_exp_log_ulp<glm::aligned_highp_vec4>();
+		Error += test_pow_ulp<glm::aligned_highp_vec4>();
+#	endif
+	Error += test_lowp();
 
 	return Error;
 }
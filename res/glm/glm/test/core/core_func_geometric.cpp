@@ -1,5 +1,10 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
 #include <glm/geometric.hpp>
 #include <glm/trigonometric.hpp>
+#include <glm/common.hpp>
+#include <glm/ext/scalar_constants.hpp>
 #include <glm/ext/scalar_relational.hpp>
 #include <glm/ext/vector_relational.hpp>
 #include <glm/ext/vector_float1.hpp>
@@ -10,6 +15,9 @@
 #include <glm/ext/vector_double3.hpp>
 #include <glm/ext/vector_double4.hpp>
 #include <limits>
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#	include <glm/gtc/type_aligned.hpp>
+#endif
 
 namespace length
 {
@@ -182,6 +190,93 @@ namespace refract
 	}
 }//namespace refract
 
+// Aligned vec3 and vec4 take the SIMD paths when there are some, they must match packed vectors
+namespace aligned
+{
+	template<typename T, glm::qualifier Q>
+	static int test_vec3()
+	{
+		typedef glm::vec<3, T, Q> vecType;
+		typedef glm::vec<3, T, glm::defaultp> packedType;
+
+		int Error = 0;
+
+		packedType const A(1, -2, 3);
+		packedType const B(-4, 5, 0.5);
+
+		vecType const a(A);
+		vecType const b(B);
+
+		Error += glm::all(glm::equal(packedType(a + b), A + B, glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(a - b), A - B, glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(a * b), A * B, glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(a / b), A / B, glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(a * T(2) + T(1)), A * T(2) + T(1), glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(T(2) / a), T(2) / A, glm::epsilon<T>())) ? 0 : 1;
+
+		vecType c(a);
+		c += b;
+		c *= T(0.5);
+		Error += glm::all(glm::equal(packedType(c), (A + B) * T(0.5), glm::epsilon<T>())) ? 0 : 1;
+
+		Error += glm::equal(glm::dot(a, b), glm::dot(A, B), T(0.0001)) ? 0 : 1;
+		Error += glm::equal(glm::length(a), glm::length(A), T(0.0001)) ? 0 : 1;
+		Error += glm::equal(glm::distance(a, b), glm::distance(A, B), T(0.0001)) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(glm::cross(a, b)), glm::cross(A, B), T(0.0001))) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(glm::normalize(a)), glm::normalize(A), T(0.001))) ? 0 : 1;
+
+		// The padding lane must not leak into the horizontal operations
+		vecType const d = a / vecType(T(0));
+		Error += glm::equal(glm::dot(vecType(1, 2, 3), vecType(1)), T(6), glm::epsilon<T>()) ? 0 : 1;
+		Error += glm::isinf(glm::dot(d, d)) ? 0 : 1;
+
+		return Error;
+	}
+
+	template<typename T, glm::qualifier Q>
+	static int test_vec4()
+	{
+		typedef glm::vec<4, T, Q> vecType;
+		typedef glm::vec<4, T, glm::defaultp> packedType;
+
+		int Error = 0;
+
+		packedType const A(1, -2, 3, 0.5);
+		packedType const B(-4, 5, 0.5, 2);
+
+		vecType const a(A);
+		vecType const b(B);
+
+		Error += glm::all(glm::equal(packedType(a * b + a), A * B + A, glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(a / b - a), A / B - A, glm::epsilon<T>())) ? 0 : 1;
+		Error += glm::equal(glm::dot(a, b), glm::dot(A, B), T(0.0001)) ? 0 : 1;
+		Error += glm::equal(glm::length(a), glm::length(A), T(0.0001)) ? 0 : 1;
+		Error += glm::equal(glm::distance(a, b), glm::distance(A, B), T(0.0001)) ? 0 : 1;
+		Error += glm::all(glm::equal(packedType(glm::normalize(a)), glm::normalize(A), T(0.001))) ? 0 : 1;
+
+		return Error;
+	}
+
+	static int test()
+	{
+		int Error = 0;
+
+#		if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+			Error += test_vec3<float, glm::aligned_highp>();
+			Error += test_vec3<float, glm::aligned_mediump>();
+			Error += test_vec3<float, glm::aligned_lowp>();
+			Error += test_vec3<double, glm::aligned_highp>();
+			Error += test_vec3<double, glm::aligned_mediump>();
+			Error += test_vec3<double, glm::aligned_lowp>();
+			Error += test_vec4<float, glm::aligned_highp>();
+			Error += test_vec4<double, glm::aligned_highp>();
+			Error += test_vec4<double, glm::aligned_lowp>();
+#		endif
+
+		return Error;
+	}
+}//namespace aligned
+
 int main()
 {
 	int Error(0);
@@ -194,6 +289,7 @@ int main()
 	Error += faceforward::test();
 	Error += reflect::test();
 	Error += refract::test();
+	Error += aligned::test();
 
 	return Error;
 }
@@ -1,8 +1,14 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
 #include <glm/matrix.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/ulp.hpp>
 #include <glm/gtc/epsilon.hpp>
 #include <glm/gtc/constants.hpp>
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#	include <glm/gtc/type_aligned.hpp>
+#endif
 #include <vector>
 #include <ctime>
 #include <cstdio>
@@ -257,6 +263,93 @@ int test_inverse_simd()
 	return Error;
 }
 
+// Aligned matrices take the SIMD paths when there are some
+int test_aligned()
+{
+	int Error = 0;
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		glm::mat4 const A = glm::rotate(glm::translate(glm::mat4(1), glm::vec3(1, 2, 3)), 0.5f, glm::vec3(0.6f, 0.8f, 0.0f)) * glm::mat4(
+			2.0f, 0.1f, 0.3f, 0.0f,
+			0.2f, 3.0f, 0.4f, 0.1f,
+			0.5f, 0.6f, 4.0f, 0.2f,
+			0.7f, 0.8f, 0.9f, 1.0f);
+		glm::mat4 const B = glm::perspective(0.8f, 1.5f, 0.1f, 100.0f);
+		glm::vec4 const V(1.0f, -2.0f, 3.0f, 1.0f);
+
+		glm::aligned_mat4 const AlignedA(A);
+		glm::aligned_mat4 const AlignedB(B);
+
+		glm::mat4 const Mul(AlignedA * AlignedB);
+		glm::vec4 const MulVec(AlignedA * glm::aligned_vec4(V));
+		glm::mat4 const Transpose(glm::transpose(AlignedA));
+		glm::mat4 const Inverse(glm::inverse(AlignedA));
+
+		glm::mat4 const ExpectedMul(A * B);
+		glm::mat4 const ExpectedTranspose(glm::transpose(A));
+		glm::mat4 const ExpectedInverse(glm::inverse(A));
+
+		Error += all(epsilonEqual(MulVec, A * V, 0.0001f)) ? 0 : 1;
+		for(glm::length_t l = 0; l < 4; ++l)
+		{
+			Error += all(epsilonEqual(Mul[l], ExpectedMul[l], 0.0001f)) ? 0 : 1;
+			Error += all(epsilonEqual(Transpose[l], ExpectedTranspose[l], epsilon<float>())) ? 0 : 1;
+			Error += all(epsilonEqual(Inverse[l], ExpectedInverse[l], 0.0001f)) ? 0 : 1;
+		}
+
+		glm::aligned_mat4 Product(AlignedA);
+		Product *= glm::inverse(AlignedA);
+		for(glm::length_t l = 0; l < 4; ++l)
+			Error += all(epsilonEqual(glm::vec4(Product[l]), glm::mat4(1)[l], 0.0001f)) ? 0 : 1;
+#	endif
+
+	return Error;
+}
+
+int test_aligned_double()
+{
+	int Error = 0;
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		glm::dmat4 const A = glm::rotate(glm::translate(glm::dmat4(1), glm::dvec3(1, 2, 3)), 0.5, glm::dvec3(0.6, 0.8, 0.0)) * glm::dmat4(
+			2.0, 0.1, 0.3, 0.0,
+			0.2, 3.0, 0.4, 0.1,
+			0.5, 0.6, 4.0, 0.2,
+			0.7, 0.8, 0.9, 1.0);
+		glm::dmat4 const B = glm::perspective(0.8, 1.5, 0.1, 100.0);
+		glm::dvec4 const V(1.0, -2.0, 3.0, 1.0);
+
+		glm::aligned_dmat4 const AlignedA(A);
+		glm::aligned_dmat4 const AlignedB(B);
+
+		glm::dmat4 const Mul(AlignedA * AlignedB);
+		glm::dvec4 const MulVec(AlignedA * glm::aligned_dvec4(V));
+		glm::dmat4 const Transpose(glm::transpose(AlignedA));
+		glm::dmat4 const Inverse(glm::inverse(AlignedA));
+		double const Determinant(glm::determinant(AlignedA));
+
+		glm::dmat4 const ExpectedMul(A * B);
+		glm::dmat4 const ExpectedTranspose(glm::transpose(A));
+		glm::dmat4 const ExpectedInverse(glm::inverse(A));
+
+		Error += all(epsilonEqual(MulVec, A * V, 1e-12)) ? 0 : 1;
+		Error += epsilonEqual(Determinant, glm::determinant(A), 1e-12) ? 0 : 1;
+		for(glm::length_t l = 0; l < 4; ++l)
+		{
+			Error += all(epsilonEqual(Mul[l], ExpectedMul[l], 1e-12)) ? 0 : 1;
+			Error += all(epsilonEqual(Transpose[l], ExpectedTranspose[l], epsilon<double>())) ? 0 : 1;
+			Error += all(epsilonEqual(Inverse[l], ExpectedInverse[l], 1e-12)) ? 0 : 1;
+		}
+
+		glm::aligned_dmat4 Product(AlignedA);
+		Product *= glm::inverse(AlignedA);
+		for(glm::length_t l = 0; l < 4; ++l)
+			Error += all(epsilonEqual(glm::dvec4(Product[l]), glm::dmat4(1)[l], 1e-12)) ? 0 : 1;
+#	endif
+
+	return Error;
+}
+
 template<typename VEC3, typename MAT4>
 int test_inverse_perf(std::size_t Count, std::size_t Instance, char const * Message)
 {
@@ -311,6 +404,8 @@ int main()
 	Error += test_determinant();
 	Error += test_inverse();
 	Error += test_inverse_simd();
+	Error += test_aligned();
+	Error += test_aligned_double();
 
 #	ifdef NDEBUG
 	std::size_t const Samples = 1000;
@@ -1,10 +1,156 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
 #include <glm/trigonometric.hpp>
+#include <glm/common.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/ext/scalar_ulp.hpp>
+#include <glm/ext/scalar_relational.hpp>
+#include <glm/ext/vector_float4.hpp>
+#include <cmath>
+#include <limits>
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#	include <glm/gtc/type_aligned.hpp>
+#endif
+
+// The aligned types take the SIMD paths when there are some, measured
+// against the C library in double precision, rounded to float
+namespace reference
+{
+	static int ulps(float Value, double Expected)
+	{
+		return glm::floatDistance(Value, static_cast<float>(Expected));
+	}
+
+	// Count evenly spaced values in [Min, Max]
+	static float linear(int i, int Count, float Min, float Max)
+	{
+		return Min + (Max - Min) * static_cast<float>(i) / static_cast<float>(Count - 1);
+	}
+
+	// Magnitudes from 2^-30 to 2^30, alternating signs
+	static float logarithmic(int i, int Count)
+	{
+		float const Magnitude = std::pow(2.0f, linear(i, Count, -30.0f, 30.0f));
+		return i & 1 ? -Magnitude : Magnitude;
+	}
+}//namespace reference
+
+namespace highp
+{
+	static int const Count = 1 << 16;
+
+	template<typename vecType>
+	static int test_unary(vecType (*Func)(vecType const&), double (*Expected)(double), bool Logarithmic, float Range)
+	{
+		int Error = 0;
+
+		for(int i = 0; i < Count; i += 4)
+		{
+			vecType x;
+			for(int c = 0; c < 4; ++c)
+				x[c] = Logarithmic ? reference::logarithmic(i + c, Count) : reference::linear(i + c, Count, -Range, Range);
+
+			vecType const y = Func(x);
+			for(int c = 0; c < 4; ++c)
+				Error += reference::ulps(y[c], Expected(static_cast<double>(x[c]))) <= 2 ? 0 : 1;
+		}
+
+		return Error;
+	}
+
+	template<typename vecType>
+	static int test_special()
+	{
+		int Error = 0;
+
+		float const Inf = std::numeric_limits<float>::infinity();
+		float const NaN = std::numeric_limits<float>::quiet_NaN();
+
+		vecType const Sin = glm::sin(vecType(0.0f, -0.0f, Inf, NaN));
+		Error += glm::equal(Sin.x, 0.0f, 0.0f) && 1.0f / Sin.x > 0.0f ? 0 : 1;
+		Error += glm::equal(Sin.y, 0.0f, 0.0f) && 1.0f / Sin.y < 0.0f ? 0 : 1;
+		Error += glm::isnan(Sin.z) && glm::isnan(Sin.w) ? 0 : 1;
+
+		vecType const Atan = glm::atan(vecType(Inf, -Inf, -0.0f, NaN));
+		Error += glm::equal(Atan.x, glm::half_pi<float>(), 0.0f) ? 0 : 1;
+		Error += glm::equal(Atan.y, -glm::half_pi<float>(), 0.0f) ? 0 : 1;
+		Error += glm::equal(Atan.z, 0.0f, 0.0f) && 1.0f / Atan.z < 0.0f ? 0 : 1;
+		Error += glm::isnan(Atan.w) ? 0 : 1;
+
+		return Error;
+	}
+
+	template<typename vecType>
+	static int test()
+	{
+		int Error = 0;
+
+		Error += test_unary<vecType>(glm::sin, std::sin, false, 10000.0f);
+		Error += test_unary<vecType>(glm::sin, std::sin, true, 0.0f);
+		Error += test_unary<vecType>(glm::cos, std::cos, false, 10000.0f);
+		Error += test_unary<vecType>(glm::cos, std::cos, true, 0.0f);
+		Error += test_unary<vecType>(glm::tan, std::tan, false, 10000.0f);
+		Error += test_unary<vecType>(glm::tan, std::tan, true, 0.0f);
+		Error += test_unary<vecType>(glm::atan, std::atan, true, 0.0f);
+		Error += test_special<vecType>();
+
+		return Error;
+	}
+}//namespace highp
+
+// The lowp SIMD functions trade accuracy for speed
+namespace lowp
+{
+	static int const Count = 1 << 16;
+
+	template<typename vecType>
+	static int test_unary(vecType (*Func)(vecType const&), double (*Expected)(double), bool Logarithmic, float Range, float Epsilon, bool Relative)
+	{
+		int Error = 0;
+
+		for(int i = 0; i < Count; i += 4)
+		{
+			vecType x;
+			for(int c = 0; c < 4; ++c)
+				x[c] = Logarithmic ? reference::logarithmic(i + c, Count) : reference::linear(i + c, Count, -Range, Range);
+
+			vecType const y = Func(x);
+			for(int c = 0; c < 4; ++c)
+			{
+				double const e = Expected(static_cast<double>(x[c]));
+				double const Scale = Relative ? std::abs(e) : 1.0;
+				Error += std::abs(static_cast<double>(y[c]) - e) <= Epsilon * Scale ? 0 : 1;
+			}
+		}
+
+		return Error;
+	}
+
+	static int test()
+	{
+		int Error = 0;
+
+#		if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+			Error += test_unary<glm::aligned_lowp_vec4>(glm::sin, std::sin, false, 1000.0f, 1e-4f, false);
+			Error += test_unary<glm::aligned_lowp_vec4>(glm::cos, std::cos, false, 1000.0f, 1e-4f, false);
+			Error += test_unary<glm::aligned_lowp_vec4>(glm::tan, std::tan, false, 1.5f, 1e-4f, true);
+			Error += test_unary<glm::aligned_lowp_vec4>(glm::atan, std::atan, true, 0.0f, 1e-4f, false);
+#		endif
+
+		return Error;
+	}
+}//namespace lowp
 
 int main()
 {
 	int Error = 0;
 
+	Error += highp::test<glm::vec4>();
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += highp::test<glm::aligned_highp_vec4>();
+#	endif
+	Error += lowp::test();
 
 	return Error;
 }
-
@@ -0,0 +1,212 @@
+#include <glm/simd/batch.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/ext/scalar_relational.hpp>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	// The vec3 kernels take packed floats, which glm::vec3 stops being under
+	// GLM_FORCE_DEFAULT_ALIGNED_GENTYPES. This is glm::packed_vec3, without
+	// <glm/gtc/type_aligned.hpp> and the aligned types it insists on.
+	typedef glm::vec<3, float, glm::packed_highp> packed_vec3;
+
+	// Fills with a repeatable mix of magnitudes and signs
+	std::vector<float> random(std::size_t count, unsigned int seed)
+	{
+		std::vector<float> Values(count);
+		for(std::size_t i = 0; i < count; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			Values[i] = static_cast<float>(static_cast<int>(seed >> 8) - (1 << 23)) / static_cast<float>(1 << (seed & 15));
+		}
+		return Values;
+	}
+
+	bool same(std::vector<float> const& a, std::vector<float> const& b)
+	{
+		return a.size() == b.size() && std::memcmp(&a[0], &b[0], a.size() * sizeof(float)) == 0;
+	}
+}//namespace
+
+// Every kernel against the scalar reference, for spans that do and do not
+// fill whole registers, starting off the first element so loads are unaligned
+namespace reference
+{
+	int test_isa(glm_batch_isa Isa)
+	{
+		int Error = 0;
+		bool const Fused = glm_batch_fused(Isa);
+		std::vector<float> const M = random(16, 1);
+
+		for(std::size_t Count = 0; Count <= 40; ++Count)
+		{
+			std::vector<float> const A = random(Count * 4 + 1, static_cast<unsigned int>(Count) + 2);
+			std::vector<float> const B = random(Count * 4 + 1, static_cast<unsigned int>(Count) + 100);
+			float const* a = &A[1];
+			float const* b = &B[1];
+			std::vector<float> Out(Count * 4 + 1), Ref(Count * 4 + 1);
+
+			glm_batch_mat4_mul_vec4(&M[0], a, &Out[0], Count);
+			if(Fused)
+				glm::detail::batch_scalar::mat4_mul_vec4<true>(&M[0], a, &Ref[0], Count);
+			else
+				glm::detail::batch_scalar::mat4_mul_vec4<false>(&M[0], a, &Ref[0], Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			glm_batch_vec3_dot(a, b, &Out[0], Count);
+			if(Fused)
+				glm::detail::batch_scalar::vec3_dot<true>(a, b, &Ref[0], Count);
+			else
+				glm::detail::batch_scalar::vec3_dot<false>(a, b, &Ref[0], Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			glm_batch_vec3_cross(a, b, &Out[0], Count);
+			if(Fused)
+				glm::detail::batch_scalar::vec3_cross<true>(a, b, &Ref[0], Count);
+			else
+				glm::detail::batch_scalar::vec3_cross<false>(a, b, &Ref[0], Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			glm_batch_vec3_normalize(a, &Out[0], Count);
+			if(Fused)
+				glm::detail::batch_scalar::vec3_normalize<true>(a, &Ref[0], Count);
+			else
+				glm::detail::batch_scalar::vec3_normalize<false>(a, &Ref[0], Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			// SoA views over the same data, a component per Count floats
+			float const* const SoaA[4] = {a, a + Count, a + Count * 2, a + Count * 3};
+			float const* const SoaB[4] = {b, b + Count, b + Count * 2, b + Count * 3};
+			float* const SoaOut[4] = {&Out[0], &Out[0] + Count, &Out[0] + Count * 2, &Out[0] + Count * 3};
+			float* const SoaRef[4] = {&Ref[0], &Ref[0] + Count, &Ref[0] + Count * 2, &Ref[0] + Count * 3};
+
+			glm_batch_mat4_mul_vec4_soa(&M[0], SoaA, SoaOut, Count);
+			if(Fused)
+				glm::detail::batch_scalar::mat4_mul_vec4_soa<true>(&M[0], SoaA, SoaRef, Count);
+			else
+				glm::detail::batch_scalar::mat4_mul_vec4_soa<false>(&M[0], SoaA, SoaRef, Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			glm_batch_vec3_dot_soa(SoaA, SoaB, &Out[0], Count);
+			if(Fused)
+				glm::detail::batch_scalar::vec3_dot_soa<true>(SoaA, SoaB, &Ref[0], Count);
+			else
+				glm::detail::batch_scalar::vec3_dot_soa<false>(SoaA, SoaB, &Ref[0], Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			glm_batch_vec3_cross_soa(SoaA, SoaB, SoaOut, Count);
+			if(Fused)
+				glm::detail::batch_scalar::vec3_cross_soa<true>(SoaA, SoaB, SoaRef, Count);
+			else
+				glm::detail::batch_scalar::vec3_cross_soa<false>(SoaA, SoaB, SoaRef, Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			glm_batch_vec3_normalize_soa(SoaA, SoaOut, Count);
+			if(Fused)
+				glm::detail::batch_scalar::vec3_normalize_soa<true>(SoaA, SoaRef, Count);
+			else
+				glm::detail::batch_scalar::vec3_normalize_soa<false>(SoaA, SoaRef, Count);
+			Error += same(Out, Ref) ? 0 : 1;
+
+			// In place
+			std::vector<float> InPlace(A.begin(), A.end());
+			glm_batch_mat4_mul_vec4(&M[0], &InPlace[1], &InPlace[1], Count);
+			glm_batch_mat4_mul_vec4(&M[0], a, &Out[1], Count);
+			Error += std::memcmp(&InPlace[1], &Out[1], Count * 4 * sizeof(float)) == 0 ? 0 : 1;
+		}
+
+		return Error;
+	}
+
+	int test()
+	{
+		int Error = 0;
+
+		glm_batch_isa const Best = glm_batch_detect_isa();
+		for(int Isa = GLM_BATCH_SCALAR; Isa <= Best; ++Isa)
+		{
+			Error += glm_batch_set_isa(static_cast<glm_batch_isa>(Isa)) == Isa ? 0 : 1;
+			int const IsaError = test_isa(static_cast<glm_batch_isa>(Isa));
+			if(IsaError)
+				std::printf("%s kernels differ from the reference: %d\n", glm_batch_isa_name(static_cast<glm_batch_isa>(Isa)), IsaError);
+			Error += IsaError;
+		}
+		glm_batch_set_isa(Best);
+
+		return Error;
+	}
+}//namespace reference
+
+// The batches agree with glm's own operators, give or take rounding
+namespace operators
+{
+	int test()
+	{
+		int Error = 0;
+
+		glm::mat4 const A(
+			glm::vec4(0.8f, 0.1f, -0.3f, 0.0f), glm::vec4(-0.2f, 0.9f, 0.4f, 0.0f),
+			glm::vec4(0.5f, -0.6f, 0.7f, 0.0f), glm::vec4(1.0f, 2.0f, 3.0f, 1.0f));
+		std::vector<glm::mat4> B(11);
+		std::vector<glm::vec4> V(13);
+		std::vector<packed_vec3> P(13), Q(13);
+		for(std::size_t i = 0; i < B.size(); ++i)
+			B[i] = glm::mat4(static_cast<float>(i) * 0.25f + 1.0f) + glm::mat4(glm::vec4(0.1f), glm::vec4(-0.2f), glm::vec4(0.3f), glm::vec4(1.0f));
+		for(std::size_t i = 0; i < V.size(); ++i)
+		{
+			float const f = static_cast<float>(i);
+			V[i] = glm::vec4(f, 1.0f - f, 0.5f * f, 1.0f);
+			P[i] = packed_vec3(f + 1.0f, -2.0f, 0.25f * f);
+			Q[i] = packed_vec3(0.5f, f - 3.0f, 2.0f);
+		}
+
+		std::vector<glm::mat4> Products(B.size());
+		glm_batch_mat4_mul(glm::value_ptr(A), glm::value_ptr(B[0]), glm::value_ptr(Products[0]), B.size());
+		for(std::size_t i = 0; i < B.size(); ++i)
+		{
+			glm::mat4 const Expected = A * B[i];
+			for(int c = 0; c < 4; ++c)
+			for(int r = 0; r < 4; ++r)
+				Error += glm::equal(Products[i][c][r], Expected[c][r], 1e-5f) ? 0 : 1;
+		}
+
+		std::vector<glm::vec4> Transformed(V.size());
+		glm_batch_mat4_mul_vec4(glm::value_ptr(A), glm::value_ptr(V[0]), glm::value_ptr(Transformed[0]), V.size());
+		std::vector<float> Dots(P.size());
+		glm_batch_vec3_dot(glm::value_ptr(P[0]), glm::value_ptr(Q[0]), &Dots[0], P.size());
+		std::vector<packed_vec3> Crosses(P.size()), Normals(P.size());
+		glm_batch_vec3_cross(glm::value_ptr(P[0]), glm::value_ptr(Q[0]), glm::value_ptr(Crosses[0]), P.size());
+		glm_batch_vec3_normalize(glm::value_ptr(P[0]), glm::value_ptr(Normals[0]), P.size());
+		for(std::size_t i = 0; i < V.size(); ++i)
+		{
+			glm::vec4 const ExpectedV = A * V[i];
+			packed_vec3 const ExpectedC = glm::cross(P[i], Q[i]);
+			packed_vec3 const ExpectedN = glm::normalize(P[i]);
+			for(int c = 0; c < 4; ++c)
+				Error += glm::equal(Transformed[i][c], ExpectedV[c], 1e-5f) ? 0 : 1;
+			for(int c = 0; c < 3; ++c)
+			{
+				Error += glm::equal(Crosses[i][c], ExpectedC[c], 1e-5f) ? 0 : 1;
+				Error += glm::equal(Normals[i][c], ExpectedN[c], 1e-6f) ? 0 : 1;
+			}
+			Error += glm::equal(Dots[i], glm::dot(P[i], Q[i]), 1e-5f) ? 0 : 1;
+		}
+
+		return Error;
+	}
+}//namespace operators
+
+int main()
+{
+	int Error = 0;
+
+	std::printf("Batch kernels: %s\n", glm_batch_isa_name(glm_batch_get_isa()));
+
+	Error += reference::test();
+	Error += operators::test();
+
+	return Error;
+}
@@ -601,6 +601,8 @@ static int test_constexpr()
 	static_assert(glm::vec3(1.0f).x > 0.0f, "GLM: Failed constexpr");
 	static_assert(glm::vec3(1.0f, -1.0f, -1.0f).x > 0.0f, "GLM: Failed constexpr");
 	static_assert(glm::vec3(1.0f, -1.0f, -1.0f).y < 0.0f, "GLM: Failed constexpr");
+	static_assert((glm::vec3(1.0f) + glm::vec3(1.0f, -1.0f, -1.0f)).x > 1.0f, "GLM: Failed constexpr");
+	static_assert((glm::vec3(2.0f) * 2.0f).z > 3.0f, "GLM: Failed constexpr");
 #endif
 
 	return 0;
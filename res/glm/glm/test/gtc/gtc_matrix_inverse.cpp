@@ -1,5 +1,12 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/epsilon.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+#	include <glm/gtc/type_aligned.hpp>
+#endif
 
 int test_affine()
 {
@@ -41,11 +48,28 @@ int test_affine()
 	return Error;
 }
 
+int test_affine_aligned()
+{
+	int Error = 0;
+
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		glm::mat4 const M = glm::scale(glm::rotate(glm::translate(glm::mat4(1), glm::vec3(1, -2, 3)), 0.7f, glm::vec3(0.0f, 0.6f, 0.8f)), glm::vec3(2, 3, 0.5f));
+		glm::mat4 const A(glm::affineInverse(glm::aligned_mat4(M)));
+		glm::mat4 const I = glm::affineInverse(M);
+
+		for(glm::length_t i = 0; i < A.length(); ++i)
+			Error += glm::all(glm::epsilonEqual(A[i], I[i], 0.0001f)) ? 0 : 1;
+#	endif
+
+	return Error;
+}
+
 int main()
 {
 	int Error = 0;
 
 	Error += test_affine();
+	Error += test_affine_aligned();
 
 	return Error;
 }
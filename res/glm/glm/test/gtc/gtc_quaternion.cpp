@@ -1,3 +1,6 @@
+#ifndef GLM_FORCE_INTRINSICS
+#	define GLM_FORCE_INTRINSICS
+#endif
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -231,6 +234,61 @@ static int test_mul()
 	return Error;
 }
 
+// Aligned quaternions take the SIMD paths when there are some, they must match packed quaternions
+template<typename T, glm::qualifier Q>
+static int test_mul_aligned()
+{
+	int Error = 0;
+
+	glm::qua<T, glm::defaultp> const A = glm::normalize(glm::qua<T, glm::defaultp>(T(1), T(0.5), T(-2), T(0.25)));
+	glm::qua<T, glm::defaultp> const B = glm::normalize(glm::qua<T, glm::defaultp>(T(-1), T(0.75), T(3), T(2)));
+
+	glm::qua<T, Q> const a(A);
+	glm::qua<T, Q> const b(B);
+
+	Error += glm::all(glm::equal(glm::qua<T, glm::defaultp>(a * b), A * B, glm::epsilon<T>())) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::qua<T, glm::defaultp>(b * a), B * A, glm::epsilon<T>())) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::qua<T, glm::defaultp>(a * T(2)), A * T(2), glm::epsilon<T>())) ? 0 : 1;
+	Error += glm::all(glm::equal(glm::qua<T, glm::defaultp>(a / T(2)), A / T(2), glm::epsilon<T>())) ? 0 : 1;
+
+	glm::qua<T, Q> c(a);
+	c *= b;
+	c *= glm::inverse(b);
+	Error += glm::all(glm::equal(glm::qua<T, glm::defaultp>(c), A, T(0.0001))) ? 0 : 1;
+
+	return Error;
+}
+
+// Without contraction the AVX double multiply adds the same terms in the same order as the generic code
+#if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE && (GLM_ARCH & GLM_ARCH_AVX_BIT) && !defined(__FMA__)
+static int test_mul_aligned_exact()
+{
+	int Error = 0;
+
+	unsigned int Seed = 1;
+	for(int i = 0; i < 1000; ++i)
+	{
+		double Values[8];
+		for(int j = 0; j < 8; ++j)
+		{
+			Seed = Seed * 1664525u + 1013904223u;
+			Values[j] = (static_cast<double>(Seed) / 4294967295.0 - 0.5) * 200.0;
+		}
+
+		glm::dquat const A(Values[0], Values[1], Values[2], Values[3]);
+		glm::dquat const B(Values[4], Values[5], Values[6], Values[7]);
+		glm::qua<double, glm::aligned_highp> const a(A);
+		glm::qua<double, glm::aligned_highp> const b(B);
+
+		glm::dquat const Packed = A * B;
+		glm::dquat const Aligned(a * b);
+		Error += Packed.x == Aligned.x && Packed.y == Aligned.y && Packed.z == Aligned.z && Packed.w == Aligned.w ? 0 : 1;
+	}
+
+	return Error;
+}
+#endif
+
 int test_identity()
 {
 	int Error = 0;
@@ -253,6 +311,14 @@ int main()
 	int Error = 0;
 
 	Error += test_mul();
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE
+		Error += test_mul_aligned<float, glm::aligned_highp>();
+		Error += test_mul_aligned<double, glm::aligned_highp>();
+		Error += test_mul_aligned<double, glm::aligned_lowp>();
+#	endif
+#	if GLM_CONFIG_ALIGNED_GENTYPES == GLM_ENABLE && (GLM_ARCH & GLM_ARCH_AVX_BIT) && !defined(__FMA__)
+		Error += test_mul_aligned_exact();
+#	endif
 	Error += test_quat_mul_vec();
 	Error += test_quat_angle();
 	Error += test_quat_angleAxis();
@@ -105,11 +105,12 @@ static int comp_mat4_div_mat4(std::size_t Samples)
 	std::vector<alignedMatType> SIMD;
 	std::printf("- SIMD: %d us\n", launch_mat_div_mat<alignedMatType>(SIMD, Transform, Scale, Samples));
 
+	// Quotients shrink with i and SIMD inverts in a different order
 	for(std::size_t i = 0; i < Samples; ++i)
 	{
 		packedMatType const A = SISD[i];
 		packedMatType const B = SIMD[i];
-		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001))) ? 0 : 1;
+		Error += glm::all(glm::equal(A, B, static_cast<T>(0.01) / static_cast<T>(i + 1))) ? 0 : 1;
 		assert(!Error);
 	}
 	
@@ -4,6 +4,7 @@
 #include <glm/ext/matrix_double4x4.hpp>
 #include <glm/ext/matrix_relational.hpp>
 #include <glm/ext/vector_float4.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
 #if GLM_CONFIG_SIMD == GLM_ENABLE
 #include <glm/gtc/type_aligned.hpp>
 #include <vector>
@@ -113,6 +114,61 @@ static int comp_mat4_inverse(std::size_t Samples)
 	return Error;
 }
 
+template <typename matType>
+static void test_mat_affineInverse(std::vector<matType> const& I, std::vector<matType>& O)
+{
+	for (std::size_t i = 0, n = I.size(); i < n; ++i)
+		O[i] = glm::affineInverse(I[i]);
+}
+
+template <typename matType>
+static int launch_mat_affineInverse(std::vector<matType>& O, matType const& Transform, std::size_t Samples)
+{
+	typedef typename matType::value_type T;
+
+	std::vector<matType> I(Samples);
+	O.resize(Samples);
+
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		I[i] = Transform * static_cast<T>(i + 1);
+		I[i][0][3] = I[i][1][3] = I[i][2][3] = static_cast<T>(0);
+		I[i][3][3] = static_cast<T>(1);
+	}
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	test_mat_affineInverse<matType>(I, O);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+template <typename packedMatType, typename alignedMatType>
+static int comp_mat4_affineInverse(std::size_t Samples)
+{
+	typedef typename packedMatType::value_type T;
+
+	int Error = 0;
+
+	packedMatType const Transform(0.8, 0.6, 0, 0, -0.6, 0.8, 0, 0, 0, 0, 2, 0, 0.01, 0.02, 0.03, 1);
+
+	std::vector<packedMatType> SISD;
+	std::printf("- SISD: %d us\n", launch_mat_affineInverse<packedMatType>(SISD, Transform, Samples));
+
+	std::vector<alignedMatType> SIMD;
+	std::printf("- SIMD: %d us\n", launch_mat_affineInverse<alignedMatType>(SIMD, Transform, Samples));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		packedMatType const A = SISD[i];
+		packedMatType const B = SIMD[i];
+		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001))) ? 0 : 1;
+		assert(!Error);
+	}
+
+	return Error;
+}
+
 int main()
 {
 	std::size_t const Samples = 100000;
@@ -137,6 +193,12 @@ int main()
 	std::printf("glm::inverse(dmat4):\n");
 	Error += comp_mat4_inverse<glm::dmat4, glm::aligned_dmat4>(Samples);
 
+	std::printf("glm::affineInverse(mat4):\n");
+	Error += comp_mat4_affineInverse<glm::mat4, glm::aligned_mat4>(Samples);
+
+	std::printf("glm::affineInverse(dmat4):\n");
+	Error += comp_mat4_affineInverse<glm::dmat4, glm::aligned_dmat4>(Samples);
+
 	return Error;
 }
 
@@ -107,16 +107,70 @@ static int comp_mat4_mul_mat4(std::size_t Samples)
 	std::vector<alignedMatType> SIMD;
 	std::printf("- SIMD: %d us\n", launch_mat_mul_mat<alignedMatType>(SIMD, Transform, Scale, Samples));
 
+	// Products grow with i and SIMD sums them in a different order
 	for(std::size_t i = 0; i < Samples; ++i)
 	{
 		packedMatType const A = SISD[i];
 		packedMatType const B = SIMD[i];
-		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001))) ? 0 : 1;
+		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001) * static_cast<T>(i + 1))) ? 0 : 1;
 	}
 	
 	return Error;
 }
 
+template <typename matType>
+static void test_mat_mul_mat_mul_mat(matType const& P, matType const& V, std::vector<matType> const& I, std::vector<matType>& O)
+{
+	for (std::size_t i = 0, n = I.size(); i < n; ++i)
+		O[i] = P * V * I[i];
+}
+
+template <typename matType>
+static int launch_mat_mul_mat_mul_mat(std::vector<matType>& O, matType const& Projection, matType const& View, matType const& Scale, std::size_t Samples)
+{
+	typedef typename matType::value_type T;
+
+	std::vector<matType> I(Samples);
+	O.resize(Samples);
+
+	for(std::size_t i = 0; i < Samples; ++i)
+		I[i] = Scale * static_cast<T>(i);
+
+	std::chrono::high_resolution_clock::time_point t1 = std::chrono::high_resolution_clock::now();
+	test_mat_mul_mat_mul_mat<matType>(Projection, View, I, O);
+	std::chrono::high_resolution_clock::time_point t2 = std::chrono::high_resolution_clock::now();
+
+	return static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+// Projection * View * Model, as computed for each instance
+template <typename packedMatType, typename alignedMatType>
+static int comp_mat4_mul_mat4_mul_mat4(std::size_t Samples)
+{
+	typedef typename packedMatType::value_type T;
+
+	int Error = 0;
+
+	packedMatType const Projection(1, 0, 0, 0, 0, 2, 0, 0, 0, 0, -1, -1, 0, 0, -0.2, 0);
+	packedMatType const View(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16);
+	packedMatType const Scale(0.01, 0.02, 0.03, 0.05, 0.01, 0.02, 0.03, 0.05, 0.01, 0.02, 0.03, 0.05, 0.01, 0.02, 0.03, 0.05);
+
+	std::vector<packedMatType> SISD;
+	std::printf("- SISD: %d us\n", launch_mat_mul_mat_mul_mat<packedMatType>(SISD, Projection, View, Scale, Samples));
+
+	std::vector<alignedMatType> SIMD;
+	std::printf("- SIMD: %d us\n", launch_mat_mul_mat_mul_mat<alignedMatType>(SIMD, Projection, View, Scale, Samples));
+
+	for(std::size_t i = 0; i < Samples; ++i)
+	{
+		packedMatType const A = SISD[i];
+		packedMatType const B = SIMD[i];
+		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001) * static_cast<T>(i + 1))) ? 0 : 1;
+	}
+
+	return Error;
+}
+
 int main()
 {
 	std::size_t const Samples = 100000;
@@ -141,6 +195,12 @@ int main()
 	std::printf("dmat4 * dmat4:\n");
 	Error += comp_mat4_mul_mat4<glm::dmat4, glm::aligned_dmat4>(Samples);
 
+	std::printf("mat4 * mat4 * mat4:\n");
+	Error += comp_mat4_mul_mat4_mul_mat4<glm::mat4, glm::aligned_mat4>(Samples);
+
+	std::printf("dmat4 * dmat4 * dmat4:\n");
+	Error += comp_mat4_mul_mat4_mul_mat4<glm::dmat4, glm::aligned_dmat4>(Samples);
+
 	return Error;
 }
 
@@ -107,11 +107,12 @@ static int comp_mat4_mul_vec4(std::size_t Samples)
 	std::vector<alignedVecType> SIMD;
 	std::printf("- SIMD: %d us\n", launch_mat_mul_vec<alignedMatType, alignedVecType>(SIMD, Transform, Scale, Samples));
 
+	// Products grow with i and SIMD sums them in a different order
 	for(std::size_t i = 0; i < Samples; ++i)
 	{
 		packedVecType const A = SISD[i];
 		packedVecType const B = SIMD[i];
-		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001))) ? 0 : 1;
+		Error += glm::all(glm::equal(A, B, static_cast<T>(0.001) * static_cast<T>(i + 1))) ? 0 : 1;
 	}
 	
 	return Error;
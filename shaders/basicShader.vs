@@ -1,15 +1,45 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoords;
+layout (location = 6) in vec4 aNormal;
 
 out vec2 texCoords;
+out vec3 normal;
+
+// Quantized positions are stored relative to the mesh bounds
+uniform vec3 positionScale = vec3(1.0);
+uniform vec3 positionOffset = vec3(0.0);
+
+// How aNormal is packed, a NormalFormat from vertex_format.h: 0 float, 1
+// octahedral, 2 10_10_10_2. -1 when the mesh has no normals.
+uniform int normalFormat = -1;
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+
+layout (std140) uniform Camera
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 cameraPosition;
+};
+
+// Mirrors QuantizedVertices::normal; the normalized attribute has already
+// mapped snorm to [-1, 1]. Renormalized after interpolation.
+vec3 decodeNormal(vec4 encoded)
+{
+    if (normalFormat != 1)
+        return encoded.xyz;
+    vec3 n = vec3(encoded.xy, 1.0 - abs(encoded.x) - abs(encoded.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return n;
+}
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos.x, aPos.y, aPos.z, 1.0);
+    gl_Position = viewProjection * model * vec4(aPos * positionScale + positionOffset, 1.0);
     texCoords = aTexCoords;
+    // Models only rotate and scale uniformly, so no inverse transpose
+    normal = mat3(model) * decodeNormal(aNormal);
 }
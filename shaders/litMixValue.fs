@@ -0,0 +1,22 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 texCoords;
+in vec3 normal;
+
+uniform sampler2D texture1;
+uniform sampler2D texture2;
+
+uniform float mixValue;
+uniform int normalFormat = -1;
+
+// mixValue.fs, with a fixed directional light on meshes that have normals
+const vec3 lightDirection = normalize(vec3(0.3, 1.0, 0.5));
+
+void main()
+{
+    vec4 color = mix(texture(texture1, texCoords), texture(texture2, vec2(1.0f- texCoords.s*2.0f, texCoords.t*2.0f)), mixValue);
+    if (normalFormat >= 0)
+        color.rgb *= 0.35 + 0.65 * max(dot(normalize(normal), lightDirection), 0.0);
+    FragColor = color;
+}